@@ -63,10 +63,12 @@ class OmArchive
     /// \param[in]  path    : Path to file to open.
     /// \param[in]  method  : Compression algorithm to use
     /// \param[in]  level   : Compression level
+    /// \param[in]  adaptive: Store entries whose data is already compressed
+    ///                       or incompressible instead of compressing them
     ///
     /// \return True if operation succeed, false otherwise.
     ///
-    bool write(const OmWString& path, int32_t method = OM_METHOD_DEFLATE, int32_t level = OM_LEVEL_SLOW);
+    bool write(const OmWString& path, int32_t method = OM_METHOD_DEFLATE, int32_t level = OM_LEVEL_SLOW, bool adaptive = false);
 
     /// \brief Compress and add file to zip
     ///
@@ -91,15 +93,87 @@ class OmArchive
     ///
     bool entryAdd(const void* data, uint64_t size, const OmWString& dst, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr) const;
 
+    /// \brief Compress and add many files to zip
+    ///
+    /// Compress the specified files in parallel on a pool of workers, then
+    /// add them to zip in the given order. Compressed data is kept in
+    /// memory, or spilled to temporary file next to zip for large files,
+    /// until it is written, and workers never run too far ahead of writing.
+    ///
+    /// The progression callback is called from the calling thread with the
+    /// count of added entries, if it returns false, the operation is aborted
+    /// and function returns false.
+    ///
+    /// \param[in] srcs     : Paths to files or directories to add
+    /// \param[in] dsts     : File names/paths in zip, one for each source
+    /// \param[in] threads  : Count of workers, zero to use processor count
+    ///
+    /// \return True if operation succeed, false otherwise
+    ///
+    bool entryAddMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads = 0, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr) const;
+
+    /// \brief Copy entry from another zip without recompression
+    ///
+    /// Copy the specified entry of the given zip opened for reading as-is,
+    /// compressed data and CRC are transferred without being decompressed
+    /// then recompressed. Entry keeps its original compression method.
+    ///
+    /// \param[in] src     : Source zip opened for reading
+    /// \param[in] i       : Source entry index
+    /// \param[in] dst     : File name/path in zip
+    ///
+    /// \return True if operation succeed, false otherwise
+    ///
+    bool entryCopyRaw(const OmArchive& src, size_t i, const OmWString& dst, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr) const;
+
+    /// \brief Recompress entry from another zip
+    ///
+    /// Copy the specified entry of the given zip opened for reading,
+    /// decompressing then recompressing data with the current compression
+    /// method and level. Data is streamed by chunks through a fixed-size
+    /// buffer so memory usage does not depend on entry size.
+    ///
+    /// \param[in] src     : Source zip opened for reading
+    /// \param[in] i       : Source entry index
+    /// \param[in] dst     : File name/path in zip
+    ///
+    /// \return True if operation succeed, false otherwise
+    ///
+    bool entryCopy(const OmArchive& src, size_t i, const OmWString& dst, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr) const;
+
     /// \brief Open a zip file for reading.
     ///
     /// Initializes an existing zip file for reading operation.
     ///
-    /// \param[in]  path  : Path to file to open.
+    /// If mapped mode is requested, the file is read through a read-only
+    /// memory mapped view, stored entries are then extracted directly from
+    /// the view. If file cannot be mapped, the standard file stream is used.
+    ///
+    /// \param[in]  path    : Path to file to open.
+    /// \param[in]  mapped  : Read file through memory mapped view.
     ///
     /// \return True if operation succeed, false otherwise.
     ///
-    bool read(const OmWString& path);
+    bool read(const OmWString& path, bool mapped = false);
+
+    /// \brief Probe zip file for an entry.
+    ///
+    /// Opens the specified zip file, walks its central directory without
+    /// mirroring it, and extracts the data of the last entry whose file
+    /// extension or path matches the given ones, then closes the zip. This
+    /// is intended to quickly get a definition file from large archives.
+    ///
+    /// Matching is case-insensitive for ASCII characters only.
+    ///
+    /// \param[in]  path    : Path to file to probe.
+    /// \param[in]  ext     : File extension to search, or null.
+    /// \param[in]  name    : Entry path to search, or null.
+    /// \param[out] data    : Pointer to string that receive entry data.
+    /// \param[out] entry   : Optional pointer to string that receive entry path.
+    ///
+    /// \return True if entry was found and extracted, false otherwise.
+    ///
+    bool probe(const OmWString& path, const wchar_t* ext, const wchar_t* name, OmCString* data, OmWString* entry = nullptr);
 
     /// \brief Get entries count.
     ///
@@ -142,6 +216,17 @@ class OmArchive
     ///
     uint64_t entrySize(size_t i) const;
 
+    /// \brief Get entry CRC-32
+    ///
+    /// Returns the CRC-32 of the specified entry file uncompressed data as
+    /// stored in central directory
+    ///
+    /// \param[in] i       : Entry index
+    ///
+    /// \return Entry file CRC-32
+    ///
+    uint32_t entryCrc(size_t i) const;
+
     /// \brief Check whether entry is a directory
     ///
     /// Checks whether the entry at specified index is a directory
@@ -184,6 +269,28 @@ class OmArchive
     ///
     bool entrySave(const OmWString& entry, const OmWString& dest, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr) const;
 
+    /// \brief Extract and save many entries as files
+    ///
+    /// Extract and save the specified entries as files using parallel
+    /// workers, each with its own reader on zip file. Entries are processed
+    /// in order of their position in zip file.
+    ///
+    /// The progression callback is called from the calling thread with the
+    /// count of extracted entries, if it returns false, the extraction is
+    /// aborted and function returns false.
+    ///
+    /// \param[in] indices  : Entries indices to extract
+    /// \param[in] dests    : Destination file paths, one for each index
+    /// \param[in] threads  : Count of workers, zero to use processor count
+    /// \param[in] progress_cb : Optional progression callback
+    /// \param[in] user_ptr : Custom pointer passed to progression callback
+    /// \param[out] saved   : Optional array to receive, for each index, 1 if
+    ///                       entry was saved, 0 otherwise
+    ///
+    /// \return True if operation succeed, false otherwise
+    ///
+    bool entrySaveMany(const OmIndexArray& indices, const OmWStringArray& dests, uint32_t threads = 0, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr, uint8_t* saved = nullptr) const;
+
     /// \brief Extract and save in memory
     ///
     /// Extract and save specified entry in memory buffer. The buffer
@@ -198,7 +305,8 @@ class OmArchive
 
     /// \brief Locate entry index
     ///
-    /// Search for the specified entry in zip Central Directory.
+    /// Search for the specified entry in zip Central Directory. Search is
+    /// case-insensitive and use an hash index built when zip is opened.
     ///
     /// \param[in] filename : Filename or path to search in Central Directory
     ///
@@ -213,6 +321,17 @@ class OmArchive
     ///
     bool close();
 
+    /// \brief Get adaptive compression statistics.
+    ///
+    /// Returns count and total uncompressed size of entries stored without
+    /// compression by the adaptive policy since the zip was initialized for
+    /// writing operation.
+    ///
+    /// \param[out] count   : Optional pointer to receive count of entries.
+    /// \param[out] size    : Optional pointer to receive size of entries.
+    ///
+    void adaptStats(uint64_t* count, uint64_t* size) const;
+
     /// \brief Get zip last error string.
     ///
     /// Returns error string corresponding to the last encountered error.
@@ -229,6 +348,12 @@ class OmArchive
 
     uint64_t            _zent_size;   //< zip central-directory entry count
 
+    void*               _zstr;        //< zip central-directory path string pool
+
+    void*               _zidx;        //< zip central-directory hash index
+
+    size_t              _zidx_mask;   //< zip central-directory hash index mask
+
     uint32_t            _stat;        //< file status
 };
 
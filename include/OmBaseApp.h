@@ -50,9 +50,11 @@
 #define OM_XML_DEF_EXT            L"omx"
 #define OM_PKG_FILE_EXT           L"ozp"
 #define OM_BCK_FILE_EXT           L"ozb"
+#define OM_JNL_FILE_EXT           L"ozj"
 
 #define OM_MODHUB_FILENAME        L"hub.omx"
 #define OM_MODCHN_FILENAME        L"channel.omx"
+#define OM_MODCHN_LIBCACHE_FILE   L"library.cache"
 
 #define OM_MODHUB_MODPSET_DIR     L".Presets"
 
@@ -0,0 +1,206 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMJOURNAL_H
+#define OMJOURNAL_H
+
+#include "OmBase.h"
+
+/// \brief Journal record types
+///
+/// Types of records written to Mod operation journal
+///
+enum OmJnlRecType : int32_t {
+  OM_JNL_BACKUP     = 'B',  ///< Backup path
+  OM_JNL_FORMER     = 'F',  ///< Former Backup path, kept when reverted
+  OM_JNL_ROOT       = 'R',  ///< Backup data root directory
+  OM_JNL_TARGET     = 'T',  ///< Target path
+  OM_JNL_MOVED      = 'M',  ///< Target file moved to Backup
+  OM_JNL_SAVED      = 'S',  ///< Target file saved to Backup archive
+  OM_JNL_DIRECTORY  = 'D',  ///< Directory created in Target
+  OM_JNL_WRITTEN    = 'W',  ///< File written to Target
+  OM_JNL_APPLY      = 'A',  ///< Backup completed, install started
+  OM_JNL_COMMIT     = 'C'   ///< Install completed
+};
+
+/// \brief Journal record structure
+///
+/// Structure to describe a single journal record
+///
+typedef struct OmJnlRec_
+{
+  int32_t       type;   ///< Record type
+  OmWString     data;   ///< Record data, mostly a path
+
+} OmJnlRec_t;
+
+/// \brief Mod operation journal
+///
+/// Append-only journal of per-file operations performed while installing a
+/// Mod, used to recover Target and Backup state after an interrupted
+/// operation. Appended records are buffered and written to disk by batch,
+/// records are only durable once synchronized.
+///
+class OmJournal
+{
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Default constructor.
+    ///
+    OmJournal();
+
+    /// \brief Destructor.
+    ///
+    /// Default destructor.
+    ///
+    ~OmJournal();
+
+    /// \brief Create journal
+    ///
+    /// Create a new empty journal file for writing, replacing any existing
+    /// one with the same path.
+    ///
+    /// \param[in] path   : Path to journal file to create.
+    ///
+    /// \return Zero if operation succeed, error code otherwise.
+    ///
+    int32_t create(const OmWString& path);
+
+    /// \brief Load journal
+    ///
+    /// Load records of an existing journal file. Incomplete record possibly
+    /// left at end of file by an interrupted write is ignored.
+    ///
+    /// \param[in] path   : Path to journal file to load.
+    ///
+    /// \return Zero if operation succeed, error code otherwise.
+    ///
+    int32_t load(const OmWString& path);
+
+    /// \brief Append record
+    ///
+    /// Append a new record to journal. Records are buffered and written to
+    /// disk once the buffer reaches the batch size or when sync is called.
+    ///
+    /// \param[in] type   : Record type.
+    /// \param[in] data   : Record data.
+    ///
+    void append(OmJnlRecType type, const OmWString& data = OmWString());
+
+    /// \brief Synchronize journal
+    ///
+    /// Write buffered records to journal file and flush it to disk.
+    ///
+    /// \return Zero if operation succeed, error code otherwise.
+    ///
+    int32_t sync();
+
+    /// \brief Close journal
+    ///
+    /// Write buffered records and close journal file, optionally deleting it.
+    ///
+    /// \param[in] remove : Delete journal file once closed.
+    ///
+    void close(bool remove = false);
+
+    /// \brief Check whether is open
+    ///
+    /// Returns whether journal file is currently open for writing.
+    ///
+    /// \return True if journal is open, false otherwise
+    ///
+    bool isOpen() const {
+      return (this->_hfile != nullptr);
+    }
+
+    /// \brief Journal path
+    ///
+    /// Returns path to current journal file.
+    ///
+    /// \return Journal file path.
+    ///
+    const OmWString& path() const {
+      return this->_path;
+    }
+
+    /// \brief Record count
+    ///
+    /// Returns count of records loaded from journal file.
+    ///
+    /// \return Loaded record count.
+    ///
+    size_t recordCount() const {
+      return this->_record.size();
+    }
+
+    /// \brief Get record
+    ///
+    /// Returns loaded record at specified index.
+    ///
+    /// \param[in] i      : Index of record to get.
+    ///
+    /// \return Journal record.
+    ///
+    const OmJnlRec_t& getRecord(size_t i) const {
+      return this->_record[i];
+    }
+
+    /// \brief Check whether has record
+    ///
+    /// Check whether loaded records contain at least one of the specified type.
+    ///
+    /// \param[in] type   : Record type to search.
+    ///
+    /// \return True if record was found, false otherwise.
+    ///
+    bool hasRecord(OmJnlRecType type) const;
+
+    /// \brief Find record data
+    ///
+    /// Returns data of the first loaded record of the specified type.
+    ///
+    /// \param[in] type   : Record type to search.
+    ///
+    /// \return Record data or empty string if not found.
+    ///
+    OmWString findRecord(OmJnlRecType type) const;
+
+    /// \brief Find all records data
+    ///
+    /// Appends data of all loaded records of the specified type to the given
+    /// array, in journal order.
+    ///
+    /// \param[in]  type   : Record type to search.
+    /// \param[out] data   : Array to append records data to.
+    ///
+    void findRecords(OmJnlRecType type, OmWStringArray* data) const;
+
+  private: ///          - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+    OmWString             _path;
+
+    void*                 _hfile;
+
+    OmCString             _buffer;
+
+    size_t                _buffered;
+
+    std::vector<OmJnlRec_t> _record;
+};
+
+#endif // OMJOURNAL_H
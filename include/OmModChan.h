@@ -17,6 +17,9 @@
 #ifndef OMMODCHAN_H
 #define OMMODCHAN_H
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "OmBase.h"
 
 #include "OmUtilFs.h"           //< OM_ACCESS_*
@@ -31,6 +34,25 @@
 
 class OmModHub;
 
+/// \brief Mod operations plan
+///
+/// Structure to describe the I/O work the installation of a set of Mods
+/// involves, as estimated by Mod Channel planner without performing any
+/// actual operation.
+///
+typedef struct OmModPlan_
+{
+  OmWStringArray  backup_files;   ///< Target files to be saved to Backup
+  uint64_t        backup_bytes;   ///< Total size of Target files to be saved
+  uint64_t        comp_bytes;     ///< Total size of data to be compressed to Backup
+  OmWStringArray  create_dirs;    ///< Target directories to be created
+  size_t          write_files;    ///< Count of files to be written to Target
+  uint64_t        write_bytes;    ///< Total size of data to be written to Target
+  uint64_t        io_bytes;       ///< Total size of data actually copied during operations
+  double          estimate;       ///< Estimated duration in seconds, negative if unknown
+
+} OmModPlan_t;
+
 /// \brief Mod Channel object for Mod Hub.
 ///
 /// The Mod Channel object defines environment for package installation
@@ -323,6 +345,31 @@ class OmModChan
     /// \return True if matching entry was found, false otherwise.
     ///
     bool backupEntryExists(const OmWString& path, int32_t attr) const;
+
+    /// \brief Update Mod footprint index
+    ///
+    /// Updates the channel-wide index of Target paths owned by installed Mods
+    /// for the specified Mod, according its current Backup status. This must
+    /// be called once a Mod Backup was made or restored outside Mod operations
+    /// queue.
+    ///
+    /// \param[in] ModPack  : Mod whose Backup status changed.
+    ///
+    void indexFootprint(const OmModPack* ModPack);
+
+    /// \brief Check whether Target file matches
+    ///
+    /// Check whether the specified Target file has the given size and CRC32,
+    /// meaning it already holds the same content. Computed CRC32 values are
+    /// cached and reused as long as file size and modification time are unchanged.
+    ///
+    /// \param[in] path   : Target file path.
+    /// \param[in] size   : Expected file size.
+    /// \param[in] crc    : Expected file CRC32.
+    ///
+    /// \return True if Target file matches, false otherwise or if file cannot be read.
+    ///
+    bool targetFileMatches(const OmWString& path, uint64_t size, uint32_t crc);
 
     /// \brief Check whether is dependency
     ///
@@ -351,7 +398,8 @@ class OmModChan
     /// the given arrays with relevant data related to potential installations.
     ///
     /// \param[in]  selection     : List of desired Mods for installation.
-    /// \param[out] installs      : Final list of Mods that should be installed, including dependencies
+    /// \param[out] installs      : Final list of Mods that should be installed, including dependencies,
+    ///                             sorted so dependencies come before Mods depending on them.
     /// \param[out] overlaps      : Identity list of overlapped Mods
     /// \param[out] depends       : Identity list of the supplementary installed dependencies Mods
     /// \param[out] missings      : Identity list of missing dependencies Mods
@@ -370,6 +418,23 @@ class OmModChan
     /// \param[out] dependents    : Identity list of the supplementary restored dependent Mods
     ///
     void prepareRestores(const OmPModPackArray& selection, OmPModPackArray* restores, OmWStringArray* overlappers, OmWStringArray* dependents) const;
+
+    /// \brief Plan Mods installation
+    ///
+    /// Computes the I/O work the installation of the given Mods would involve,
+    /// as if they were installed in the given order, without performing any
+    /// actual operation. Sizes are taken from archives central-directory and
+    /// file system attributes, no data is decompressed nor read. Identical
+    /// files skipping is not evaluated so the plan is a worst case.
+    ///
+    /// The time estimate is based on throughput measured during previous
+    /// install operations and is negative if no measure is available yet.
+    ///
+    /// \param[in]  installs  : Ordered list of Mods to be installed, typically
+    ///                         as returned by prepareInstalls.
+    /// \param[out] plan      : Plan structure to be filled.
+    ///
+    void planInstalls(const OmPModPackArray& installs, OmModPlan_t* plan) const;
 
     /// \brief Prepare Mods cleaning
     ///
@@ -1034,6 +1099,46 @@ class OmModChan
     ///
     void setBackupComp(int32_t method, int32_t level);
 
+    /// \brief Get Backup staging option.
+    ///
+    /// Returns Backup staging option value.
+    ///
+    /// \return Backup staging option value.
+    ///
+    bool backupStaging() const {
+      return _backup_staging;
+    }
+
+    /// \brief Set Backup staging option.
+    ///
+    /// Define and save Backup staging option value. When enabled and Backup
+    /// is on the same volume than Target, Target original files are moved
+    /// to Backup as directory then compressed in background.
+    ///
+    /// \param[in]  enable    : Backup staging enable or disable.
+    ///
+    void setBackupStaging(bool enable);
+
+    /// \brief Get Backup adaptive compression option.
+    ///
+    /// Returns Backup adaptive compression option value.
+    ///
+    /// \return Backup adaptive compression option value.
+    ///
+    bool backupAdaptive() const {
+      return _backup_adaptive;
+    }
+
+    /// \brief Set Backup adaptive compression option.
+    ///
+    /// Define and save Backup adaptive compression option value. When
+    /// enabled, Target original files whose data is already compressed are
+    /// stored in Backup archive instead of being compressed again.
+    ///
+    /// \param[in]  enable    : Backup adaptive compression enable or disable.
+    ///
+    void setBackupAdaptive(bool enable);
+
     /// \brief Get package legacy support size option.
     ///
     /// Returns package legacy support option value.
@@ -1052,6 +1157,46 @@ class OmModChan
     ///
     void setLibraryDevmod(bool enable);
 
+    /// \brief Get hard link install option.
+    ///
+    /// Returns hard link install option value.
+    ///
+    /// \return Hard link install option value.
+    ///
+    bool libraryHardlink() const {
+      return _library_hardlink;
+    }
+
+    /// \brief Set hard link install option.
+    ///
+    /// Define and save hard link install option value. When enabled, files
+    /// of directory Mods are installed as hard links to Library files
+    /// instead of copies.
+    ///
+    /// \param[in]  enable    : Hard link install enable or disable.
+    ///
+    void setLibraryHardlink(bool enable);
+
+    /// \brief Get skip identical files option.
+    ///
+    /// Returns skip identical files option value.
+    ///
+    /// \return Skip identical files option value.
+    ///
+    bool librarySkipsame() const {
+      return _library_skipsame;
+    }
+
+    /// \brief Set skip identical files option.
+    ///
+    /// Define and save skip identical files option value. When enabled, Target
+    /// files that already hold the same content than archived Mod files are
+    /// neither saved to Backup nor overwritten.
+    ///
+    /// \param[in]  enable    : Skip identical files enable or disable.
+    ///
+    void setLibrarySkipsame(bool enable);
+
     /// \brief Show hidden files and folders option.
     ///
     /// Returns show hidden option value option value.
@@ -1322,11 +1467,31 @@ class OmModChan
 
     int32_t               _modpack_list_sort;
 
+    std::unordered_map<uint64_t, OmIndexArray> _modpack_hash_idx;
+
+    std::unordered_map<uint64_t, OmIndexArray> _modpack_iden_idx;
+
+    std::unordered_map<const OmModPack*, uint32_t> _modpack_ptr_idx;
+
+    void                  _modpack_index_add(size_t);
+
+    void                  _modpack_index_build();
+
     // network library
     OmPNetPackArray       _netpack_list;
 
     int32_t               _netpack_list_sort;
 
+    std::unordered_map<uint64_t, OmIndexArray> _netpack_hash_idx;
+
+    std::unordered_map<uint64_t, OmIndexArray> _netpack_iden_idx;
+
+    std::unordered_map<const OmNetPack*, uint32_t> _netpack_ptr_idx;
+
+    void                  _netpack_index_add(size_t);
+
+    void                  _netpack_index_build();
+
     // repositories
     OmPNetRepoArray       _repository_list;
 
@@ -1343,18 +1508,40 @@ class OmModChan
 
     void*                 _netpack_notify_ptr;
 
+    // dependency graph
+    typedef struct depgraph_node_ {
+      OmIndexArray          depends;          //< resolved direct dependencies
+      OmWStringArray        missings;         //< missing direct dependencies
+      OmIndexArray          closure;          //< transitive dependencies, dependencies first
+      OmWStringArray        closure_missings; //< transitive missing dependencies
+    } depgraph_node_t;
+
+    std::vector<depgraph_node_t> _depgraph;
+
+    std::unordered_map<uint64_t, OmIndexArray> _depgraph_rdeps;
+
+    void                  _depgraph_build();
+
+    void                  _depgraph_close(const OmIndexArray&);
+
+    const depgraph_node_t* _depgraph_node(const OmModPack*) const;
+
     // mod-operations helper functions
     void                  _get_modops_depends(const OmModPack*, OmPModPackArray*, OmWStringArray*) const;
 
-    void                  _get_backup_relations(const OmModPack*, OmPModPackArray*, OmWStringArray*, OmWStringArray*) const;
+    void                  _get_overlap_index(std::unordered_map<uint64_t, OmIndexArray>*) const;
+
+    void                  _get_backup_relations(const OmModPack*, const std::unordered_map<uint64_t, OmIndexArray>&, OmPModPackArray*, OmWStringArray*, OmWStringArray*, std::unordered_set<const OmModPack*>*) const;
 
-    void                  _get_cleaning_depends(const OmModPack*, const OmPModPackArray&, OmPModPackArray*) const;
+    void                  _get_cleaning_depends(const OmModPack*, const OmPModPackArray&, OmPModPackArray*, std::unordered_set<const OmModPack*>*) const;
 
-    void                  _get_cleaning_relations(const OmModPack*, const OmPModPackArray&, OmPModPackArray*, OmWStringArray*) const;
+    void                  _get_cleaning_relations(const OmModPack*, const OmPModPackArray&, OmPModPackArray*, OmWStringArray*, std::unordered_set<const OmModPack*>*) const;
 
     void                  _get_missing_depends(const OmModPack*, OmWStringArray*) const;
 
-    void                  _get_source_downloads(const OmModPack*, OmPNetPackArray*, OmWStringArray*) const;
+    void                  _get_source_downloads(const OmModPack*, OmPNetPackArray*, OmWStringArray*, std::unordered_set<const OmNetPack*>*) const;
+
+    void                  _get_net_depends(const OmNetPack*, OmPNetPackArray*, OmWStringArray*, std::unordered_set<const OmNetPack*>*) const;
 
     void                  _get_replace_breaking(const OmNetPack*, OmWStringArray*) const;
 
@@ -1382,6 +1569,18 @@ class OmModChan
 
     static VOID WINAPI    _modops_end_fn(void*,uint8_t);
 
+    void                  _modops_wave(OmPModPackArray*);
+
+    double                _modops_rate;
+
+    void                  _modops_rate_update(uint64_t, double);
+
+    void                  _modops_rate_save();
+
+    static DWORD WINAPI   _modops_work_fn(void*);
+
+    static bool           _modops_work_progress_fn(void*, size_t, size_t, uint64_t);
+
     Om_beginCb            _modops_begin_cb;
 
     Om_progressCb         _modops_progress_cb;
@@ -1392,6 +1591,64 @@ class OmModChan
 
     void*                 _modops_user_ptr;
 
+    // staged backups compression
+    volatile bool         _bckcmp_abort;
+
+    void*                 _bckcmp_hth;
+
+    OmPModPackArray       _bckcmp_queue;
+
+    CRITICAL_SECTION      _bckcmp_lock;
+
+    void                  _bckcmp_start();
+
+    void                  _bckcmp_stop();
+
+    static DWORD WINAPI   _bckcmp_run_fn(void*);
+
+    static bool           _bckcmp_progress_fn(void*, size_t, size_t, uint64_t);
+
+    // interrupted operations recovery
+    void                  _jnl_recover();
+
+    // installed Mods footprint index
+    typedef struct fpidx_rec_ {
+      uint64_t              hash;     //< owner Mod Pack hash
+      int32_t               attr;     //< Backup entry attributes
+    } fpidx_rec_t;
+
+    typedef struct fpidx_own_ {
+      OmUint64Array         keys;     //< indexed paths keys
+      OmUint64Array         overlaps; //< counted overlapped Mod Packs hash
+    } fpidx_own_t;
+
+    std::unordered_map<uint64_t, std::vector<fpidx_rec_t>> _fpidx_path;
+
+    std::unordered_map<uint64_t, fpidx_own_t> _fpidx_owner;
+
+    std::unordered_map<uint64_t, uint32_t> _fpidx_ovlpby;
+
+    std::unordered_set<uint64_t> _fpidx_dirty;
+
+    void                  _fpidx_add(const OmModPack*);
+
+    void                  _fpidx_rem(uint64_t);
+
+    void                  _fpidx_build();
+
+    bool                  _fpidx_refresh();
+
+    // Target files CRC32 cache
+    typedef struct trgcrc_rec_ {
+      uint64_t              size;
+      uint64_t              time;
+      uint32_t              crc;
+    } trgcrc_rec_t;
+
+    std::map<uint64_t, trgcrc_rec_t> _trgcrc_cache;
+
+    CRITICAL_SECTION      _trgcrc_lock;
+
     // mods download stuff
     bool                  _download_abort;
 
@@ -1484,6 +1741,10 @@ class OmModChan
     // channel options
     bool                  _library_devmode;
 
+    bool                  _library_hardlink;
+
+    bool                  _library_skipsame;
+
     bool                  _library_showhidden;
 
     bool                  _warn_overlaps;
@@ -1494,6 +1755,10 @@ class OmModChan
 
     int32_t               _backup_level;
 
+    bool                  _backup_staging;
+
+    bool                  _backup_adaptive;
+
     bool                  _warn_extra_unin;
 
     bool                  _warn_extra_dnld;
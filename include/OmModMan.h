@@ -472,6 +472,8 @@ class OmModMan
     void*                 _netlib_notify_ptr;
 
     // application log management
+    CRITICAL_SECTION      _log_lock;
+
     OmWString             _log_str;
 
     void*                 _log_hfile;
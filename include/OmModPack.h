@@ -20,6 +20,7 @@
 #include "OmBase.h"
 
 #include "OmImage.h"
+#include "OmJournal.h"
 #include "OmVersion.h"
 
 class OmModChan;
@@ -109,6 +110,31 @@ class OmModPack
     ///
     bool parseSource(const OmWString& path);
 
+    /// \brief Parse Mod Source from cache
+    ///
+    /// Restore Source properties from data previously created by
+    /// writeSourceCache, without opening the Source archive. Caller is
+    /// responsible to check the cached data still matches Source file.
+    ///
+    /// \param[in]  path    : Path to Source file the cached data belongs to.
+    /// \param[in]  data    : Cached data.
+    /// \param[in]  size    : Size of cached data in bytes.
+    ///
+    /// \return True operation succeed, false if cached data is invalid
+    ///
+    bool parseSourceCache(const OmWString& path, const uint8_t* data, size_t size);
+
+    /// \brief Write Mod Source cache
+    ///
+    /// Serialize parsed Source properties so they can be restored later
+    /// using parseSourceCache. Directory Source cannot be cached.
+    ///
+    /// \param[out] data    : Pointer to string that receive cached data.
+    ///
+    /// \return True if data was written, false otherwise
+    ///
+    bool writeSourceCache(OmCString* data) const;
+
     /// \brief Refresh Mod source
     ///
     /// Check for source file or directory modification time and parse
@@ -161,6 +187,7 @@ class OmModPack
     /// \return wide string
     ///
     size_t sourceEntryCount() const {
+      if(this->_src_lazy) this->_src_load_entries();
       return this->_src_entry.size();
     }
 
@@ -173,6 +200,7 @@ class OmModPack
     /// \return wide string
     ///
     const OmModEntry_t& getSourceEntry(size_t i) const {
+      if(this->_src_lazy) this->_src_load_entries();
       return this->_src_entry[i];
     }
 
@@ -223,15 +251,24 @@ class OmModPack
       return this->_bck_isdir;
     }
 
+    /// \brief Backup is staged
+    ///
+    /// Check whether the Backup side of this instance is a staging directory
+    /// waiting to be compressed.
+    ///
+    /// \return True Backup side is staged, false otherwise.
+    ///
+    bool backupIsStaged() const {
+      return this->_bck_stage;
+    }
+
     /// \brief Backuo path
     ///
     /// Get Backuo file or directory path
     ///
     /// \return wide string
     ///
-    const OmWString& backupPath() const {
-      return this->_bck_path;
-    }
+    OmWString backupPath() const;
 
     /// \brief Backup entry count
     ///
@@ -469,7 +506,10 @@ class OmModPack
     ///
     /// \param[out] footprint  : Pointer to Mod Entry vector to be filled
     ///
-    void getFootprint(OmModEntryArray* footprint) const;
+    /// \return True if operation succeed, false if Source entries cannot
+    ///         be loaded.
+    ///
+    bool getFootprint(OmModEntryArray* footprint) const;
 
     /// \brief Overlapped Mod count
     ///
@@ -499,7 +539,7 @@ class OmModPack
     ///
     /// \return 64 bit unsigned integer xxHahs value
     ///
-    size_t getOverlapHash(size_t i) const {
+    uint64_t getOverlapHash(size_t i) const {
       return this->_bck_overlap[i];
     }
 
@@ -576,6 +616,23 @@ class OmModPack
     ///
     OmResult applySource(Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
 
+    /// \brief Upgrade installed Mod
+    ///
+    /// Install Mod Source over the installed former version of this Mod,
+    /// only writing added or changed files and restoring or deleting removed
+    /// ones, then takes ownership of its Backup data. Entries are compared
+    /// using size and CRC stored in archives central-directory.
+    ///
+    /// \param[in] ModPack      : Installed former version of this Mod.
+    /// \param[in] progress_cb  : Optional progression callback function
+    /// \param[in] user_ptr     : Optional user pointer to be passed to callback
+    ///
+    /// \return OM_RESULT_OK if operation succeed, OM_RESULT_ERROR if an error occurred
+    ///         and OM_RESULT_ABORT if operation was aborted or cannot apply, in which
+    ///         case nothing was modified.
+    ///
+    OmResult applyUpgrade(OmModPack* ModPack, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
     /// \brief Discard Backup data
     ///
     /// Permanently delete Backup data to avoid having restoring it to prevent
@@ -586,6 +643,35 @@ class OmModPack
     ///
     OmResult discardBackup();
 
+    /// \brief Compress staged Backup data
+    ///
+    /// Compress staged Backup directory to Backup archive according current
+    /// linked Mod Channel parameters, then delete the staging directory.
+    /// This does nothing if Backup is not staged.
+    ///
+    /// \param[in] progress_cb  : Optional progression callback function
+    /// \param[in] user_ptr     : Optional user pointer to be passed to callback
+    ///
+    /// \return OM_RESULT_OK if operation succeed, OM_RESULT_ERROR if an error occurred
+    ///         and OM_RESULT_ABORT if operation was aborted by callback or on invalid call.
+    ///
+    OmResult compressBackup(Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+    /// \brief Recover interrupted operation
+    ///
+    /// Recover Target and Backup state from journal left by an install operation
+    /// that was interrupted before completion. If Backup was completed, journaled
+    /// written files are deleted, journaled original files are put back from Backup
+    /// and created directories are deleted, otherwise Target files saved so far are
+    /// put back. Backup is then deleted and journal file is deleted once recovery
+    /// succeed.
+    ///
+    /// \param[in] path         : Path to journal file to recover from.
+    ///
+    /// \return OM_RESULT_OK if operation succeed, OM_RESULT_ERROR if an error occurred.
+    ///
+    OmResult recoverJournal(const OmWString& path);
+
     /// \brief Save Mod Pack
     ///
     /// Save this instance source data with current properties as a Mod Pack archive file.
@@ -596,10 +682,11 @@ class OmModPack
     /// \param[in] progress_cb  : Optional general progression callback function
     /// \param[in] compress_cb  : Optional file compression callback function
     /// \param[in] user_ptr     : Optional user pointer to be passed to callback
+    /// \param[in] adaptive     : Store entries whose data is already compressed
     ///
     /// \return True if operation succeed, false otherwise
     ///
-    OmResult saveAs(const OmWString& path, int32_t method = 93, int32_t level = 6, Om_progressCb progress_cb = nullptr, Om_progressCb compress_cb = nullptr, void* user_ptr = nullptr);
+    OmResult saveAs(const OmWString& path, int32_t method = 93, int32_t level = 6, Om_progressCb progress_cb = nullptr, Om_progressCb compress_cb = nullptr, void* user_ptr = nullptr, bool adaptive = false);
 
     /// \brief Check overlapped
     ///
@@ -701,6 +788,17 @@ class OmModPack
     // source parse helper
     static void         _src_parse_dir(OmModEntryArray*, const OmWString&, const OmWString&);
 
+    bool                _src_load_entries(OmWString* error = nullptr) const;
+
+    bool                _src_link(const OmWString&, bool);
+
+    // operation journal helper
+    bool                _jnl_revert(const OmJournal&);
+
+    bool                _jnl_replay(const OmJournal&);
+
+    bool                _jnl_upgrade(const OmModPack*, const OmWStringArray&, const OmWStringArray&, const OmWStringArray&);
+
     // pack source properties
     bool                _has_src;
 
@@ -714,7 +812,13 @@ class OmModPack
 
     OmWString           _src_root;
 
-    OmModEntryArray     _src_entry;
+    mutable OmModEntryArray _src_entry;
+
+    mutable volatile bool _src_lazy;
+
+    mutable CRITICAL_SECTION _src_lock;
+
+    std::vector<uint8_t> _src_same;
 
     OmWStringArray      _src_depend;
 
@@ -723,14 +827,20 @@ class OmModPack
 
     OmWString           _bck_path;
 
+    mutable CRITICAL_SECTION _bck_lock;
+
     bool                _bck_isdir;
 
+    bool                _bck_stage;
+
     OmWString           _bck_root;
 
     OmModEntryArray     _bck_entry;
 
     OmUint64Array       _bck_overlap;
 
+    OmJournal           _journal;
+
     // analytical properties
     bool                _is_overlapped;
 
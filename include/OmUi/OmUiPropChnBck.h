@@ -21,6 +21,8 @@
 
 #define CHN_PROP_BCK_CUSTDIR      0
 #define CHN_PROP_BCK_COMP_LEVEL   1
+#define CHN_PROP_BCK_STAGING      2
+#define CHN_PROP_BCK_ADAPTIVE     3
 
 /// \brief Mod Channel Properties: "Data Backup" tab
 ///
@@ -23,6 +23,8 @@
 #define CHN_PROP_LIB_DEVMODE     1
 #define CHN_PROP_LIB_WARNINGS    2
 #define CHN_PROP_LIB_SHOWHIDDEN  3
+#define CHN_PROP_LIB_HARDLINK    4
+#define CHN_PROP_LIB_SKIPSAME    5
 
 /// \brief Mod Channel Properties: "Mods Library" tab
 ///
@@ -81,6 +81,58 @@ int Om_dirDeleteRecursive(const OmWString& path);
 ///
 int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow = true);
 
+/// \brief Copy many files
+///
+/// Copy the given files to their respective location using a pool of
+/// worker threads, destination files are overwritten. The progression
+/// callback is called from the calling thread with the count of copied
+/// files, if it returns false, remaining copies are canceled.
+///
+/// \param[in]  srcs        : Source files paths to copy.
+/// \param[in]  dsts        : Destination files paths, one for each source.
+/// \param[in]  threads     : Count of workers, zero to use processor count.
+/// \param[out] failed      : Optional pointer that receive index of the
+///                           file which failed to be copied.
+/// \param[in]  progress_cb : Optional progression callback.
+/// \param[in]  user_ptr    : Custom pointer passed to progression callback.
+///
+/// \return 0 if operation succeed, ERROR_CANCELLED if aborted, WinAPI error
+///         code otherwise.
+///
+int Om_fileCopyMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads = 0, size_t* failed = nullptr, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+/// \brief Link multiple files
+///
+/// Same as Om_fileCopyMany but destination files are created as hard links
+/// to source files. Existing destination files are deleted first. Files
+/// that cannot be linked, typically because source and destination are not
+/// on the same volume, are copied instead.
+///
+/// \param[in]  srcs        : Source files paths to link.
+/// \param[in]  dsts        : Destination files paths, one for each source.
+/// \param[in]  threads     : Count of workers, zero to use processor count.
+/// \param[out] failed      : Optional pointer that receive index of the
+///                           file which failed to be linked.
+/// \param[in]  progress_cb : Optional progression callback.
+/// \param[in]  user_ptr    : Custom pointer passed to progression callback.
+///
+/// \return 0 if operation succeed, ERROR_CANCELLED if aborted, WinAPI error
+///         code otherwise.
+///
+int Om_fileLinkMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads = 0, size_t* failed = nullptr, Om_progressCb progress_cb = nullptr, void* user_ptr = nullptr);
+
+/// \brief Detach hard linked file
+///
+/// Deletes the specified file if it is a hard link sharing its data with
+/// other paths, so that it can be rewritten without altering linked files.
+///
+/// \param[in]  path   : Path to file to detach.
+///
+/// \return 0 if operation succeed or nothing to do, WinAPI error code
+///         otherwise.
+///
+int Om_fileDetach(const OmWString& path);
+
 /// \brief Copy file
 ///
 /// Copy the given file to the specified location.
@@ -102,6 +154,20 @@ int Om_fileMove(const OmWString& src, const OmWString& dst);
 ///
 int Om_fileDelete(const OmWString& path);
 
+/// \brief Delete many files
+///
+/// Deletes the specified files using a pool of worker threads.
+///
+/// \param[in]  paths   : Paths to files to delete.
+/// \param[out] results : Optional array of at least paths count integers
+///                       that receive 0 for deleted files, WinAPI error
+///                       code otherwise.
+/// \param[in]  threads : Count of workers, zero to use processor count.
+///
+/// \return Count of files that could not be deleted.
+///
+size_t Om_fileDeleteMany(const OmWStringArray& paths, int32_t* results = nullptr, uint32_t threads = 0);
+
 /// \brief Check valid file
 ///
 /// Checks whether the specified item is actually a valid file.
@@ -142,6 +208,18 @@ bool Om_isHidden(const OmWString& path);
 ///
 bool Om_pathExists(const OmWString& path);
 
+/// \brief Check many existing items
+///
+/// Checks whether the specified items exist, either as file or folder,
+/// using a pool of worker threads.
+///
+/// \param[in]  paths   : Paths to items to check.
+/// \param[out] exists  : Array of at least paths count bytes that receive
+///                       1 for existing items, 0 otherwise.
+/// \param[in]  threads : Count of workers, zero to use processor count.
+///
+void Om_pathExistsMany(const OmWStringArray& paths, uint8_t* exists, uint32_t threads = 0);
+
 /// \brief Check for network path
 ///
 /// Checks whether the specified path is a network path.
@@ -152,6 +230,18 @@ bool Om_pathExists(const OmWString& path);
 ///
 bool Om_pathIsNetwork(const OmWString& path);
 
+/// \brief Check for same volume
+///
+/// Checks whether the two specified paths are located on the same volume,
+/// meaning files can be moved from one to another by simple rename.
+///
+/// \param[in]  path1  : First path to check.
+/// \param[in]  path2  : Second path to check.
+///
+/// \return True if both paths are on the same volume, false otherwise.
+///
+bool Om_pathSameVolume(const OmWString& path1, const OmWString& path2);
+
 /// \brief Set item attribute
 ///
 /// Set attribute to specified item, either file or folder.
@@ -393,6 +483,18 @@ size_t Om_loadPlainText(OmCString* pstr, const OmWString& path);
 ///
 uint8_t* Om_loadBinary(uint64_t* size, const OmWString& path);
 
+/// \brief Save binary file.
+///
+/// Creates or overwrites the specified file with the given binary data.
+///
+/// \param[in] path    : Path to file to be saved.
+/// \param[in] data    : Data to be written.
+/// \param[in] size    : Size of data in bytes.
+///
+/// \return Error code if operation fail, zero otherwise
+///
+int32_t Om_saveBinary(const OmWString& path, const uint8_t* data, uint64_t size);
+
 /// \brief Get file size
 ///
 /// Get size of the specified file
@@ -241,6 +241,18 @@ uint64_t Om_getCRC64(const void* data, size_t size);
 ///
 uint64_t Om_getCRC64(const OmWString& str);
 
+/// \brief Compute CRC32 digest from file.
+///
+/// Calculates the zip compatible CRC32 value of the given file, so it can
+/// be compared to the CRC32 stored for archive entries.
+///
+/// \param[out] crc   : Pointer to uint32_t that receive CRC32 value.
+/// \param[in]  path  : Path to file to compute CRC32 digest.
+///
+/// \return True if operation succeed, false if open file error.
+///
+bool Om_getCRC32digest(uint32_t* crc, const OmWString& path);
+
 /// \brief Generate random bytes.
 ///
 /// Generate a random bytes sequence with values from 0 to 255 of
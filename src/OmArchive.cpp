@@ -14,16 +14,27 @@
   You should have received a copy of the GNU General Public License
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
-#include <algorithm>          //< std::replace
+#include <algorithm>          //< std::replace, std::sort
 #include <ctime>              //< time()
+#include <cmath>              //< log2()
 
 #include "minizip-ng/mz.h"
 #include "minizip-ng/mz_os.h"
+#include "minizip-ng/mz_crypt.h"
 #include "minizip-ng/mz_strm.h"
 #include "minizip-ng/mz_strm_os.h"
 #include "minizip-ng/mz_strm_buf.h"
 #include "minizip-ng/mz_strm_mem.h"
 #include "minizip-ng/mz_strm_split.h"
+#ifdef HAVE_ZLIB
+  #include "minizip-ng/mz_strm_zlib.h"
+#endif
+#ifdef HAVE_LZMA
+  #include "minizip-ng/mz_strm_lzma.h"
+#endif
+#ifdef HAVE_ZSTD
+  #include "minizip-ng/mz_strm_zstd.h"
+#endif
 #include "minizip-ng/mz_zip.h"
 #include "minizip-ng/mz_zip_rw.h"
 
@@ -45,6 +56,16 @@
 
 #define ZIP_IO_BUF_SIZE   262144
 
+#define ZIP_STR_POOL_INIT 64      //< initial string pool chars per entry
+
+#define ZIP_MAX_THREADS   16      //< maximum workers for batch extraction
+#define ZIP_POLL_DELAY    50      //< workers progression poll delay (ms)
+#define ZIP_SPILL_SIZE    8388608 //< size above which compressed data is spilled to disk
+
+#define ZIP_ADAPT_SAMPLE  65536   //< size of data sampled to choose entry method
+#define ZIP_ADAPT_MIN     512     //< minimum sample size to estimate entropy
+#define ZIP_ADAPT_ENTROPY 7.6     //< entropy (bits per byte) above which data is stored
+
 /// \brief Zip context structure
 ///
 /// Internal reader/writer structure to work with mz_zip API
@@ -59,14 +80,24 @@ typedef struct zip_context_
 
   void*         strm_splt;
 
+  void*         strm_map;
+
   int32_t       cmp_level;
 
   int32_t       cmp_method;
 
+  bool          cmp_adapt;    //< store incompressible entries
+
+  uint64_t      adapt_count;  //< count of entries stored as incompressible
+
+  uint64_t      adapt_size;   //< size of entries stored as incompressible
+
   int32_t       mz_err;
 
   OmWString     ws_err;
 
+  OmCString     path;
+
   uint8_t       buffer[ZIP_IO_BUF_SIZE];
 
 } zip_context_t;
@@ -74,23 +105,1539 @@ typedef struct zip_context_
 
 /// \brief Zip entry structure
 ///
-/// Internal structure to store zip file entry informations
+/// Internal structure to store zip file entry informations, entry path
+/// is stored in the central-directory mirror string pool at the given
+/// offset.
 ///
 typedef struct zip_entry_
 {
-  int64_t         offset;
-
+  int64_t         offset;
+
   int32_t         method;
 
   int32_t         is_dir;
 
   uint64_t        file_size;
 
-  wchar_t         file_path[OM_MAX_PATH];
+  uint32_t        crc;
+
+  int64_t         disk_offset;
+
+  uint32_t        path_off;
+
+  uint32_t        path_len;
 
 } zip_entry_t;
 
 
+/// \brief Case-insensitive path hash
+///
+/// Computes a FNV-1a hash of the given path with characters folded to
+/// upper case, so paths which match according to Om_namesMatches share
+/// the same hash.
+///
+/// \param[in] path    : Path or file name to hash.
+/// \param[in] len     : Length of path in characters.
+///
+/// \return Path hash value.
+///
+static inline uint32_t __zip_path_hash(const wchar_t* path, size_t len)
+{
+  uint32_t h = 2166136261U;
+
+  for(size_t i = 0; i < len; ++i) {
+    h ^= static_cast<uint32_t>(towupper(path[i]));
+    h *= 16777619U;
+  }
+
+  return h;
+}
+
+/// \brief Already compressed file extensions
+///
+/// File extensions of formats whose data is known to be already compressed
+/// and which gains nothing to be compressed again.
+///
+static const char* __zip_adapt_ext[] = {
+  "zip", "7z", "rar", "gz", "xz", "bz2", "zst", "lz4", "cab", "jar",
+  "png", "jpg", "jpeg", "webp", "gif", "ktx2",
+  "ogg", "oga", "opus", "mp3", "m4a", "aac", "flac", "wma", "xwma",
+  "mp4", "m4v", "mkv", "webm", "bik", "bk2", "usm",
+  nullptr
+};
+
+/// \brief Already compressed file signatures
+///
+/// Leading bytes of formats whose data is known to be already compressed.
+///
+static const struct {
+  const char* magic;
+  size_t      size;
+} __zip_adapt_sig[] = {
+  {"PK\x03\x04", 4},          // zip
+  {"7z\xBC\xAF\x27\x1C", 6},  // 7-zip
+  {"Rar!\x1A\x07", 6},        // rar
+  {"\x1F\x8B", 2},            // gzip
+  {"\xFD" "7zXZ", 5},         // xz
+  {"\x28\xB5\x2F\xFD", 4},    // zstd
+  {"\x89PNG", 4},             // png
+  {"\xFF\xD8\xFF", 3},        // jpeg
+  {"GIF8", 4},                // gif
+  {"OggS", 4},                // ogg
+  {"fLaC", 4},                // flac
+  {"ID3", 3},                 // mp3
+  {"BIK", 3},                 // bink
+  {"KB2", 3},                 // bink 2
+  {nullptr, 0}
+};
+
+/// \brief Check whether entry data is worth compressing
+///
+/// Checks file name extension and leading bytes of data against known
+/// compressed formats, then estimates entropy of the given data sample
+/// to detect data which would not benefit from compression.
+///
+/// \param[in] name    : Entry file name or path, in UTF-8.
+/// \param[in] data    : Sample of entry data, starting at beginning.
+/// \param[in] size    : Size of data sample.
+///
+/// \return True if data should be compressed, false if it should be stored.
+///
+static bool __zip_adapt_compress(const char* name, const uint8_t* data, size_t size)
+{
+  // check file extension
+  const char* ext = strrchr(name, '.');
+  if(ext && !strchr(ext, '/')) {
+
+    char lext[8];
+    size_t n = 0;
+
+    for(++ext; ext[n] && n < sizeof(lext) - 1; ++n)
+      lext[n] = tolower(static_cast<unsigned char>(ext[n]));
+
+    lext[n] = 0;
+
+    if(!ext[n]) {
+      for(size_t i = 0; __zip_adapt_ext[i]; ++i)
+        if(strcmp(lext, __zip_adapt_ext[i]) == 0)
+          return false;
+    }
+  }
+
+  // check format signature
+  for(size_t i = 0; __zip_adapt_sig[i].magic; ++i) {
+    if(size >= __zip_adapt_sig[i].size && memcmp(data, __zip_adapt_sig[i].magic, __zip_adapt_sig[i].size) == 0)
+      return false;
+  }
+
+  // too few data to estimate anything
+  if(size < ZIP_ADAPT_MIN)
+    return true;
+
+  // estimate entropy of sample from byte frequencies
+  uint32_t freq[256];
+  memset(freq, 0, sizeof(freq));
+
+  for(size_t i = 0; i < size; ++i)
+    freq[data[i]]++;
+
+  double entropy = 0.0;
+
+  for(size_t i = 0; i < 256; ++i) {
+    if(freq[i]) {
+      double p = static_cast<double>(freq[i]) / size;
+      entropy -= p * log2(p);
+    }
+  }
+
+  return (entropy < ZIP_ADAPT_ENTROPY);
+}
+
+
+/// \brief Level for raw entry write
+///
+/// Returns the compression level to pass to minizip when writing already
+/// compressed entry data. Since minizip forces the Store method for entries
+/// opened with level zero, the default level is returned in place of zero
+/// for any other method.
+///
+/// \param[in] method  : Compression method of the raw entry data.
+/// \param[in] level   : Compression level of the archive.
+///
+/// \return Compression level to write entry with.
+///
+static inline int32_t __zip_raw_level(uint16_t method, int32_t level)
+{
+  if(level == 0 && method != MZ_COMPRESS_METHOD_STORE)
+    return MZ_COMPRESS_LEVEL_DEFAULT;
+
+  return level;
+}
+
+
+/// \brief ASCII case-insensitive string compare
+///
+/// Compares the given UTF-8 strings, ignoring case of ASCII characters.
+///
+/// \param[in] left    : String to compare.
+/// \param[in] right   : String to compare.
+/// \param[in] len     : Count of bytes to compare.
+///
+/// \return True if strings matches, false otherwise.
+///
+static inline bool __zip_probe_match(const char* left, const char* right, size_t len)
+{
+  for(size_t i = 0; i < len; ++i)
+    if(tolower(static_cast<unsigned char>(left[i])) != tolower(static_cast<unsigned char>(right[i])))
+      return false;
+
+  return true;
+}
+
+
+/// \brief Mapped file stream structure
+///
+/// Internal minizip stream object to read zip file through a read-only
+/// memory mapped view of the whole file.
+///
+typedef struct zip_map_stream_
+{
+  mz_stream       stream;
+
+  HANDLE          hfile;
+
+  HANDLE          hmap;
+
+  uint8_t*        data;
+
+  int64_t         size;
+
+  int64_t         position;
+
+} zip_map_stream_t;
+
+static int32_t __zip_map_open(void *stream, const char *path, int32_t mode);
+static int32_t __zip_map_is_open(void *stream);
+static int32_t __zip_map_read(void *stream, void *buf, int32_t size);
+static int32_t __zip_map_write(void *stream, const void *buf, int32_t size);
+static int64_t __zip_map_tell(void *stream);
+static int32_t __zip_map_seek(void *stream, int64_t offset, int32_t origin);
+static int32_t __zip_map_close(void *stream);
+static int32_t __zip_map_error(void *stream);
+static void*   __zip_map_create();
+static void    __zip_map_delete(void **stream);
+
+/// \brief Mapped file stream vtable
+///
+/// minizip stream interface functions for mapped file stream
+///
+static mz_stream_vtbl __zip_map_vtbl = {
+  __zip_map_open,
+  __zip_map_is_open,
+  __zip_map_read,
+  __zip_map_write,
+  __zip_map_tell,
+  __zip_map_seek,
+  __zip_map_close,
+  __zip_map_error,
+  __zip_map_create,
+  __zip_map_delete,
+  nullptr,
+  nullptr
+};
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_open(void *stream, const char *path, int32_t mode)
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(stream);
+
+  // mapped stream is read-only
+  if(mode & (MZ_OPEN_MODE_WRITE|MZ_OPEN_MODE_CREATE|MZ_OPEN_MODE_APPEND))
+    return MZ_SUPPORT_ERROR;
+
+  OmWString wcs_path;
+  Om_toUTF16(&wcs_path, path);
+
+  map->hfile = CreateFileW(wcs_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(map->hfile == INVALID_HANDLE_VALUE) {
+    map->hfile = nullptr;
+    return MZ_OPEN_ERROR;
+  }
+
+  LARGE_INTEGER file_size;
+  if(!GetFileSizeEx(map->hfile, &file_size) || file_size.QuadPart == 0) {
+    __zip_map_close(stream);
+    return MZ_OPEN_ERROR;
+  }
+
+  map->hmap = CreateFileMappingW(map->hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(!map->hmap) {
+    __zip_map_close(stream);
+    return MZ_OPEN_ERROR;
+  }
+
+  // may fail for large file in 32-bit address space
+  map->data = static_cast<uint8_t*>(MapViewOfFile(map->hmap, FILE_MAP_READ, 0, 0, 0));
+  if(!map->data) {
+    __zip_map_close(stream);
+    return MZ_MEM_ERROR;
+  }
+
+  map->size = file_size.QuadPart;
+  map->position = 0;
+
+  return MZ_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_is_open(void *stream)
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(stream);
+
+  return (map->data != nullptr) ? MZ_OK : MZ_OPEN_ERROR;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_read(void *stream, void *buf, int32_t size)
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(stream);
+
+  if(size > map->size - map->position)
+    size = map->size - map->position;
+
+  if(size <= 0)
+    return 0;
+
+  memcpy(buf, map->data + map->position, size);
+  map->position += size;
+
+  return size;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_write(void *stream, const void *buf, int32_t size)
+{
+  MZ_UNUSED(stream); MZ_UNUSED(buf); MZ_UNUSED(size);
+
+  return MZ_WRITE_ERROR;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int64_t __zip_map_tell(void *stream)
+{
+  return static_cast<zip_map_stream_t*>(stream)->position;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_seek(void *stream, int64_t offset, int32_t origin)
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(stream);
+
+  int64_t position;
+
+  switch(origin)
+  {
+  case MZ_SEEK_CUR: position = map->position + offset; break;
+  case MZ_SEEK_END: position = map->size + offset; break;
+  case MZ_SEEK_SET: position = offset; break;
+  default: return MZ_SEEK_ERROR;
+  }
+
+  if(position < 0 || position > map->size)
+    return MZ_SEEK_ERROR;
+
+  map->position = position;
+
+  return MZ_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_close(void *stream)
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(stream);
+
+  if(map->data) {
+    UnmapViewOfFile(map->data);
+    map->data = nullptr;
+  }
+
+  if(map->hmap) {
+    CloseHandle(map->hmap);
+    map->hmap = nullptr;
+  }
+
+  if(map->hfile) {
+    CloseHandle(map->hfile);
+    map->hfile = nullptr;
+  }
+
+  map->size = 0;
+  map->position = 0;
+
+  return MZ_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static int32_t __zip_map_error(void *stream)
+{
+  MZ_UNUSED(stream);
+
+  return MZ_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static void* __zip_map_create()
+{
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(calloc(1, sizeof(zip_map_stream_t)));
+
+  if(map)
+    map->stream.vtbl = &__zip_map_vtbl;
+
+  return map;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static void __zip_map_delete(void **stream)
+{
+  if(!stream || !*stream)
+    return;
+
+  __zip_map_close(*stream);
+  free(*stream);
+
+  *stream = nullptr;
+}
+
+/// \brief Get mapped entry data
+///
+/// Retrieves pointer to the stored (uncompressed) data of the currently
+/// open entry within the mapped file view. Entry must be opened for reading
+/// with mz_zip_entry_read_open before calling this function.
+///
+/// \param[in] zctx      : Zip context.
+/// \param[in] file_info : Current entry informations.
+///
+/// \return Pointer to entry data in mapped view or nullptr if entry cannot
+///         be served from mapped view.
+///
+static inline const uint8_t* __zip_map_entry_data(zip_context_t* zctx, const mz_zip_file* file_info)
+{
+  if(!zctx->strm_map)
+    return nullptr;
+
+  if(file_info->compression_method != MZ_COMPRESS_METHOD_STORE)
+    return nullptr;
+
+  if(file_info->flag & MZ_ZIP_FLAG_ENCRYPTED)
+    return nullptr;
+
+  if(file_info->compressed_size != file_info->uncompressed_size)
+    return nullptr;
+
+  zip_map_stream_t* map = static_cast<zip_map_stream_t*>(zctx->strm_map);
+
+  // stream is positioned at start of entry data once local header was read
+  if(map->position + file_info->compressed_size > map->size)
+    return nullptr;
+
+  return map->data + map->position;
+}
+
+
+/// \brief Close zip reader
+///
+/// Close and delete zip handle and streams of the given reader context.
+///
+/// \param[in] zctx      : Zip context.
+///
+/// \return minizip zip close result.
+///
+static int32_t __zip_reader_close(zip_context_t* zctx)
+{
+  int32_t mz_err = MZ_OK;
+
+  if(zctx->zip_hnd) {
+    mz_err = mz_zip_close(zctx->zip_hnd);
+    mz_zip_delete(&zctx->zip_hnd);
+  }
+
+  if(zctx->strm_splt) {
+    mz_stream_split_close(zctx->strm_splt);
+    mz_stream_split_delete(&zctx->strm_splt);
+  }
+
+  if(zctx->strm_buff)
+    mz_stream_buffered_delete(&zctx->strm_buff);
+
+  if(zctx->strm_file)
+    mz_stream_os_delete(&zctx->strm_file);
+
+  if(zctx->strm_map)
+    __zip_map_delete(&zctx->strm_map);
+
+  return mz_err;
+}
+
+/// \brief Open zip reader
+///
+/// Creates streams and zip handle of the given context to read the
+/// specified zip file and prepare its central directory for browsing.
+/// On failure, the context is cleaned up and its error members are set.
+///
+/// \param[in] zctx      : Zip context.
+/// \param[in] path      : UTF-8 path to zip file.
+/// \param[in] mapped    : Read file through memory mapped view.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __zip_reader_open(zip_context_t* zctx, const char* path, bool mapped)
+{
+  int32_t mz_err = MZ_OK;
+
+  // stream to read zip data from
+  void* strm_read = nullptr;
+
+  if(mapped) {
+
+    // try to map the whole file, if this fail (typically for large file in
+    // 32-bit address space) we fall back to the standard file stream
+    zctx->strm_map = __zip_map_create();
+    if(zctx->strm_map) {
+      if(mz_stream_open(zctx->strm_map, path, MZ_OPEN_MODE_READ) == MZ_OK) {
+        strm_read = zctx->strm_map;
+      } else {
+        __zip_map_delete(&zctx->strm_map);
+      }
+    }
+  }
+
+  if(!strm_read) {
+
+    // create zip reader architecture
+    zctx->strm_file = mz_stream_os_create();
+    if(!zctx->strm_file) {
+      zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream OS create error";
+      __zip_reader_close(zctx);
+      return false;
+    }
+
+    zctx->strm_buff = mz_stream_buffered_create();
+    if(!zctx->strm_buff) {
+      zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream buffered create error";
+      __zip_reader_close(zctx);
+      return false;
+    }
+
+    zctx->strm_splt = mz_stream_split_create();
+    if(!zctx->strm_splt) {
+      zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream split create error";
+      __zip_reader_close(zctx);
+      return false;
+    }
+
+    mz_stream_set_base(zctx->strm_buff, zctx->strm_file);
+    mz_stream_set_base(zctx->strm_splt, zctx->strm_buff);
+
+    mz_err = mz_stream_open(zctx->strm_splt, path, MZ_OPEN_MODE_READ);
+    if(mz_err != MZ_OK) {
+      __zip_reader_close(zctx);
+      zctx->mz_err = mz_err; zctx->ws_err = L"file stream open error";
+      return false;
+    }
+
+    strm_read = zctx->strm_splt;
+  }
+
+  zctx->zip_hnd = mz_zip_create();
+  if(!zctx->zip_hnd) {
+    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"zip handle create error";
+    __zip_reader_close(zctx);
+    return false;
+  }
+
+  // mz_zip_reader_open
+  mz_err = mz_zip_open(zctx->zip_hnd, strm_read, MZ_OPEN_MODE_READ);
+  if(mz_err != MZ_OK) {
+    __zip_reader_close(zctx);
+    zctx->mz_err = mz_err;  zctx->ws_err = L"zip file open error";
+    return false;
+  }
+
+  // mz_zip_reader_unzip_cd
+  mz_zip_file *cd_info = nullptr;
+
+  // check weather zip central directory is simple or zipped
+  mz_err = mz_zip_goto_first_entry(zctx->zip_hnd);
+  if(mz_err == MZ_OK)
+    mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &cd_info);
+
+  if(mz_err != MZ_OK) {
+    __zip_reader_close(zctx);
+    zctx->mz_err = mz_err;  zctx->ws_err = L"central directory parse error";
+    return false;
+  }
+
+  // Check whether this is a compressed central directory
+  if(strcmp(cd_info->filename, "__cdcd__") == 0) {
+
+    // Unzip the central directory
+
+    uint64_t number_entry = 0;
+
+    // Try to open entry for reading
+    if(mz_zip_entry_is_open(zctx->zip_hnd) != MZ_OK) {
+      // if open fail zip file may be encrypted, we do not support it
+      if(cd_info->flag & MZ_ZIP_FLAG_ENCRYPTED) {
+        __zip_reader_close(zctx);
+        zctx->mz_err = MZ_PASSWORD_ERROR;  zctx->ws_err = L"zip file is password protected";
+        return false;
+      }
+    }
+
+    void *file_extra_stream = nullptr;
+
+    file_extra_stream = mz_stream_mem_create();
+    if(!file_extra_stream) {
+      __zip_reader_close(zctx);
+      zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"central directory unzip error";
+      return false;
+    }
+
+    mz_stream_mem_set_buffer(file_extra_stream, (void*)cd_info->extrafield, cd_info->extrafield_size);
+    mz_err = mz_zip_extrafield_find(file_extra_stream, 0xcdcd, INT32_MAX, nullptr);
+    if(mz_err == MZ_OK)
+      mz_err = mz_stream_read_uint64(file_extra_stream, &number_entry);
+    mz_stream_mem_delete(&file_extra_stream);
+
+    if(mz_err != MZ_OK) {
+      __zip_reader_close(zctx);
+      zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"central directory unzip error";
+      return false;
+    }
+
+    void *cd_mem_stream = nullptr;
+
+    mz_zip_get_cd_mem_stream(zctx->zip_hnd, &cd_mem_stream);
+    if(mz_stream_mem_is_open(cd_mem_stream) != MZ_OK)
+        mz_stream_mem_open(cd_mem_stream, nullptr, MZ_OPEN_MODE_CREATE);
+
+    mz_err = mz_stream_seek(cd_mem_stream, 0, MZ_SEEK_SET);
+    if(mz_err == MZ_OK)
+      //mz_err = mz_stream_copy_stream(cd_mem_stream, nullptr, handle, mz_zip_reader_entry_read, (int32_t)cd_info->uncompressed_size);
+      mz_stream_copy_stream(cd_mem_stream, nullptr, zctx->zip_hnd, mz_zip_entry_read, (int32_t)cd_info->uncompressed_size);
+
+    if(mz_err == MZ_OK) {
+      mz_zip_set_cd_stream(zctx->zip_hnd, 0, cd_mem_stream);
+      mz_zip_set_number_entry(zctx->zip_hnd, number_entry);
+    }
+  }
+
+  mz_err = mz_zip_goto_first_entry(zctx->zip_hnd);
+  if(mz_err != MZ_OK) {
+    __zip_reader_close(zctx);
+    zctx->mz_err = mz_err;  zctx->ws_err = L"central-directory unzip error";
+    return false;
+  }
+
+  return true;
+}
+
+/// \brief Extract entry to file
+///
+/// Extract the zip entry at the given central-directory position and save
+/// it as file, creating destination directories as required.
+///
+/// \param[in] zctx        : Zip context opened for reading.
+/// \param[in] offset      : Entry position in central-directory.
+/// \param[in] dst         : Path to destination file to save.
+/// \param[in] name        : Entry name passed to progression callback.
+/// \param[in] progress_cb : Optional progression callback.
+/// \param[in] user_ptr    : Custom pointer passed to progression callback.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __zip_entry_save(zip_context_t* zctx, int64_t offset, const OmWString& dst, const wchar_t* name, Om_progressCb progress_cb, void* user_ptr)
+{
+  int32_t mz_err;
+
+  mz_err = mz_zip_goto_entry(zctx->zip_hnd, offset);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry goto error";
+    return false;
+  }
+
+  // get zipped file info
+  mz_zip_file *file_info = nullptr;
+  mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
+
+  // check whether zip entry is a directory
+  if( (mz_zip_entry_is_dir(zctx->zip_hnd) == MZ_OK) &&
+      (mz_zip_entry_is_symlink(zctx->zip_hnd) != MZ_OK)) {
+
+    if(!Om_isDir(dst)) {
+      // we simply create directory
+      mz_err = Om_dirCreateRecursive(dst);
+      if(mz_err != ERROR_SUCCESS && mz_err != ERROR_ALREADY_EXISTS) {
+        zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // TODO: implement symlink creation
+
+  OmWString dst_dir = Om_getDirPart(dst);
+
+  // create the destination path tree if required
+  if(!Om_isDir(dst_dir)) {
+    // we simply create directory
+    mz_err = Om_dirCreateRecursive(dst_dir);
+    if(mz_err != ERROR_SUCCESS && mz_err != ERROR_ALREADY_EXISTS) {
+      zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
+      return false;
+    }
+  }
+
+  // Create the file on disk so we can save to it
+  void *stream = mz_stream_os_create();
+  if(!stream) {
+    zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"create stream OS error";
+    return false;
+  }
+
+  OmCString utf8_dst;
+  Om_toUTF8(&utf8_dst, dst);
+
+  mz_err = mz_stream_os_open(stream, utf8_dst.c_str(), MZ_OPEN_MODE_CREATE);
+
+  if(mz_err == MZ_OK) {
+
+    // If the entry isn't open for reading, open it
+    if(mz_zip_entry_is_open(zctx->zip_hnd) != MZ_OK)
+      mz_err = mz_zip_entry_read_open(zctx->zip_hnd, 0, nullptr);
+
+    if(mz_err != MZ_OK) {
+      zctx->mz_err = mz_err;  zctx->ws_err = L"entry read open error";
+      mz_stream_close(stream);
+      mz_stream_delete(&stream);
+      return false;
+    }
+
+    int32_t wb = 0;
+    int32_t rb = 0;
+
+    // stored entry within mapped file is written directly from view
+    const uint8_t* data = __zip_map_entry_data(zctx, file_info);
+    if(data) {
+
+      uint32_t crc = 0;
+      int64_t tot = file_info->uncompressed_size;
+      int64_t pos = 0;
+
+      while(pos < tot) {
+        rb = (tot - pos) > ZIP_IO_BUF_SIZE ? ZIP_IO_BUF_SIZE : (tot - pos);
+        crc = mz_crypt_crc32_update(crc, data + pos, rb);
+        wb = mz_stream_write(stream, data + pos, rb);
+        if(wb != rb) {
+          mz_err = MZ_WRITE_ERROR;
+          break;
+        }
+        pos += rb;
+        if(progress_cb) {
+          progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(name));
+        }
+      }
+
+      if(mz_err == MZ_OK) {
+        mz_err = (crc == file_info->crc) ? MZ_END_OF_STREAM : MZ_CRC_ERROR;
+      }
+    }
+
+    // Write data to stream until done
+    while(mz_err == MZ_OK) {
+      rb = mz_zip_entry_read(zctx->zip_hnd, zctx->buffer, sizeof(zctx->buffer));
+      if(rb > 0) {
+          wb = mz_stream_write(stream, zctx->buffer, rb);
+          if(wb != rb) {
+            mz_err = MZ_WRITE_ERROR;
+            break;
+          }
+      } else if(rb < 0) {
+        mz_err = rb;
+        break;
+      } else {
+        mz_err = MZ_END_OF_STREAM;
+        break;
+      }
+      if(progress_cb) {
+        progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(name));
+      }
+    }
+    mz_zip_entry_close(zctx->zip_hnd);
+  }
+
+  mz_stream_close(stream);
+  mz_stream_delete(&stream);
+
+  if(mz_err != MZ_OK && mz_err != MZ_END_OF_STREAM ) {
+    zctx->mz_err = mz_err; zctx->ws_err = L"file stream error";
+    return false;
+  }
+
+  // Set the time of the file that has been created
+  mz_os_set_file_date(utf8_dst.c_str(), file_info->modified_date, file_info->accessed_date, file_info->creation_date);
+
+  uint32_t target_attrib = 0;
+
+  // Set file attributes for the correct system
+  int32_t err_attrib = mz_zip_attrib_convert(MZ_HOST_SYSTEM(file_info->version_madeby),
+    file_info->external_fa, MZ_VERSION_MADEBY_HOST_SYSTEM, &target_attrib);
+
+  if(err_attrib == MZ_OK)
+    mz_os_set_file_attribs(utf8_dst.c_str(), file_info->external_fa);
+
+  return true;
+}
+
+/// \brief Batch extraction job
+///
+/// Internal structure to describe one entry to be extracted by batch
+/// extraction workers.
+///
+typedef struct zip_save_job_
+{
+  int64_t           offset;
+
+  int64_t           disk_offset;
+
+  const wchar_t*    name;
+
+  const OmWString*  dest;
+
+  size_t            index;      //< position in caller indices array
+
+} zip_save_job_t;
+
+/// \brief Batch extraction context
+///
+/// Internal structure shared by batch extraction workers.
+///
+typedef struct zip_save_batch_
+{
+  const char*       path;
+
+  bool              mapped;
+
+  zip_save_job_t*   jobs;
+
+  LONG              jobs_count;
+
+  volatile LONG     jobs_next;
+
+  volatile LONG     jobs_done;
+
+  volatile LONG     jobs_last;  //< index of last completed job
+
+  volatile LONG     abort;
+
+  uint8_t*          saved;
+
+  CRITICAL_SECTION  lock;
+
+  int32_t           mz_err;
+
+  OmWString         ws_err;
+
+} zip_save_batch_t;
+
+/// \brief Compare batch jobs
+///
+/// Comparison function to sort batch extraction jobs by local header
+/// offset, so workers read zip file sequentially.
+///
+static bool __zip_save_job_compare(const zip_save_job_t& a, const zip_save_job_t& b)
+{
+  return (a.disk_offset < b.disk_offset);
+}
+
+/// \brief Batch extraction failure
+///
+/// Records the first error encountered by a batch extraction worker and
+/// signals all other workers to stop.
+///
+/// \param[in] batch     : Batch extraction context.
+/// \param[in] mz_err    : minizip or system error code.
+/// \param[in] ws_err    : Error description string.
+///
+static void __zip_save_fail(zip_save_batch_t* batch, int32_t mz_err, const OmWString& ws_err)
+{
+  EnterCriticalSection(&batch->lock);
+
+  if(batch->mz_err == MZ_OK) {
+    batch->mz_err = mz_err;
+    batch->ws_err = ws_err;
+  }
+
+  LeaveCriticalSection(&batch->lock);
+
+  InterlockedExchange(&batch->abort, 1);
+}
+
+/// \brief Batch extraction worker
+///
+/// Thread function of batch extraction worker, each worker opens its own
+/// reader on zip file then extracts jobs until none remain.
+///
+/// \param[in] ptr       : Pointer to batch extraction context.
+///
+static DWORD WINAPI __zip_save_run_fn(void* ptr)
+{
+  zip_save_batch_t* batch = static_cast<zip_save_batch_t*>(ptr);
+
+  zip_context_t* zctx = new(std::nothrow) zip_context_t();
+  if(!zctx) {
+    __zip_save_fail(batch, MZ_MEM_ERROR, L"zip context create error");
+    return 1;
+  }
+
+  if(!__zip_reader_open(zctx, batch->path, batch->mapped)) {
+    __zip_save_fail(batch, zctx->mz_err, zctx->ws_err);
+    delete zctx;
+    return 1;
+  }
+
+  DWORD exit_code = 0;
+
+  while(!batch->abort) {
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    zip_save_job_t* job = &batch->jobs[j];
+
+    if(!__zip_entry_save(zctx, job->offset, *job->dest, job->name, nullptr, nullptr)) {
+      __zip_save_fail(batch, zctx->mz_err, zctx->ws_err + L" \"" + *job->dest + L"\"");
+      exit_code = 1;
+      break;
+    }
+
+    // each job has its own flag, no need to synchronize
+    if(batch->saved)
+      batch->saved[job->index] = 1;
+
+    InterlockedExchange(&batch->jobs_last, j);
+    InterlockedIncrement(&batch->jobs_done);
+  }
+
+  __zip_reader_close(zctx);
+  delete zctx;
+
+  return exit_code;
+}
+
+/// \brief Copy entry between zip
+///
+/// Copy entry at given central-directory position of source zip reader to
+/// the destination zip writer. Data is either transferred as-is (raw) or
+/// decompressed then recompressed with writer method, in both cases data
+/// is streamed by chunks through the writer I/O buffer, so memory usage
+/// does not depend on entry size.
+///
+/// \param[in] zctx        : Destination zip context opened for writing.
+/// \param[in] src_zctx    : Source zip context opened for reading.
+/// \param[in] offset      : Source entry position in central-directory.
+/// \param[in] dst         : Destination entry name.
+/// \param[in] raw         : Transfer compressed data as-is.
+/// \param[in] progress_cb : Optional progression callback.
+/// \param[in] user_ptr    : Custom pointer passed to progression callback.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __zip_entry_copy(zip_context_t* zctx, zip_context_t* src_zctx, int64_t offset, const OmWString& dst, bool raw, Om_progressCb progress_cb, void* user_ptr)
+{
+  int32_t mz_err;
+
+  mz_err = mz_zip_goto_entry(src_zctx->zip_hnd, offset);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry goto error";
+    return false;
+  }
+
+  // get source zipped file info
+  mz_zip_file *src_info = nullptr;
+  mz_err = mz_zip_entry_get_info(src_zctx->zip_hnd, &src_info);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry info error";
+    return false;
+  }
+
+  // we do not support encrypted data
+  if(src_info->flag & MZ_ZIP_FLAG_ENCRYPTED) {
+    zctx->mz_err = MZ_SUPPORT_ERROR;  zctx->ws_err = L"source entry is encrypted";
+    return false;
+  }
+
+  OmCString zcdr_dst;
+  Om_toZipCDR(&zcdr_dst, dst);
+
+  // copy source entry info with new name and without extra fields
+  mz_zip_file file_info;
+  memset(&file_info, 0, sizeof(file_info));
+
+  // external attributes are only meaningful along with the host system
+  // they were made by
+  file_info.version_madeby = src_info->version_madeby;
+  file_info.filename = zcdr_dst.c_str();
+  file_info.uncompressed_size = src_info->uncompressed_size;
+  file_info.flag = MZ_ZIP_FLAG_UTF8;
+  file_info.modified_date = src_info->modified_date;
+  file_info.accessed_date = src_info->accessed_date;
+  file_info.creation_date = src_info->creation_date;
+  file_info.external_fa = src_info->external_fa;
+
+  if(raw) {
+    // method specific flags describe raw data, they are kept along with
+    // data descriptor flag
+    file_info.flag |= src_info->flag & (MZ_ZIP_FLAG_LZMA_EOS_MARKER|MZ_ZIP_FLAG_DEFLATE_FAST|MZ_ZIP_FLAG_DATA_DESCRIPTOR);
+    file_info.compression_method = src_info->compression_method;
+    file_info.compressed_size = src_info->compressed_size;
+    file_info.crc = src_info->crc;
+  } else {
+    file_info.compression_method = zctx->cmp_method;
+  }
+
+  // open source entry for reading
+  mz_err = mz_zip_entry_read_open(src_zctx->zip_hnd, raw ? 1 : 0, nullptr);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"source entry read open error";
+    return false;
+  }
+
+  bool is_dir = (mz_zip_attrib_is_dir(file_info.external_fa, file_info.version_madeby) == MZ_OK);
+
+  // data already read from source, not yet written
+  int32_t rb = 0;
+
+  // sample beginning of decompressed data to check whether it is worth
+  // compressing, the sample is written first once entry is opened
+  if(!raw && !is_dir && zctx->cmp_adapt && file_info.compression_method != MZ_COMPRESS_METHOD_STORE) {
+
+    rb = mz_zip_entry_read(src_zctx->zip_hnd, zctx->buffer, ZIP_ADAPT_SAMPLE);
+    if(rb < 0) {
+      mz_zip_entry_close(src_zctx->zip_hnd);
+      zctx->mz_err = rb;  zctx->ws_err = L"source entry read error";
+      return false;
+    }
+
+    if(!__zip_adapt_compress(zcdr_dst.c_str(), zctx->buffer, rb)) {
+      file_info.compression_method = MZ_COMPRESS_METHOD_STORE;
+      zctx->adapt_count++;  zctx->adapt_size += file_info.uncompressed_size;
+    }
+  }
+
+  // open destination entry for writing
+  int32_t level = raw ? __zip_raw_level(file_info.compression_method, zctx->cmp_level) : zctx->cmp_level;
+
+  mz_err = mz_zip_entry_write_open(zctx->zip_hnd, &file_info, level, raw ? 1 : 0, nullptr);
+  if(mz_err != MZ_OK) {
+    mz_zip_entry_close(src_zctx->zip_hnd);
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry write open error";
+    return false;
+  }
+
+  // if source is not directory, transfer data
+  if(!is_dir) {
+
+    int64_t data_size = raw ? file_info.compressed_size : file_info.uncompressed_size;
+
+    int32_t wb = 0;
+
+    while(mz_err == MZ_OK) {
+      // sampled data is written first
+      if(rb == 0)
+        rb = mz_zip_entry_read(src_zctx->zip_hnd, zctx->buffer, sizeof(zctx->buffer));
+      if(rb > 0) {
+          wb = mz_zip_entry_write(zctx->zip_hnd, zctx->buffer, rb);
+          if(wb != rb) {
+            mz_err = MZ_WRITE_ERROR;
+            break;
+          }
+      } else if(rb < 0) {
+        mz_err = rb;
+        break;
+      } else {
+        mz_err = MZ_END_OF_STREAM;
+        break;
+      }
+
+      if(progress_cb) {
+        progress_cb(user_ptr, data_size, rb, reinterpret_cast<uint64_t>(dst.c_str()));
+      }
+
+      rb = 0;
+    }
+  }
+
+  if(mz_err != MZ_OK && mz_err != MZ_END_OF_STREAM ) {
+    mz_zip_entry_close(src_zctx->zip_hnd);
+    mz_zip_entry_close(zctx->zip_hnd);
+    zctx->mz_err = mz_err; zctx->ws_err = L"stream error";
+    return false;
+  }
+
+  // get actual sizes and CRC from source, data descriptor may be used, this
+  // also verifies CRC of decompressed data
+  uint32_t crc32 = 0;
+  int64_t compressed_size = 0;
+  int64_t uncompressed_size = 0;
+
+  mz_err = mz_zip_entry_read_close(src_zctx->zip_hnd, &crc32, &compressed_size, &uncompressed_size);
+  if(mz_err != MZ_OK) {
+    mz_zip_entry_close(zctx->zip_hnd);
+    zctx->mz_err = mz_err; zctx->ws_err = L"source entry close error";
+    return false;
+  }
+
+  if(raw) {
+    mz_err = mz_zip_entry_write_close(zctx->zip_hnd, crc32, compressed_size, uncompressed_size);
+  } else {
+    mz_err = mz_zip_entry_close(zctx->zip_hnd);
+  }
+
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err; zctx->ws_err = L"entry close error";
+    return false;
+  }
+
+  return true;
+}
+
+/// \brief Create compression stream
+///
+/// Creates the minizip compression stream corresponding to the given zip
+/// compression method.
+///
+/// \param[in] method    : Zip compression method.
+///
+/// \return New compression stream or nullptr if method is STORE or
+///         not supported.
+///
+static void* __zip_compress_create(int32_t method)
+{
+  void* stream = nullptr;
+
+  switch(method)
+  {
+#ifdef HAVE_ZLIB
+  case MZ_COMPRESS_METHOD_DEFLATE:
+    stream = mz_stream_zlib_create();
+    break;
+#endif
+#ifdef HAVE_LZMA
+  case MZ_COMPRESS_METHOD_LZMA:
+  case MZ_COMPRESS_METHOD_XZ:
+    stream = mz_stream_lzma_create();
+    if(stream) mz_stream_set_prop_int64(stream, MZ_STREAM_PROP_COMPRESS_METHOD, method);
+    break;
+#endif
+#ifdef HAVE_ZSTD
+  case MZ_COMPRESS_METHOD_ZSTD:
+    stream = mz_stream_zstd_create();
+    break;
+#endif
+  default:
+    break;
+  }
+
+  return stream;
+}
+
+/// \brief Batch compression job
+///
+/// Internal structure to describe one file to be compressed by batch
+/// compression workers then appended to zip.
+///
+typedef struct zip_add_job_
+{
+  const OmWString*  src;
+
+  const OmWString*  dst;
+
+  bool              is_dir;
+
+  int32_t           method;       //< compression method chosen for entry
+
+  bool              adapted;      //< entry stored as incompressible
+
+  int64_t           size;
+
+  uint32_t          crc;
+
+  int64_t           comp_size;
+
+  void*             strm_out;
+
+  OmCString         spill_path;
+
+  volatile LONG     state;        //< 0 = pending, 1 = done, 2 = error
+
+  int32_t           mz_err;
+
+  OmWString         ws_err;
+
+} zip_add_job_t;
+
+/// \brief Batch compression context
+///
+/// Internal structure shared by batch compression workers.
+///
+typedef struct zip_add_batch_
+{
+  const char*       path;
+
+  int32_t           method;
+
+  int32_t           level;
+
+  bool              adapt;
+
+  zip_add_job_t*    jobs;
+
+  LONG              jobs_count;
+
+  volatile LONG     jobs_next;
+
+  volatile LONG     abort;
+
+  HANDLE            hwindow;      //< semaphore limiting jobs ahead of writer
+
+  HANDLE            hdone;        //< event signaled when a job is done
+
+} zip_add_batch_t;
+
+/// \brief Release batch compression job
+///
+/// Deletes output stream and spill file of the given job.
+///
+/// \param[in] job       : Batch compression job.
+///
+static void __zip_add_job_clear(zip_add_job_t* job)
+{
+  if(job->strm_out) {
+    if(job->spill_path.empty()) {
+      mz_stream_mem_delete(&job->strm_out);
+    } else {
+      mz_stream_os_close(job->strm_out);
+      mz_stream_os_delete(&job->strm_out);
+    }
+  }
+
+  if(!job->spill_path.empty()) {
+    Om_fileDelete(Om_toUTF16(job->spill_path));
+    job->spill_path.clear();
+  }
+}
+
+/// \brief Compress batch job
+///
+/// Compress source file of the given job to memory or to temporary spill
+/// file for large files, computing CRC of uncompressed data.
+///
+/// \param[in] batch     : Batch compression context.
+/// \param[in] job       : Batch compression job.
+/// \param[in] j         : Job index.
+/// \param[in] buffer    : I/O buffer of ZIP_IO_BUF_SIZE bytes.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __zip_add_job_compress(zip_add_batch_t* batch, zip_add_job_t* job, LONG j, uint8_t* buffer)
+{
+  int32_t mz_err = MZ_OK;
+
+  OmCString utf8_src;
+  Om_toUTF8(&utf8_src, *job->src);
+
+  void* strm_in = mz_stream_os_create();
+  if(!strm_in) {
+    job->mz_err = MZ_MEM_ERROR;  job->ws_err = L"create stream OS error";
+    return false;
+  }
+
+  mz_err = mz_stream_os_open(strm_in, utf8_src.c_str(), MZ_OPEN_MODE_READ);
+  if(mz_err != MZ_OK) {
+    mz_stream_os_delete(&strm_in);
+    job->mz_err = mz_err;  job->ws_err = L"stream open error";
+    return false;
+  }
+
+  // minizip stores entries written at level zero, data must be stored as
+  // well since it is written raw
+  if(batch->level == 0)
+    job->method = MZ_COMPRESS_METHOD_STORE;
+
+  // sample beginning of file to check whether it is worth compressing
+  if(batch->adapt && job->method != MZ_COMPRESS_METHOD_STORE) {
+
+    int32_t rb = mz_stream_os_read(strm_in, buffer, ZIP_ADAPT_SAMPLE);
+
+    OmCString zcdr_dst;
+    Om_toZipCDR(&zcdr_dst, *job->dst);
+
+    if(rb >= 0 && !__zip_adapt_compress(zcdr_dst.c_str(), buffer, rb)) {
+      job->method = MZ_COMPRESS_METHOD_STORE;
+      job->adapted = true;
+    }
+
+    mz_err = mz_stream_os_seek(strm_in, 0, MZ_SEEK_SET);
+    if(mz_err != MZ_OK) {
+      mz_stream_os_close(strm_in);
+      mz_stream_os_delete(&strm_in);
+      job->mz_err = mz_err;  job->ws_err = L"stream seek error";
+      return false;
+    }
+  }
+
+  // large files are compressed to temporary file to limit memory usage
+  if(job->size > ZIP_SPILL_SIZE) {
+
+    job->spill_path = batch->path;
+    job->spill_path.append("." + std::to_string(j) + ".zc_spill");
+
+    job->strm_out = mz_stream_os_create();
+    if(job->strm_out)
+      mz_err = mz_stream_os_open(job->strm_out, job->spill_path.c_str(), MZ_OPEN_MODE_READWRITE|MZ_OPEN_MODE_CREATE);
+
+  } else {
+
+    job->strm_out = mz_stream_mem_create();
+    if(job->strm_out) {
+      // grow once to avoid reallocations for common cases
+      mz_stream_mem_set_grow_size(job->strm_out, job->size + 65536);
+      mz_err = mz_stream_mem_open(job->strm_out, nullptr, MZ_OPEN_MODE_CREATE);
+    }
+  }
+
+  if(!job->strm_out || mz_err != MZ_OK) {
+    mz_stream_os_close(strm_in);
+    mz_stream_os_delete(&strm_in);
+    job->mz_err = job->strm_out ? mz_err : MZ_MEM_ERROR;  job->ws_err = L"create output stream error";
+    return false;
+  }
+
+  void* strm_cmp = __zip_compress_create(job->method);
+  if(strm_cmp) {
+    mz_stream_set_base(strm_cmp, job->strm_out);
+    mz_stream_set_prop_int64(strm_cmp, MZ_STREAM_PROP_COMPRESS_LEVEL, batch->level);
+    mz_err = mz_stream_open(strm_cmp, nullptr, MZ_OPEN_MODE_WRITE);
+  } else if(job->method != MZ_COMPRESS_METHOD_STORE) {
+    mz_err = MZ_SUPPORT_ERROR;
+  }
+
+  void* strm_wr = strm_cmp ? strm_cmp : job->strm_out;
+
+  uint32_t crc = 0;
+  int64_t tot = 0;
+
+  int32_t wb = 0;
+  int32_t rb = 0;
+
+  while(mz_err == MZ_OK && !batch->abort) {
+    rb = mz_stream_os_read(strm_in, buffer, ZIP_IO_BUF_SIZE);
+    if(rb > 0) {
+        crc = mz_crypt_crc32_update(crc, buffer, rb);
+        tot += rb;
+        wb = mz_stream_write(strm_wr, buffer, rb);
+        if(wb != rb) {
+          mz_err = MZ_WRITE_ERROR;
+          break;
+        }
+    } else if(rb < 0) {
+      mz_err = rb;
+      break;
+    } else {
+      mz_err = MZ_END_OF_STREAM;
+      break;
+    }
+  }
+
+  // close compression stream to flush remaining data
+  if(strm_cmp) {
+    mz_stream_close(strm_cmp);
+    mz_stream_delete(&strm_cmp);
+  }
+
+  mz_stream_os_close(strm_in);
+  mz_stream_os_delete(&strm_in);
+
+  if(mz_err != MZ_OK && mz_err != MZ_END_OF_STREAM) {
+    job->mz_err = mz_err;  job->ws_err = L"stream error";
+    return false;
+  }
+
+  job->crc = crc;
+  job->size = tot;
+  job->comp_size = mz_stream_tell(job->strm_out);
+
+  return true;
+}
+
+/// \brief Batch compression worker
+///
+/// Thread function of batch compression worker, each worker takes jobs
+/// as long as the writer does not lag too much behind.
+///
+/// \param[in] ptr       : Pointer to batch compression context.
+///
+static DWORD WINAPI __zip_add_run_fn(void* ptr)
+{
+  zip_add_batch_t* batch = static_cast<zip_add_batch_t*>(ptr);
+
+  uint8_t* buffer = static_cast<uint8_t*>(Om_alloc(ZIP_IO_BUF_SIZE));
+
+  while(!batch->abort) {
+
+    // wait until writer has room for another job
+    WaitForSingleObject(batch->hwindow, INFINITE);
+    if(batch->abort)
+      break;
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    zip_add_job_t* job = &batch->jobs[j];
+
+    if(job->is_dir) {
+      InterlockedExchange(&job->state, 1);
+    } else if(!buffer) {
+      job->mz_err = MZ_MEM_ERROR;  job->ws_err = L"buffer allocation error";
+      InterlockedExchange(&job->state, 2);
+    } else {
+      InterlockedExchange(&job->state, __zip_add_job_compress(batch, job, j, buffer) ? 1 : 2);
+    }
+
+    SetEvent(batch->hdone);
+  }
+
+  Om_free(buffer);
+
+  return 0;
+}
+
+/// \brief Append compressed job to zip
+///
+/// Writes already compressed data of the given job as new zip entry.
+///
+/// \param[in] zctx      : Zip context opened for writing.
+/// \param[in] job       : Batch compression job.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __zip_add_job_commit(zip_context_t* zctx, zip_add_job_t* job)
+{
+  int32_t mz_err;
+
+  mz_zip_file file_info;
+  memset(&file_info, 0, sizeof(file_info));
+
+  OmCString utf8_src, zcdr_dst;
+
+  Om_toUTF8(&utf8_src, *job->src);
+  Om_toZipCDR(&zcdr_dst, *job->dst);
+
+  file_info.version_madeby = MZ_VERSION_MADEBY;
+  file_info.compression_method = job->method;
+  file_info.filename = zcdr_dst.c_str();
+  file_info.uncompressed_size = job->size;
+  file_info.compressed_size = job->comp_size;
+  file_info.crc = job->crc;
+  file_info.flag = MZ_ZIP_FLAG_UTF8;
+  mz_os_get_file_date(utf8_src.c_str(), &file_info.modified_date, &file_info.accessed_date, &file_info.creation_date);
+  mz_os_get_file_attribs(utf8_src.c_str(), &file_info.external_fa);
+
+  mz_err = mz_zip_entry_write_open(zctx->zip_hnd, &file_info, __zip_raw_level(file_info.compression_method, zctx->cmp_level), 1, nullptr);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry write open error";
+    return false;
+  }
+
+  if(job->adapted) {
+    zctx->adapt_count++;  zctx->adapt_size += job->size;
+  }
+
+  int32_t wb = 0;
+  int32_t rb = 0;
+
+  if(job->spill_path.empty()) {
+
+    const void* data = nullptr;
+    mz_stream_mem_get_buffer(job->strm_out, &data);
+
+    rb = job->comp_size;
+    wb = mz_zip_entry_write(zctx->zip_hnd, data, rb);
+    if(wb != rb) mz_err = MZ_WRITE_ERROR;
+
+  } else {
+
+    mz_err = mz_stream_os_seek(job->strm_out, 0, MZ_SEEK_SET);
+
+    while(mz_err == MZ_OK) {
+      rb = mz_stream_os_read(job->strm_out, zctx->buffer, sizeof(zctx->buffer));
+      if(rb > 0) {
+          wb = mz_zip_entry_write(zctx->zip_hnd, zctx->buffer, rb);
+          if(wb != rb) {
+            mz_err = MZ_WRITE_ERROR;
+            break;
+          }
+      } else if(rb < 0) {
+        mz_err = rb;
+        break;
+      } else {
+        break;
+      }
+    }
+  }
+
+  if(mz_err != MZ_OK) {
+    mz_zip_entry_close(zctx->zip_hnd);
+    zctx->mz_err = mz_err; zctx->ws_err = L"stream error";
+    return false;
+  }
+
+  mz_err = mz_zip_entry_write_close(zctx->zip_hnd, job->crc, job->comp_size, job->size);
+  if(mz_err != MZ_OK) {
+    zctx->mz_err = mz_err; zctx->ws_err = L"entry close error";
+    return false;
+  }
+
+  return true;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -98,10 +1645,13 @@ OmArchive::OmArchive():
   _zctx(nullptr),
   _zent(nullptr),
   _zent_size(0),
+  _zstr(nullptr),
+  _zidx(nullptr),
+  _zidx_mask(0),
   _stat(0)
 {
   // create zip base architecture
-  this->_zctx = calloc(1, sizeof(zip_context_t));
+  this->_zctx = new(std::nothrow) zip_context_t();
 }
 
 
@@ -113,7 +1663,7 @@ OmArchive::~OmArchive()
   this->close();
 
   if(this->_zctx != nullptr) {
-    free(this->_zctx);
+    delete static_cast<zip_context_t*>(this->_zctx);
   }
 }
 
@@ -121,7 +1671,7 @@ OmArchive::~OmArchive()
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmArchive::read(const OmWString& path)
+bool OmArchive::read(const OmWString& path, bool mapped)
 {
   // close and reset interface if any
   this->close();
@@ -131,147 +1681,182 @@ bool OmArchive::read(const OmWString& path)
   // let be it a reader
   this->_stat = ZIP_READER;
 
-  // create zip reader architecture
-  zctx->strm_file = mz_stream_os_create();
-  if(!zctx->strm_file) {
-    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream OS create error";
-    this->close();
-    return false; // MZ_MEM_ERROR;
-  }
-
-  zctx->strm_buff = mz_stream_buffered_create();
-  if(!zctx->strm_buff) {
-    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream buffered create error";
-    this->close();
-    return false; // MZ_MEM_ERROR;
-  }
+  OmCString utf8_path;
+  Om_toUTF8(&utf8_path, path);
 
-  zctx->strm_splt = mz_stream_split_create();
-  if(!zctx->strm_splt) {
-    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"stream split create error";
-    this->close();
-    return false; // MZ_MEM_ERROR;
+  if(!__zip_reader_open(zctx, utf8_path.c_str(), mapped)) {
+    this->_stat = 0;
+    return false;
   }
 
-  mz_stream_set_base(zctx->strm_buff, zctx->strm_file);
-  mz_stream_set_base(zctx->strm_splt, zctx->strm_buff);
-
-  zctx->zip_hnd = mz_zip_create();
-  if(!zctx->zip_hnd) {
-    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"zip handle create error";
-    this->close();
-    return false; // MZ_MEM_ERROR;
-  }
+  // keep path to allow additional readers
+  zctx->path = utf8_path;
 
   int32_t mz_err = MZ_OK;
 
-  OmCString utf8_path;
-  Om_toUTF8(&utf8_path, path);
+  // allocate local zip central directory mirror
+  mz_zip_get_number_entry(zctx->zip_hnd, &this->_zent_size);
 
-  mz_err = mz_stream_open(zctx->strm_splt, utf8_path.c_str(), MZ_OPEN_MODE_READ);
-  if(mz_err != MZ_OK) {
+  this->_zent = Om_alloc(this->_zent_size * sizeof(zip_entry_t));
+  if(!this->_zent) {
     this->close();
-    zctx->mz_err = mz_err; zctx->ws_err = L"file stream open error";
+    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"mirror central-directory error";
     return false;
   }
 
-  // mz_zip_reader_open
-  mz_err = mz_zip_open(zctx->zip_hnd, zctx->strm_splt, MZ_OPEN_MODE_READ);
-  if(mz_err != MZ_OK) {
+  Om_memset(this->_zent, 0, this->_zent_size * sizeof(zip_entry_t));
+
+  // allocate string pool for entries path, grown as required
+  size_t zstr_cap = (this->_zent_size + 1) * ZIP_STR_POOL_INIT;
+  size_t zstr_len = 0;
+
+  this->_zstr = Om_alloc(zstr_cap * sizeof(wchar_t));
+  if(!this->_zstr) {
     this->close();
-    zctx->mz_err = mz_err;  zctx->ws_err = L"zip file open error";
+    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"mirror central-directory error";
     return false;
   }
 
-  // mz_zip_reader_unzip_cd
-  mz_zip_file *cd_info = nullptr;
+  zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
 
-  // check weather zip central directory is simple or zipped
-  mz_err = mz_zip_goto_first_entry(zctx->zip_hnd);
-  if(mz_err == MZ_OK)
-    mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &cd_info);
+  mz_zip_file *file_info = nullptr;
 
-  if(mz_err != MZ_OK) {
-    this->close();
-    zctx->mz_err = mz_err;  zctx->ws_err = L"central directory parse error";
-    return false;
-  }
+  do {
+    mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
+    if(mz_err != MZ_OK) break;
 
-  // Check whether this is a compressed central directory
-  if(strcmp(cd_info->filename, "__cdcd__") == 0) {
+    zent->offset = mz_zip_get_entry(zctx->zip_hnd);
+    zent->method = file_info->compression_method;
+    zent->is_dir = (mz_zip_entry_is_dir(zctx->zip_hnd) == MZ_OK);
+    zent->file_size = file_info->uncompressed_size;
+    zent->crc = file_info->crc;
+    zent->disk_offset = file_info->disk_offset;
 
-    // Unzip the central directory
+    // get UTF-16 filename length, including null char
+    int32_t n = MultiByteToWideChar(CP_UTF8, 0, file_info->filename, -1, nullptr, 0);
+    if(n < 1) n = 1;
 
-    uint64_t number_entry = 0;
+    // grow string pool if needed
+    if(zstr_len + n > zstr_cap) {
 
-    // Try to open entry for reading
-    if(mz_zip_entry_is_open(zctx->zip_hnd) != MZ_OK) {
-      // if open fail zip file may be encrypted, we do not support it
-      if(cd_info->flag & MZ_ZIP_FLAG_ENCRYPTED) {
+      while(zstr_len + n > zstr_cap)
+        zstr_cap *= 2;
+
+      void* zstr = Om_realloc(this->_zstr, zstr_cap * sizeof(wchar_t));
+      if(!zstr) {
         this->close();
-        zctx->mz_err = MZ_PASSWORD_ERROR;  zctx->ws_err = L"zip file is password protected";
+        zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"mirror central-directory error";
         return false;
       }
+
+      this->_zstr = zstr;
     }
 
-    void *file_extra_stream = nullptr;
+    wchar_t* file_path = static_cast<wchar_t*>(this->_zstr) + zstr_len;
 
-    file_extra_stream = mz_stream_mem_create();
-    if(!file_extra_stream) {
-      this->close();
-      zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"central directory unzip error";
-      return false;
-    }
+    // convert filename UTF-8 to UTF-16
+    file_path[0] = 0;
+    MultiByteToWideChar(CP_UTF8, 0, file_info->filename, -1, file_path, n);
+    // replace slash by back-slash
+    for(size_t i = 0; file_path[i] != 0; ++i)
+      if(file_path[i] == L'/') file_path[i] = L'\\';
 
-    mz_stream_mem_set_buffer(file_extra_stream, (void*)cd_info->extrafield, cd_info->extrafield_size);
-    mz_err = mz_zip_extrafield_find(file_extra_stream, 0xcdcd, INT32_MAX, nullptr);
-    if(mz_err == MZ_OK)
-      mz_err = mz_stream_read_uint64(file_extra_stream, &number_entry);
-    mz_stream_mem_delete(&file_extra_stream);
+    zent->path_off = zstr_len;
+    zent->path_len = n - 1;
 
-    if(mz_err != MZ_OK) {
-      this->close();
-      zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"central directory unzip error";
-      return false;
-    }
+    zstr_len += n;
 
-    void *cd_mem_stream = nullptr;
+    // next entry
+    zent++;
 
-    mz_zip_get_cd_mem_stream(zctx->zip_hnd, &cd_mem_stream);
-    if(mz_stream_mem_is_open(cd_mem_stream) != MZ_OK)
-        mz_stream_mem_open(cd_mem_stream, nullptr, MZ_OPEN_MODE_CREATE);
+    if(mz_zip_entry_is_open(zctx->zip_hnd) == MZ_OK)
+      mz_zip_entry_close(zctx->zip_hnd);
 
-    mz_err = mz_stream_seek(cd_mem_stream, 0, MZ_SEEK_SET);
-    if(mz_err == MZ_OK)
-      //mz_err = mz_stream_copy_stream(cd_mem_stream, nullptr, handle, mz_zip_reader_entry_read, (int32_t)cd_info->uncompressed_size);
-      mz_stream_copy_stream(cd_mem_stream, nullptr, zctx->zip_hnd, mz_zip_entry_read, (int32_t)cd_info->uncompressed_size);
+    mz_err = mz_zip_goto_next_entry(zctx->zip_hnd);
+    if(mz_err != MZ_OK && mz_err != MZ_END_OF_LIST)
+      break;
 
-    if(mz_err == MZ_OK) {
-      mz_zip_set_cd_stream(zctx->zip_hnd, 0, cd_mem_stream);
-      mz_zip_set_number_entry(zctx->zip_hnd, number_entry);
-    }
-  }
+  } while(mz_err == MZ_OK);
 
-  mz_err = mz_zip_goto_first_entry(zctx->zip_hnd);
-  if(mz_err != MZ_OK) {
+  if(mz_err != MZ_OK && mz_err != MZ_END_OF_LIST) {
     this->close();
-    zctx->mz_err = mz_err;  zctx->ws_err = L"central-directory unzip error";
+    zctx->mz_err = mz_err;  zctx->ws_err = L"central directory walk error";
     return false;
   }
 
-  // allocate local zip central directory mirror
-  mz_zip_get_number_entry(zctx->zip_hnd, &this->_zent_size);
+  // shrink string pool to its actual size
+  if(zstr_len < zstr_cap) {
+    void* zstr = Om_realloc(this->_zstr, (zstr_len + 1) * sizeof(wchar_t));
+    if(zstr) this->_zstr = zstr;
+  }
 
-  this->_zent = Om_alloc(this->_zent_size * sizeof(zip_entry_t));
-  if(!this->_zent) {
+  // build case-insensitive hash index of central-directory mirror, table size
+  // is the power of two at least twice the entry count to keep probes short
+  size_t zidx_size = 16;
+  while(zidx_size < this->_zent_size * 2)
+    zidx_size <<= 1;
+
+  this->_zidx = Om_alloc(zidx_size * sizeof(uint32_t));
+  if(!this->_zidx) {
     this->close();
-    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"mirror central-directory error";
+    zctx->mz_err = MZ_MEM_ERROR; zctx->ws_err = L"central-directory index error";
     return false;
   }
 
-  Om_memset(this->_zent, 0, this->_zent_size * sizeof(zip_entry_t));
+  // slots store entry index plus one, zero means empty
+  Om_memset(this->_zidx, 0, zidx_size * sizeof(uint32_t));
+  this->_zidx_mask = zidx_size - 1;
 
-  zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+  uint32_t* zidx = static_cast<uint32_t*>(this->_zidx);
+  wchar_t* zstr = static_cast<wchar_t*>(this->_zstr);
+  zent = static_cast<zip_entry_t*>(this->_zent);
+
+  for(size_t i = 0; i < this->_zent_size; ++i) {
+
+    uint32_t h = __zip_path_hash(zstr + zent[i].path_off, zent[i].path_len);
+
+    // linear probing, first inserted entry is found first in case of
+    // duplicated names, as with former linear search
+    size_t s = h & this->_zidx_mask;
+    while(zidx[s] != 0)
+      s = (s + 1) & this->_zidx_mask;
+
+    zidx[s] = i + 1;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::probe(const OmWString& path, const wchar_t* ext, const wchar_t* name, OmCString* data, OmWString* entry)
+{
+  // close and reset interface if any
+  this->close();
+
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+  // let be it a reader
+  this->_stat = ZIP_READER;
+
+  OmCString utf8_path;
+  Om_toUTF8(&utf8_path, path);
+
+  if(!__zip_reader_open(zctx, utf8_path.c_str(), true)) {
+    this->_stat = 0;
+    return false;
+  }
+
+  OmCString utf8_ext, utf8_name;
+  if(ext) Om_toUTF8(&utf8_ext, ext);
+  if(name) Om_toUTF8(&utf8_name, name);
+
+  int32_t mz_err = MZ_OK;
+
+  // walk central directory, the last matching entry is kept since
+  // definition file is usually the last added to archive
+  int64_t found = -1;
 
   mz_zip_file *file_info = nullptr;
 
@@ -279,21 +1864,21 @@ bool OmArchive::read(const OmWString& path)
     mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
     if(mz_err != MZ_OK) break;
 
-    zent->offset = mz_zip_get_entry(zctx->zip_hnd);
-    zent->method = file_info->compression_method;
-    zent->is_dir = (mz_zip_entry_is_dir(zctx->zip_hnd) == MZ_OK);
-    zent->file_size = file_info->uncompressed_size;
-    // convert filename UTF-8 to UTF-16
-    MultiByteToWideChar(CP_UTF8, 0, file_info->filename, -1, zent->file_path, OM_MAX_PATH);
-    // replace slash by back-slash
-    for(size_t i = 0; zent->file_path[i] != 0; ++i)
-      if(zent->file_path[i] == L'/') zent->file_path[i] = L'\\';
+    size_t len = file_info->filename_size;
+    const char* file_name = file_info->filename;
 
-    // next entry
-    zent++;
+    bool match = false;
 
-    if(mz_zip_entry_is_open(zctx->zip_hnd) == MZ_OK)
-      mz_zip_entry_close(zctx->zip_hnd);
+    if(!utf8_name.empty() && len == utf8_name.size())
+      match = __zip_probe_match(file_name, utf8_name.c_str(), len);
+
+    if(!match && !utf8_ext.empty() && len > utf8_ext.size()) {
+      size_t d = len - utf8_ext.size();
+      if(file_name[d - 1] == '.')
+        match = __zip_probe_match(file_name + d, utf8_ext.c_str(), utf8_ext.size());
+    }
+
+    if(match) found = mz_zip_get_entry(zctx->zip_hnd);
 
     mz_err = mz_zip_goto_next_entry(zctx->zip_hnd);
     if(mz_err != MZ_OK && mz_err != MZ_END_OF_LIST)
@@ -307,17 +1892,73 @@ bool OmArchive::read(const OmWString& path)
     return false;
   }
 
+  if(found < 0) {
+    this->close();
+    zctx->mz_err = MZ_EXIST_ERROR;  zctx->ws_err = L"entry not found";
+    return false;
+  }
+
+  mz_err = mz_zip_goto_entry(zctx->zip_hnd, found);
+  if(mz_err == MZ_OK)
+    mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
+
+  if(mz_err != MZ_OK) {
+    this->close();
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry goto error";
+    return false;
+  }
+
+  if(file_info->uncompressed_size > INT32_MAX) {
+    this->close();
+    zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"file too large";
+    return false;
+  }
+
+  if(entry) {
+    Om_toUTF16(entry, file_info->filename);
+    std::replace(entry->begin(), entry->end(), L'/', L'\\');
+  }
+
+  data->resize(file_info->uncompressed_size);
+
+  mz_err = mz_zip_entry_read_open(zctx->zip_hnd, 0, nullptr);
+  if(mz_err != MZ_OK) {
+    this->close();
+    zctx->mz_err = mz_err;  zctx->ws_err = L"entry read open error";
+    return false;
+  }
+
+  int32_t tot = 0;
+
+  while(tot < static_cast<int32_t>(data->size())) {
+    int32_t rb = mz_zip_entry_read(zctx->zip_hnd, &(*data)[tot], data->size() - tot);
+    if(rb <= 0) {
+      mz_err = rb < 0 ? rb : MZ_END_OF_STREAM;
+      break;
+    }
+    tot += rb;
+  }
+
+  mz_zip_entry_close(zctx->zip_hnd);
+
+  this->close();
+
+  if(tot != static_cast<int32_t>(data->size())) {
+    zctx->mz_err = mz_err; zctx->ws_err = L"stream error";
+    return false;
+  }
+
   return true;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-const wchar_t* OmArchive::entryPath(size_t i) const
+const wchar_t* OmArchive::entryPath(size_t i) const
 {
   if(i < this->_zent_size)
-    return static_cast<zip_entry_t*>(this->_zent)[i].file_path;
-
+    return static_cast<wchar_t*>(this->_zstr) + static_cast<zip_entry_t*>(this->_zent)[i].path_off;
+
   return nullptr;
 }
 
@@ -326,8 +1967,10 @@ const wchar_t* OmArchive::entryPath(size_t i) const
 ///
 void OmArchive::entryPath(size_t i, OmWString& path) const
 {
-  if(i < this->_zent_size)
-    path = static_cast<zip_entry_t*>(this->_zent)[i].file_path;
+  if(i < this->_zent_size) {
+    zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+    path.assign(static_cast<wchar_t*>(this->_zstr) + zent[i].path_off, zent[i].path_len);
+  }
 }
 
 ///
@@ -344,170 +1987,222 @@ uint64_t OmArchive::entrySize(size_t i) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmArchive::entryIsDir(size_t i) const
+uint32_t OmArchive::entryCrc(size_t i) const
+{
+  if(i < this->_zent_size)
+    return static_cast<zip_entry_t*>(this->_zent)[i].crc;
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entryIsDir(size_t i) const
 {
   if(i < this->_zent_size)
     return static_cast<zip_entry_t*>(this->_zent)[i].is_dir;
 
   return false;
 }
-
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-int32_t OmArchive::entryMethod(size_t i) const
-{
-  if(i < this->_zent_size)
-    return static_cast<zip_entry_t*>(this->_zent)[i].method;
-
-  return -1;
-}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmArchive::entryMethod(size_t i) const
+{
+  if(i < this->_zent_size)
+    return static_cast<zip_entry_t*>(this->_zent)[i].method;
+
+  return -1;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entrySave(size_t i, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
+{
+  if(this->_stat & ZIP_READER) {
+
+    // TODO: remove this once most people migrated to this new version
+    if(i > this->_zent_size)
+      return true; //< fail silently
+
+    zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+
+    return __zip_entry_save(static_cast<zip_context_t*>(this->_zctx), zent[i].offset, dst, this->entryPath(i), progress_cb, user_ptr);
+  }
+
+  return false;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entrySave(const OmWString& entry, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
+{
+  uint32_t i = this->entryLocate(entry);
+
+  if(i != static_cast<uint32_t>(-1))
+    return this->entrySave(i, dst, progress_cb, user_ptr);
+
+  return false;
+}
+
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmArchive::entrySave(size_t i, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
+bool OmArchive::entrySaveMany(const OmIndexArray& indices, const OmWStringArray& dests, uint32_t threads, Om_progressCb progress_cb, void* user_ptr, uint8_t* saved) const
 {
-  int32_t mz_err;
+  if(!(this->_stat & ZIP_READER))
+    return false;
 
-  if(this->_stat & ZIP_READER) {
-
-    // TODO: remove this once most people migrated to this new version
-    if(i > this->_zent_size)
-      return true; //< fail silently
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+  zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
 
-    zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
-    zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+  if(indices.size() != dests.size()) {
+    zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"indices and destinations mismatch";
+    return false;
+  }
 
-    mz_err = mz_zip_goto_entry(zctx->zip_hnd, zent[i].offset);
-    if(mz_err != MZ_OK) {
-      zctx->mz_err = mz_err;  zctx->ws_err = L"entry goto error";
-      return false;
-    }
+  if(saved)
+    memset(saved, 0, indices.size());
 
-    // get zipped file info
-    mz_zip_file *file_info = nullptr;
-    mz_err = mz_zip_entry_get_info(zctx->zip_hnd, &file_info);
+  // build jobs list, sorted by local header offset
+  std::vector<zip_save_job_t> jobs;
+  jobs.reserve(indices.size());
 
-    // check whether zip entry is a directory
-    if( (mz_zip_entry_is_dir(zctx->zip_hnd) == MZ_OK) &&
-        (mz_zip_entry_is_symlink(zctx->zip_hnd) != MZ_OK)) {
+  for(size_t k = 0; k < indices.size(); ++k) {
 
-      if(!Om_isDir(dst)) {
-        // we simply create directory
-        mz_err = Om_dirCreateRecursive(dst);
-        if(mz_err != ERROR_SUCCESS) {
-          zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
-          return false;
-        }
-      }
+    size_t i = indices[k];
 
-      return true;
-    }
+    // TODO: remove this once most people migrated to this new version
+    if(i >= this->_zent_size)
+      continue; //< fail silently
 
-    // TODO: implement symlink creation
+    zip_save_job_t job;
+    job.offset = zent[i].offset;
+    job.disk_offset = zent[i].disk_offset;
+    job.name = this->entryPath(i);
+    job.dest = &dests[k];
+    job.index = k;
 
-    OmWString dst_dir = Om_getDirPart(dst);
+    jobs.push_back(job);
+  }
 
-    // create the destination path tree if required
-    if(!Om_isDir(dst_dir)) {
-      // we simply create directory
-      mz_err = Om_dirCreateRecursive(dst_dir);
-      if(mz_err != ERROR_SUCCESS) {
-        zctx->mz_err = mz_err;  zctx->ws_err = L"create directory error";
-        return false;
-      }
-    }
+  std::sort(jobs.begin(), jobs.end(), __zip_save_job_compare);
 
-    // Create the file on disk so we can save to it
-    void *stream = mz_stream_os_create();
-    if(!stream) {
-      zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"create stream OS error";
-      return false;
-    }
+  // get count of workers to run
+  if(threads == 0) {
+    SYSTEM_INFO sys_info;
+    GetSystemInfo(&sys_info);
+    threads = sys_info.dwNumberOfProcessors;
+  }
 
-    OmCString utf8_dst;
-    Om_toUTF8(&utf8_dst, dst);
+  if(threads > ZIP_MAX_THREADS)
+    threads = ZIP_MAX_THREADS;
 
-    mz_err = mz_stream_os_open(stream, utf8_dst.c_str(), MZ_OPEN_MODE_CREATE);
+  if(threads > jobs.size())
+    threads = jobs.size();
 
-    if(mz_err == MZ_OK) {
+  // single thread, we simply use this reader
+  if(threads <= 1) {
 
-      // If the entry isn't open for reading, open it
-      if(mz_zip_entry_is_open(zctx->zip_hnd) != MZ_OK)
-        mz_err = mz_zip_entry_read_open(zctx->zip_hnd, 0, nullptr);
+    for(size_t j = 0; j < jobs.size(); ++j) {
 
-      if(mz_err != MZ_OK) {
-        zctx->mz_err = mz_err;  zctx->ws_err = L"entry read open error";
+      if(!__zip_entry_save(zctx, jobs[j].offset, *jobs[j].dest, jobs[j].name, nullptr, nullptr)) {
+        zctx->ws_err += L" \"" + *jobs[j].dest + L"\"";
         return false;
       }
 
-      int32_t wb = 0;
-      int32_t rb = 0;
+      if(saved)
+        saved[jobs[j].index] = 1;
 
-      // Write data to stream until done
-      while(mz_err == MZ_OK) {
-        rb = mz_zip_entry_read(zctx->zip_hnd, zctx->buffer, sizeof(zctx->buffer));
-        if(rb > 0) {
-            wb = mz_stream_write(stream, zctx->buffer, rb);
-            if(wb != rb) {
-              mz_err = MZ_WRITE_ERROR;
-              break;
-            }
-        } else if(rb < 0) {
-          mz_err = rb;
-          break;
-        } else {
-          mz_err = MZ_END_OF_STREAM;
-          break;
-        }
-        if(progress_cb) {
-          progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(zent[i].file_path));
+      if(progress_cb) {
+        if(!progress_cb(user_ptr, jobs.size(), j + 1, reinterpret_cast<uint64_t>(jobs[j].name))) {
+          zctx->mz_err = MZ_OK;  zctx->ws_err = L"extraction aborted";
+          return false;
         }
       }
-      mz_zip_entry_close(zctx->zip_hnd);
     }
 
-    mz_stream_close(stream);
-    mz_stream_delete(&stream);
+    return true;
+  }
 
-    if(mz_err != MZ_OK && mz_err != MZ_END_OF_STREAM ) {
-      zctx->mz_err = mz_err; zctx->ws_err = L"file stream error";
-      return false;
-    }
+  zip_save_batch_t batch;
+  batch.path = zctx->path.c_str();
+  batch.mapped = (zctx->strm_map != nullptr);
+  batch.jobs = jobs.data();
+  batch.jobs_count = jobs.size();
+  batch.jobs_next = 0;
+  batch.jobs_done = 0;
+  batch.jobs_last = 0;
+  batch.abort = 0;
+  batch.saved = saved;
+  batch.mz_err = MZ_OK;
+
+  InitializeCriticalSection(&batch.lock);
+
+  HANDLE hthreads[ZIP_MAX_THREADS];
+  DWORD hthreads_count = 0;
+
+  for(uint32_t t = 0; t < threads; ++t) {
+    HANDLE hth = Om_threadCreate(__zip_save_run_fn, &batch);
+    if(hth) hthreads[hthreads_count++] = hth;
+  }
+
+  if(hthreads_count == 0) {
+    DeleteCriticalSection(&batch.lock);
+    zctx->mz_err = MZ_INTERNAL_ERROR;  zctx->ws_err = L"worker thread create error";
+    return false;
+  }
 
-    // Set the time of the file that has been created
-    mz_os_set_file_date(utf8_dst.c_str(), file_info->modified_date, file_info->accessed_date, file_info->creation_date);
+  // wait for workers, progression callback is called from this thread
+  LONG jobs_done = 0;
+  bool has_abort = false;
 
-    uint32_t target_attrib = 0;
+  while(true) {
 
-    // Set file attributes for the correct system
-    int32_t err_attrib = mz_zip_attrib_convert(MZ_HOST_SYSTEM(file_info->version_madeby),
-      file_info->external_fa, MZ_VERSION_MADEBY_HOST_SYSTEM, &target_attrib);
+    DWORD result = WaitForMultipleObjects(hthreads_count, hthreads, TRUE, ZIP_POLL_DELAY);
 
-    if(err_attrib == MZ_OK)
-      mz_os_set_file_attribs(utf8_dst.c_str(), file_info->external_fa);
+    if(result == WAIT_FAILED) {
+      // workers use this stack context, they must end before we return
+      __zip_save_fail(&batch, MZ_INTERNAL_ERROR, L"worker thread wait error");
+      for(DWORD t = 0; t < hthreads_count; ++t)
+        WaitForSingleObject(hthreads[t], INFINITE);
+      break;
+    }
 
-    return true;
+    if(progress_cb && !has_abort && batch.jobs_done != jobs_done) {
+      jobs_done = batch.jobs_done;
+      if(!progress_cb(user_ptr, jobs.size(), jobs_done, reinterpret_cast<uint64_t>(jobs[batch.jobs_last].name))) {
+        InterlockedExchange(&batch.abort, 1);
+        has_abort = true;
+      }
+    }
+
+    if(result != WAIT_TIMEOUT)
+      break;
   }
 
-  return false;
-}
+  for(DWORD t = 0; t < hthreads_count; ++t)
+    CloseHandle(hthreads[t]);
 
+  DeleteCriticalSection(&batch.lock);
 
-///
-///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
-///
-bool OmArchive::entrySave(const OmWString& entry, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
-{
-  zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+  if(batch.mz_err != MZ_OK) {
+    zctx->mz_err = batch.mz_err;  zctx->ws_err = batch.ws_err;
+    return false;
+  }
 
-  for(uint64_t i = 0; i < this->_zent_size; ++i) {
-    if(Om_namesMatches(zent[i].file_path, entry))
-      return this->entrySave(i, dst, progress_cb, user_ptr);
+  if(has_abort) {
+    zctx->mz_err = MZ_OK;  zctx->ws_err = L"extraction aborted";
+    return false;
   }
 
-  return false;
+  return true;
 }
 
 
@@ -561,12 +2256,30 @@ bool OmArchive::entrySave(size_t i, void* buffer, Om_progressCb progress_cb, voi
 
       if(mz_err != MZ_OK) {
         zctx->mz_err = mz_err;  zctx->ws_err = L"entry read open error";
+        mz_stream_mem_delete(&stream);
         return false;
       }
 
       int32_t wb = 0;
       int32_t rb = 0;
 
+      // stored entry within mapped file is copied directly from view
+      const uint8_t* data = __zip_map_entry_data(zctx, file_info);
+      if(data) {
+
+        rb = file_info->uncompressed_size;
+        if(mz_crypt_crc32_update(0, data, rb) == file_info->crc) {
+          wb = mz_stream_mem_write(stream, data, rb);
+          mz_err = (wb == rb) ? MZ_END_OF_STREAM : MZ_WRITE_ERROR;
+        } else {
+          mz_err = MZ_CRC_ERROR;
+        }
+
+        if(progress_cb) {
+          progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(this->entryPath(i)));
+        }
+      }
+
       // Write data to stream until done
       while(mz_err == MZ_OK) {
         rb = mz_zip_entry_read(zctx->zip_hnd, zctx->buffer, sizeof(zctx->buffer));
@@ -585,7 +2298,7 @@ bool OmArchive::entrySave(size_t i, void* buffer, Om_progressCb progress_cb, voi
         }
 
         if(progress_cb) {
-          progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(zent[i].file_path));
+          progress_cb(user_ptr, file_info->uncompressed_size, wb, reinterpret_cast<uint64_t>(this->entryPath(i)));
         }
       }
 
@@ -609,7 +2322,7 @@ bool OmArchive::entrySave(size_t i, void* buffer, Om_progressCb progress_cb, voi
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmArchive::write(const OmWString& path, int32_t method, int32_t level)
+bool OmArchive::write(const OmWString& path, int32_t method, int32_t level, bool adaptive)
 {
   // close and reset interface if any
   this->close();
@@ -672,10 +2385,16 @@ bool OmArchive::write(const OmWString& path, int32_t method, int32_t level)
 
   zctx->cmp_level = level;
   zctx->cmp_method = method;
+  zctx->cmp_adapt = adaptive;
+  zctx->adapt_count = 0;
+  zctx->adapt_size = 0;
 
   OmCString utf8_path;
   Om_toUTF8(&utf8_path, path);
 
+  // keep path to create temporary files next to zip
+  zctx->path = utf8_path;
+
   mz_err = mz_stream_open(zctx->strm_splt, utf8_path.c_str(), mode);
   if(mz_err != MZ_OK) {
     this->close();
@@ -738,6 +2457,25 @@ bool OmArchive::entryAdd(const OmWString& src, const OmWString& dst, Om_progress
         zctx->mz_err = MZ_MEM_ERROR;  zctx->ws_err = L"stream open error";
         return false;
       }
+
+      // sample beginning of file to check whether it is worth compressing
+      if(zctx->cmp_adapt && file_info.compression_method != MZ_COMPRESS_METHOD_STORE) {
+
+        int32_t rb = mz_stream_os_read(stream, zctx->buffer, ZIP_ADAPT_SAMPLE);
+
+        if(rb >= 0 && !__zip_adapt_compress(zcdr_dst.c_str(), zctx->buffer, rb)) {
+          file_info.compression_method = MZ_COMPRESS_METHOD_STORE;
+          zctx->adapt_count++;  zctx->adapt_size += file_info.uncompressed_size;
+        }
+
+        mz_err = mz_stream_os_seek(stream, 0, MZ_SEEK_SET);
+        if(mz_err != MZ_OK) {
+          zctx->mz_err = mz_err;  zctx->ws_err = L"stream seek error";
+          mz_stream_close(stream);
+          mz_stream_delete(&stream);
+          return false;
+        }
+      }
     }
 
     // Add to zip
@@ -842,6 +2580,15 @@ bool OmArchive::entryAdd(const void* data, uint64_t size, const OmWString& dst,
       file_info.external_fa = 0x10; // FILE_ATTRIBUTE_DIRECTORY
     }
 
+    // check whether data is worth compressing
+    if(zctx->cmp_adapt && size > 0 && file_info.compression_method != MZ_COMPRESS_METHOD_STORE) {
+      size_t sample = size > ZIP_ADAPT_SAMPLE ? ZIP_ADAPT_SAMPLE : size;
+      if(!__zip_adapt_compress(zcdr_dst.c_str(), static_cast<const uint8_t*>(data), sample)) {
+        file_info.compression_method = MZ_COMPRESS_METHOD_STORE;
+        zctx->adapt_count++;  zctx->adapt_size += size;
+      }
+    }
+
     // Create a memory stream backed by our buffer and add from it
     void *stream = nullptr;
 
@@ -925,16 +2672,235 @@ bool OmArchive::entryAdd(const void* data, uint64_t size, const OmWString& dst,
 }
 
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entryAddMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads, Om_progressCb progress_cb, void* user_ptr) const
+{
+  if(!(this->_stat & ZIP_WRITER))
+    return false;
+
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+  if(srcs.size() != dsts.size()) {
+    zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"sources and destinations mismatch";
+    return false;
+  }
+
+  if(srcs.empty())
+    return true;
+
+  // build jobs list, in the order entries will be written
+  std::vector<zip_add_job_t> jobs(srcs.size());
+
+  for(size_t k = 0; k < srcs.size(); ++k) {
+    jobs[k].src = &srcs[k];
+    jobs[k].dst = &dsts[k];
+    jobs[k].is_dir = Om_isDir(srcs[k]);
+    jobs[k].method = zctx->cmp_method;
+    jobs[k].adapted = false;
+    jobs[k].size = jobs[k].is_dir ? 0 : Om_itemSize(srcs[k]);
+    jobs[k].crc = 0;
+    jobs[k].comp_size = 0;
+    jobs[k].strm_out = nullptr;
+    jobs[k].state = 0;
+    jobs[k].mz_err = MZ_OK;
+  }
+
+  // get count of workers to run
+  if(threads == 0) {
+    SYSTEM_INFO sys_info;
+    GetSystemInfo(&sys_info);
+    threads = sys_info.dwNumberOfProcessors;
+  }
+
+  if(threads > ZIP_MAX_THREADS)
+    threads = ZIP_MAX_THREADS;
+
+  if(threads > jobs.size())
+    threads = jobs.size();
+
+  // single thread, we simply add entries one by one
+  if(threads <= 1) {
+
+    for(size_t k = 0; k < jobs.size(); ++k) {
+
+      if(!this->entryAdd(srcs[k], dsts[k]))
+        return false;
+
+      if(progress_cb) {
+        if(!progress_cb(user_ptr, jobs.size(), k + 1, reinterpret_cast<uint64_t>(dsts[k].c_str()))) {
+          zctx->mz_err = MZ_OK;  zctx->ws_err = L"compression aborted";
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  zip_add_batch_t batch;
+  batch.path = zctx->path.c_str();
+  batch.method = zctx->cmp_method;
+  batch.level = zctx->cmp_level;
+  batch.adapt = zctx->cmp_adapt;
+  batch.jobs = jobs.data();
+  batch.jobs_count = jobs.size();
+  batch.jobs_next = 0;
+  batch.abort = 0;
+
+  // workers may run ahead of the writer by two jobs each
+  LONG window = threads * 2;
+
+  batch.hwindow = CreateSemaphoreW(nullptr, window, window + threads, nullptr);
+  batch.hdone = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+  HANDLE hthreads[ZIP_MAX_THREADS];
+  DWORD hthreads_count = 0;
+
+  if(batch.hwindow && batch.hdone) {
+    for(uint32_t t = 0; t < threads; ++t) {
+      HANDLE hth = Om_threadCreate(__zip_add_run_fn, &batch);
+      if(hth) hthreads[hthreads_count++] = hth;
+    }
+  }
+
+  bool has_error = (hthreads_count == 0);
+  bool has_abort = false;
+
+  if(has_error) {
+    zctx->mz_err = MZ_INTERNAL_ERROR;  zctx->ws_err = L"worker thread create error";
+  }
+
+  // append compressed entries in order as they become available
+  for(size_t k = 0; k < jobs.size() && !has_error; ++k) {
+
+    zip_add_job_t* job = &jobs[k];
+
+    while(job->state == 0)
+      WaitForSingleObject(batch.hdone, ZIP_POLL_DELAY);
+
+    if(job->state == 2) {
+      zctx->mz_err = job->mz_err;  zctx->ws_err = job->ws_err + L" \"" + *job->src + L"\"";
+      has_error = true; break;
+    }
+
+    if(job->is_dir) {
+      if(!this->entryAdd(*job->src, *job->dst)) {
+        has_error = true; break;
+      }
+    } else {
+      if(!__zip_add_job_commit(zctx, job)) {
+        zctx->ws_err += L" \"" + *job->dst + L"\"";
+        has_error = true; break;
+      }
+    }
+
+    __zip_add_job_clear(job);
+
+    // allow workers to process another job
+    ReleaseSemaphore(batch.hwindow, 1, nullptr);
+
+    if(progress_cb) {
+      if(!progress_cb(user_ptr, jobs.size(), k + 1, reinterpret_cast<uint64_t>(job->dst->c_str()))) {
+        has_abort = true; break;
+      }
+    }
+  }
+
+  // stop and wait for workers
+  if(has_error || has_abort) {
+    InterlockedExchange(&batch.abort, 1);
+    ReleaseSemaphore(batch.hwindow, threads, nullptr);
+  }
+
+  if(hthreads_count)
+    WaitForMultipleObjects(hthreads_count, hthreads, TRUE, INFINITE);
+
+  for(DWORD t = 0; t < hthreads_count; ++t)
+    CloseHandle(hthreads[t]);
+
+  if(batch.hwindow) CloseHandle(batch.hwindow);
+  if(batch.hdone) CloseHandle(batch.hdone);
+
+  // release resources of remaining jobs
+  for(size_t k = 0; k < jobs.size(); ++k)
+    __zip_add_job_clear(&jobs[k]);
+
+  if(has_abort) {
+    zctx->mz_err = MZ_OK;  zctx->ws_err = L"compression aborted";
+    return false;
+  }
+
+  return !has_error;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entryCopyRaw(const OmArchive& src, size_t i, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
+{
+  if((this->_stat & ZIP_WRITER) && (src._stat & ZIP_READER)) {
+
+    zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+    if(i >= src._zent_size) {
+      zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"source entry index out of range";
+      return false;
+    }
+
+    zip_entry_t* src_zent = static_cast<zip_entry_t*>(src._zent);
+
+    return __zip_entry_copy(zctx, static_cast<zip_context_t*>(src._zctx), src_zent[i].offset, dst, true, progress_cb, user_ptr);
+  }
+
+  return false;
+}
+
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmArchive::entryCopy(const OmArchive& src, size_t i, const OmWString& dst, Om_progressCb progress_cb, void* user_ptr) const
+{
+  if((this->_stat & ZIP_WRITER) && (src._stat & ZIP_READER)) {
+
+    zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+    if(i >= src._zent_size) {
+      zctx->mz_err = MZ_PARAM_ERROR;  zctx->ws_err = L"source entry index out of range";
+      return false;
+    }
+
+    zip_entry_t* src_zent = static_cast<zip_entry_t*>(src._zent);
+
+    return __zip_entry_copy(zctx, static_cast<zip_context_t*>(src._zctx), src_zent[i].offset, dst, false, progress_cb, user_ptr);
+  }
+
+  return false;
+}
+
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 uint32_t OmArchive::entryLocate(const OmWString& entry) const
 {
+  if(!this->_zidx)
+    return -1;
+
   zip_entry_t* zent = static_cast<zip_entry_t*>(this->_zent);
+  wchar_t* zstr = static_cast<wchar_t*>(this->_zstr);
+  uint32_t* zidx = static_cast<uint32_t*>(this->_zidx);
 
-  for(size_t i = 0; i < this->_zent_size; ++i) {
-    if(Om_namesMatches(zent[i].file_path, entry))
-      return i;
+  size_t s = __zip_path_hash(entry.c_str(), entry.size()) & this->_zidx_mask;
+
+  // probe until empty slot, comparing names to resolve collisions
+  while(zidx[s] != 0) {
+    if(Om_namesMatches(entry, zstr + zent[zidx[s] - 1].path_off))
+      return zidx[s] - 1;
+    s = (s + 1) & this->_zidx_mask;
   }
 
   return -1;
@@ -953,27 +2919,22 @@ bool OmArchive::close()
     this->_zent = nullptr;
   }
 
-  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
-
-  if(this->_stat & ZIP_READER) {
-
-    zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+  if(this->_zstr) {
+    Om_free(this->_zstr);
+    this->_zstr = nullptr;
+  }
 
-    if(zctx->zip_hnd) {
-      mz_err = mz_zip_close(zctx->zip_hnd);
-      mz_zip_delete(&zctx->zip_hnd);
-    }
+  if(this->_zidx) {
+    Om_free(this->_zidx);
+    this->_zidx = nullptr;
+  }
 
-    if(zctx->strm_splt) {
-      mz_stream_split_close(zctx->strm_splt);
-      mz_stream_split_delete(&zctx->strm_splt);
-    }
+  this->_zidx_mask = 0;
 
-    if(zctx->strm_buff)
-      mz_stream_buffered_delete(&zctx->strm_buff);
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
 
-    if(zctx->strm_file)
-      mz_stream_os_delete(&zctx->strm_file);
+  if(this->_stat & ZIP_READER) {
+    mz_err = __zip_reader_close(zctx);
   }
 
   if(this->_stat & ZIP_WRITER) {
@@ -1011,6 +2972,17 @@ bool OmArchive::close()
 }
 
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmArchive::adaptStats(uint64_t* count, uint64_t* size) const
+{
+  zip_context_t* zctx = static_cast<zip_context_t*>(this->_zctx);
+
+  if(count) *count = zctx->adapt_count;
+  if(size) *size = zctx->adapt_size;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
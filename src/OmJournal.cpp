@@ -0,0 +1,223 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBase.h"
+
+#include "OmBaseWin.h"
+
+#include "OmUtilStr.h"
+#include "OmUtilFs.h"
+
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+#include "OmJournal.h"
+
+/// \brief Journal batch size
+///
+/// Count of appended records after which buffer is written to disk
+///
+#define JNL_BATCH_SIZE    256
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmJournal::OmJournal() :
+  _hfile(nullptr),
+  _buffered(0)
+{
+
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmJournal::~OmJournal()
+{
+  this->close();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmJournal::create(const OmWString& path)
+{
+  this->close();
+
+  this->_record.clear();
+
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return GetLastError();
+
+  this->_hfile = hFile;
+  this->_path = path;
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmJournal::load(const OmWString& path)
+{
+  this->close();
+
+  this->_record.clear();
+
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return GetLastError();
+
+  this->_path = path;
+
+  OmCString data;
+
+  DWORD rb;
+  char read_buf[4096];
+
+  while(ReadFile(hFile, read_buf, sizeof(read_buf), &rb, nullptr)) {
+
+    if(rb == 0)
+      break;
+
+    data.append(read_buf, rb);
+  }
+
+  CloseHandle(hFile);
+
+  // each record is a line made of type character, space and UTF-8 data, an
+  // unterminated line is the trace of an interrupted write
+  size_t s = 0, e;
+
+  while((e = data.find('\n', s)) != OmCString::npos) {
+
+    if(e - s >= 2) {
+
+      OmJnlRec_t record;
+      record.type = data[s];
+      record.data = Om_toUTF16(data.substr(s + 2, e - s - 2));
+
+      this->_record.push_back(record);
+    }
+
+    s = e + 1;
+  }
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmJournal::append(OmJnlRecType type, const OmWString& data)
+{
+  if(!this->_hfile)
+    return;
+
+  this->_buffer.push_back(static_cast<char>(type));
+  this->_buffer.push_back(' ');
+  this->_buffer.append(Om_toUTF8(data));
+  this->_buffer.push_back('\n');
+
+  // write by batch so disk synchronization does not occur for each record
+  if(++this->_buffered >= JNL_BATCH_SIZE)
+    this->sync();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t OmJournal::sync()
+{
+  if(!this->_hfile)
+    return 0;
+
+  if(this->_buffer.empty())
+    return 0;
+
+  DWORD wb;
+
+  if(!WriteFile(this->_hfile, this->_buffer.data(), this->_buffer.size(), &wb, nullptr))
+    return GetLastError();
+
+  if(!FlushFileBuffers(this->_hfile))
+    return GetLastError();
+
+  this->_buffer.clear();
+  this->_buffered = 0;
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmJournal::close(bool remove)
+{
+  if(this->_hfile) {
+
+    if(!remove)
+      this->sync();
+
+    CloseHandle(this->_hfile);
+    this->_hfile = nullptr;
+
+    this->_buffer.clear();
+    this->_buffered = 0;
+  }
+
+  if(remove && !this->_path.empty()) {
+    Om_fileDelete(this->_path);
+    this->_path.clear();
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmJournal::hasRecord(OmJnlRecType type) const
+{
+  for(size_t i = 0; i < this->_record.size(); ++i)
+    if(this->_record[i].type == type)
+      return true;
+
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmJournal::findRecord(OmJnlRecType type) const
+{
+  for(size_t i = 0; i < this->_record.size(); ++i)
+    if(this->_record[i].type == type)
+      return this->_record[i].data;
+
+  return OmWString();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmJournal::findRecords(OmJnlRecType type, OmWStringArray* data) const
+{
+  for(size_t i = 0; i < this->_record.size(); ++i)
+    if(this->_record[i].type == type)
+      data->push_back(this->_record[i].data);
+}
@@ -15,6 +15,9 @@
   along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
 */
 #include <algorithm>            //< std::find
+#include <ctime>                //< clock()
+#include <unordered_map>
+#include <unordered_set>
 
 #include "OmBaseApp.h"
 
@@ -36,6 +39,341 @@
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 #include "OmModChan.h"
 
+#define MODLIB_CACHE_MAGIC    0x434C4D4F  //< "OMLC"
+#define MODLIB_CACHE_VERSION  1
+
+/// \brief Mod Library cache record header
+///
+/// Header of Mod Library cache record, followed by Source cached data as
+/// written by OmModPack::writeSourceCache.
+///
+typedef struct modlib_cache_rec_
+{
+  uint64_t      path_hash;    //< Source path hash
+
+  uint64_t      size;         //< Source file size
+
+  int64_t       time;         //< Source file modification time
+
+  uint32_t      data_size;    //< Size of following cached data
+
+  uint32_t      reserved;
+
+} modlib_cache_rec_t;
+
+/// \brief Mod Library cache entry
+///
+/// Copy of cache record header, since records are not aligned within cache
+/// data, with pointer to its following cached data.
+///
+typedef struct modlib_cache_ent_
+{
+  modlib_cache_rec_t  rec;        //< Record header
+
+  const uint8_t*      data;       //< Record cached data
+
+} modlib_cache_ent_t;
+
+/// \brief Mod Library cache index
+///
+/// Cache entries indexed by Source path hash.
+///
+typedef std::unordered_map<uint64_t, modlib_cache_ent_t> modlib_cache_idx_t;
+
+#define MODLIB_MAX_WORKERS    8
+
+/// \brief Mod Library load job
+///
+/// Structure for a Backup or Source parsed by a library load worker.
+///
+typedef struct modlib_load_job_
+{
+  OmModPack*        ModPack;      //< Mod Pack to parse into
+
+  const OmWString*  path;         //< Backup or Source path
+
+  bool              backup;       //< Job parses a Backup
+
+  bool              created;      //< Mod Pack was created for this job
+
+  bool              parsed;       //< Parse result
+
+  bool              cache_hit;    //< Source was parsed from cache
+
+  OmCString         cache_rec;    //< Cache record to write, if any
+
+} modlib_load_job_t;
+
+/// \brief Mod Library load context
+///
+/// Internal structure shared by library load workers.
+///
+typedef struct modlib_load_batch_
+{
+  std::vector<modlib_load_job_t>* jobs;
+
+  const modlib_cache_idx_t* cache_index;
+
+  LONG                  jobs_count;
+
+  volatile LONG         jobs_next;
+
+} modlib_load_batch_t;
+
+/// \brief Process Mod Library load job
+///
+/// Parse the Backup or Source of the given job, Sources are parsed from
+/// cache when the cached record is still valid.
+///
+/// \param[in] job         : Job to process.
+/// \param[in] cache_index : Library cache index.
+///
+static void __modlib_load_exec(modlib_load_job_t* job, const modlib_cache_idx_t* cache_index)
+{
+  const OmWString& path = *job->path;
+
+  if(job->backup) {
+    job->parsed = job->ModPack->parseBackup(path);
+    return;
+  }
+
+  // only archive Sources are cached, directories are always parsed
+  modlib_cache_rec_t rec;
+  memset(&rec, 0, sizeof(rec));
+
+  bool cachable = !Om_isDir(path);
+
+  if(cachable) {
+
+    rec.path_hash = Om_getXXHash3(path);
+    rec.size = Om_itemSize(path);
+    rec.time = Om_itemTime(path);
+
+    auto it = cache_index->find(rec.path_hash);
+    if(it != cache_index->end()) {
+
+      const modlib_cache_ent_t& cached = it->second;
+
+      if(cached.rec.size == rec.size && cached.rec.time == rec.time) {
+
+        job->parsed = job->ModPack->parseSourceCache(path, cached.data, cached.rec.data_size);
+
+        if(job->parsed) {
+          job->cache_rec.assign(reinterpret_cast<const char*>(&cached.rec), sizeof(modlib_cache_rec_t));
+          job->cache_rec.append(reinterpret_cast<const char*>(cached.data), cached.rec.data_size);
+          job->cache_hit = true;
+          return;
+        }
+      }
+    }
+  }
+
+  job->parsed = job->ModPack->parseSource(path);
+
+  if(job->parsed && cachable) {
+
+    OmCString rec_data;
+
+    if(job->ModPack->writeSourceCache(&rec_data)) {
+      rec.data_size = rec_data.size();
+      job->cache_rec.assign(reinterpret_cast<const char*>(&rec), sizeof(modlib_cache_rec_t));
+      job->cache_rec.append(rec_data);
+    }
+  }
+}
+
+/// \brief Mod Library load worker
+///
+/// Thread function of library load worker, each worker processes jobs
+/// until none remain.
+///
+/// \param[in] ptr       : Pointer to library load context.
+///
+static DWORD WINAPI __modlib_load_run_fn(void* ptr)
+{
+  modlib_load_batch_t* batch = static_cast<modlib_load_batch_t*>(ptr);
+
+  while(true) {
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    __modlib_load_exec(&(*batch->jobs)[j], batch->cache_index);
+  }
+
+  return 0;
+}
+
+/// \brief Process Mod Library load jobs
+///
+/// Process the given jobs using parallel workers, each job result is stored
+/// in its own structure so caller can merge them in a deterministic order.
+///
+/// \param[in] jobs        : Jobs to process.
+/// \param[in] cache_index : Library cache index.
+///
+static void __modlib_load_many(std::vector<modlib_load_job_t>* jobs, const modlib_cache_idx_t* cache_index)
+{
+  // get count of workers to run
+  SYSTEM_INFO sys_info;
+  GetSystemInfo(&sys_info);
+
+  size_t threads = sys_info.dwNumberOfProcessors;
+  if(threads > MODLIB_MAX_WORKERS) threads = MODLIB_MAX_WORKERS;
+  if(threads > jobs->size()) threads = jobs->size();
+
+  modlib_load_batch_t batch;
+  batch.jobs = jobs;
+  batch.cache_index = cache_index;
+  batch.jobs_count = jobs->size();
+  batch.jobs_next = 0;
+
+  HANDLE hthreads[MODLIB_MAX_WORKERS];
+  DWORD hthreads_count = 0;
+
+  if(threads > 1) {
+    for(size_t t = 0; t < threads; ++t) {
+      HANDLE hth = Om_threadCreate(__modlib_load_run_fn, &batch);
+      if(hth) hthreads[hthreads_count++] = hth;
+    }
+  }
+
+  // this thread takes its part of the work, or all the work if no worker
+  // could be created
+  __modlib_load_run_fn(&batch);
+
+  // caller is usually the UI thread while workers may log, and log callbacks
+  // send messages to UI windows, so sent messages are dispatched while waiting
+  for(DWORD t = 0; t < hthreads_count; ++t) {
+
+    while(MsgWaitForMultipleObjects(1, &hthreads[t], FALSE, INFINITE, QS_SENDMESSAGE) == WAIT_OBJECT_0 + 1) {
+      MSG msg;
+      PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE);
+    }
+
+    CloseHandle(hthreads[t]);
+  }
+}
+
+#define MODOPS_MAX_WORKERS    4
+#define MODOPS_POLL_DELAY     50
+
+/// \brief Mod operation work
+///
+/// Structure for a Mod operation processed by a wave worker.
+///
+typedef struct modops_work_
+{
+  OmModChan*    ModChan;      //< Mod Channel processing operation
+
+  OmModPack*    ModPack;      //< Mod Pack to install or restore
+
+  bool          restore;      //< Operation is a restore
+
+  OmResult      result;       //< Operation result
+
+} modops_work_t;
+
+/// \brief Process Mod operation
+///
+/// Install or restore the given Mod Pack depending its current state.
+///
+/// \param[in] ModPack     : Mod Pack to process.
+/// \param[in] progress_cb : Progression callback.
+/// \param[in] user_ptr    : Custom pointer passed to progression callback.
+///
+/// \return Operation result.
+///
+static OmResult __modops_exec(OmModPack* ModPack, Om_progressCb progress_cb, void* user_ptr)
+{
+  // This is a Restore operation
+  if(ModPack->hasBackup())
+    return ModPack->restoreData(progress_cb, user_ptr);
+
+  // This is an Install operation
+  OmResult result = ModPack->makeBackup(progress_cb, user_ptr);
+  if(result == OM_RESULT_OK)
+    result = ModPack->applySource(progress_cb, user_ptr);
+
+  return result;
+}
+
+/// \brief Get Mod operation footprint
+///
+/// Get hashes of Target paths the given Mod Pack operation may write or
+/// delete, and hashes of directories it only walks through.
+///
+/// \param[in]  ModPack    : Mod Pack to get footprint.
+/// \param[in]  target     : Target path, to check for existing directories.
+/// \param[out] keys       : Array to receive written or deleted paths hashes.
+/// \param[out] dirs       : Set to receive walked through directories hashes.
+///
+static void __modops_footprint(const OmModPack* ModPack, const OmWString& target, OmUint64Array* keys, std::unordered_set<uint64_t>* dirs)
+{
+  bool restore = ModPack->hasBackup();
+
+  size_t count = restore ? ModPack->backupEntryCount() : ModPack->sourceEntryCount();
+
+  OmWString path, tgt_path;
+
+  for(size_t i = 0; i < count; ++i) {
+
+    const OmModEntry_t& entry = restore ? ModPack->getBackupEntry(i) : ModPack->getSourceEntry(i);
+
+    path = entry.path;
+    Om_strToUpper(&path);
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR)) {
+
+      // only directories the operation creates or removes are written,
+      // existing ones are simply shared with other operations
+      bool owned;
+
+      if(restore) {
+        owned = OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL);
+      } else {
+        Om_concatPaths(tgt_path, target, entry.path);
+        owned = !Om_pathExists(tgt_path);
+      }
+
+      if(owned) {
+        keys->push_back(Om_getXXHash3(path));
+      } else {
+        dirs->insert(Om_getXXHash3(path));
+      }
+
+    } else {
+
+      keys->push_back(Om_getXXHash3(path));
+    }
+
+    // parent directories are walked through
+    size_t e;
+    while((e = path.find_last_of(L'\\')) != OmWString::npos) {
+      path.resize(e);
+      dirs->insert(Om_getXXHash3(path));
+    }
+  }
+}
+
+/// \brief Lookup index key
+///
+/// Computes lookup index key of the given Target relative path or Mod
+/// identity, which is the hash of its case-folded version.
+///
+/// \param[in] str       : Target relative path or Mod identity.
+///
+/// \return Lookup index key.
+///
+static inline uint64_t __lookup_key(const OmWString& str)
+{
+  OmWString upper = str;
+  Om_strToUpper(&upper);
+
+  return Om_getXXHash3(upper);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -57,11 +395,14 @@ OmModChan::OmModChan(OmModHub* ModHub) :
   _modops_hwo(nullptr),
   _modops_dones(0),
   _modops_percent(0),
+  _modops_rate(0.0),
   _modops_begin_cb(nullptr),
   _modops_progress_cb(nullptr),
   _modops_result_cb(nullptr),
   _modops_notify_cb(nullptr),
   _modops_user_ptr(nullptr),
+  _bckcmp_abort(false),
+  _bckcmp_hth(nullptr),
   _download_abort(false),
   _download_dones(0),
   _download_percent(0),
@@ -92,11 +433,15 @@ OmModChan::OmModChan(OmModHub* ModHub) :
   _query_notify_cb(nullptr),
   _query_user_ptr(nullptr),
   _library_devmode(true),
+  _library_hardlink(false),
+  _library_skipsame(false),
   _library_showhidden(false),
   _warn_overlaps(true),
   _warn_extra_inst(true),
   _backup_method(OM_METHOD_ZSTD),
   _backup_level(OM_LEVEL_FAST),
+  _backup_staging(false),
+  _backup_adaptive(true),
   _warn_extra_unin(true),
   _warn_extra_dnld(true),
   _warn_miss_deps(true),
@@ -108,6 +453,11 @@ OmModChan::OmModChan(OmModHub* ModHub) :
 {
   // set parameters for library monitor
   this->_monitor.setCallback(OmModChan::_monitor_notify_fn, this);
+
+  InitializeCriticalSection(&this->_trgcrc_lock);
+
+  // compression is started from Mod operations end callback
+  InitializeCriticalSection(&this->_bckcmp_lock);
 }
 
 ///
@@ -116,6 +466,9 @@ OmModChan::OmModChan(OmModHub* ModHub) :
 OmModChan::~OmModChan()
 {
   this->close();
+
+  DeleteCriticalSection(&this->_trgcrc_lock);
+  DeleteCriticalSection(&this->_bckcmp_lock);
 }
 
 ///
@@ -136,6 +489,9 @@ void OmModChan::close()
   this->_modops_hth = nullptr;
   this->_modops_hwo = nullptr;
 
+  // stop and clear Backup compression thread
+  this->_bckcmp_stop();
+
   // stop and clear Upgrades thread
   if(this->_upgrade_hth) {
     this->_upgrade_abort = true;
@@ -202,6 +558,7 @@ void OmModChan::close()
   this->_modops_result_cb = nullptr;
   this->_modops_notify_cb = nullptr;
   this->_modops_user_ptr = nullptr;
+  this->_modops_rate = 0.0;
 
   this->_download_abort = false;
   this->_download_dones = 0;
@@ -235,14 +592,27 @@ void OmModChan::close()
   this->_query_notify_cb = nullptr;
   this->_query_user_ptr = nullptr;
 
+  this->_trgcrc_cache.clear();
+
+  this->_fpidx_path.clear();
+  this->_fpidx_owner.clear();
+  this->_fpidx_ovlpby.clear();
+
+  this->_depgraph.clear();
+  this->_depgraph_rdeps.clear();
+
   this->_cust_library_path = false;
   this->_library_devmode = true;
+  this->_library_hardlink = false;
+  this->_library_skipsame = false;
   this->_library_showhidden = false;
   this->_warn_overlaps = true;
   this->_warn_extra_inst = true;
   this->_cust_backup_path = false;
   this->_backup_method = OM_METHOD_ZSTD;
   this->_backup_level = OM_LEVEL_FAST;
+  this->_backup_staging = false;
+  this->_backup_adaptive = true;
   this->_warn_extra_unin = true;
   this->_warn_extra_dnld = true;
   this->_warn_miss_deps = true;
@@ -394,6 +764,20 @@ bool OmModChan::open(const OmWString& path)
     this->setBackupComp(this->_backup_method, this->_backup_level);
   }
 
+  if(this->_xml.hasChild(L"backup_staging")) {
+    this->_backup_staging = this->_xml.child(L"backup_staging").attrAsInt(L"enable");
+  } else {
+    // create default values
+    this->setBackupStaging(this->_backup_staging);
+  }
+
+  if(this->_xml.hasChild(L"backup_adaptive")) {
+    this->_backup_adaptive = this->_xml.child(L"backup_adaptive").attrAsInt(L"enable");
+  } else {
+    // create default values
+    this->setBackupAdaptive(this->_backup_adaptive);
+  }
+
   if(this->_xml.hasChild(L"library_sort")) {
     this->_modpack_list_sort = this->_xml.child(L"library_sort").attrAsInt(L"sort");
   } else {
@@ -409,6 +793,24 @@ bool OmModChan::open(const OmWString& path)
     this->setLibraryDevmod(this->_library_devmode);
   }
 
+  if(this->_xml.hasChild(L"library_hardlink")) {
+    this->_library_hardlink = this->_xml.child(L"library_hardlink").attrAsInt(L"enable");
+  } else {
+    // create default values
+    this->setLibraryHardlink(this->_library_hardlink);
+  }
+
+  if(this->_xml.hasChild(L"library_skipsame")) {
+    this->_library_skipsame = this->_xml.child(L"library_skipsame").attrAsInt(L"enable");
+  } else {
+    // create default values
+    this->setLibrarySkipsame(this->_library_skipsame);
+  }
+
+  // throughput measured during previous Mod operations
+  if(this->_xml.hasChild(L"modops_rate"))
+    this->_modops_rate = this->_xml.child(L"modops_rate").attrAsDouble(L"bps");
+
   if(this->_xml.hasChild(L"library_showhidden")) {
     this->_library_showhidden = this->_xml.child(L"library_showhidden").attrAsInt(L"enable");
   } else {
@@ -556,6 +958,9 @@ bool OmModChan::open(const OmWString& path)
 
   this->_log(OM_LOG_OK, L"open", L"OK");
 
+  // recover operations left interrupted by crash or power loss
+  this->_jnl_recover();
+
   // Load library
   this->reloadModLibrary();
 
@@ -799,6 +1204,9 @@ void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
     // search for Mod Pack to delete
     for(size_t p = 0; p < self->_modpack_list.size(); ++p) {
       if(name_hash == self->_modpack_list[p]->hash()) {
+        if(self->_modpack_list[p]->backupIsStaged())
+          self->_bckcmp_stop();
+        self->_fpidx_rem(self->_modpack_list[p]->hash());
         delete self->_modpack_list[p];
         self->_modpack_list.erase(self->_modpack_list.begin() + p);
         has_changes = true; break;
@@ -822,6 +1230,7 @@ void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
       for(size_t p = 0; p < self->_modpack_list.size(); p++) {
         if(name_hash == self->_modpack_list[p]->hash()) {
           self->_modpack_list[p]->parseSource(path);
+          self->indexFootprint(self->_modpack_list[p]);
           has_changes = true; break;
         }
       }
@@ -848,6 +1257,7 @@ void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
     for(size_t p = 0; p < self->_modpack_list.size(); ++p) {
       if(name_hash == self->_modpack_list[p]->hash()) {
         self->_modpack_list[p]->refreshSource();
+        self->indexFootprint(self->_modpack_list[p]);
         has_changes = true; break;
       }
     }
@@ -887,6 +1297,9 @@ void OmModChan::_monitor_notify_fn(void* ptr, OmNotify notify, uint64_t param)
 
   if(has_changes) {
 
+    // list or Mod Packs properties changed, lookup indices must be rebuilt
+    self->_modpack_index_build();
+
     // if an element was added to list we need to sort again
     if(has_created) {
 
@@ -917,13 +1330,43 @@ void OmModChan::clearModLibrary()
 
     this->_modpack_list.clear();
   }
+
+  this->_modpack_index_build();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_jnl_recover()
+{
+  if(!this->accessesBackup())
+    return;
+
+  OmWStringArray paths;
+
+  // journals are deleted once operation completes, any remaining one belongs
+  // to an interrupted operation
+  Om_lsFileFiltered(&paths, this->_backup_path, L"*." OM_JNL_FILE_EXT, true, true);
+
+  for(size_t i = 0; i < paths.size(); ++i) {
+
+    this->_log(OM_LOG_WRN, L"_jnl_recover", L"recovering interrupted operation: " + Om_getFilePart(paths[i]));
+
+    OmModPack ModPack(this);
+
+    if(ModPack.recoverJournal(paths[i]) != OM_RESULT_OK)
+      this->_log(OM_LOG_ERR, L"_jnl_recover", ModPack.lastError());
+  }
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
 void OmModChan::reloadModLibrary()
-{
+{
+  // Mod Pack instances are about to be deleted
+  this->_bckcmp_stop();
+
   // clear current library
   if(!this->_modpack_list.empty()) {
 
@@ -931,6 +1374,8 @@ void OmModChan::reloadModLibrary()
       delete this->_modpack_list[i];
 
     this->_modpack_list.clear();
+
+    this->_modpack_index_build();
   }
 
   if(!this->accessesLibrary(OM_ACCESS_DIR_READ)) { // check for read access
@@ -947,19 +1392,60 @@ void OmModChan::reloadModLibrary()
   Om_lsFileFiltered(&paths, this->_backup_path, L"*." OM_BCK_FILE_EXT, true, true);
   Om_lsDir(&paths, this->_backup_path, true, true);
 
-  // add all available and valid Backups
-  for(size_t i = 0; i < paths.size(); ++i) {
+  // staged Backup compression may have been interrupted once the archive
+  // was published, the archive is complete and replaces staged directory
+  for(size_t i = 0; i < paths.size(); ) {
+
+    OmWString cfg_path = paths[i] + L"\\ModBack.xml";
+    OmWString zip_path = paths[i] + L"." OM_BCK_FILE_EXT;
 
-    OmModPack* ModPack = new OmModPack(this);
+    OmXmlConf backup_cfg;
+
+    if(Om_isDir(paths[i]) && Om_isFile(zip_path) &&
+       backup_cfg.load(cfg_path, OM_XMAGIC_BCK) && backup_cfg.hasChild(L"staged")) {
+
+      backup_cfg.clear();
+
+      int32_t result = Om_fileDelete(cfg_path);
+      if(result == 0)
+        result = Om_dirDeleteRecursive(paths[i]);
+
+      if(result != 0)
+        this->_log(OM_LOG_WRN, L"reloadModLibrary", Om_errDelete(L"Backup staging directory", paths[i], result));
+
+      paths.erase(paths.begin() + i);
 
-    if(ModPack->parseBackup(paths[i])) {
-      this->_modpack_list.push_back(ModPack);
     } else {
-      delete ModPack;
+      ++i;
     }
+  }
+
+  // parse Backups using parallel workers, results are merged in listing
+  // order so library content does not depend on workers scheduling
+  std::vector<modlib_load_job_t> jobs(paths.size());
 
+  for(size_t i = 0; i < paths.size(); ++i) {
+    jobs[i].ModPack = new OmModPack(this);
+    jobs[i].path = &paths[i];
+    jobs[i].backup = true;
+    jobs[i].created = true;
+    jobs[i].parsed = false;
+    jobs[i].cache_hit = false;
+  }
+
+  __modlib_load_many(&jobs, nullptr);
+
+  // add all available and valid Backups
+  for(size_t i = 0; i < jobs.size(); ++i) {
+    if(jobs[i].parsed) {
+      this->_modpack_list.push_back(jobs[i].ModPack);
+    } else {
+      delete jobs[i].ModPack;
+    }
   }
 
+  jobs.clear();
+
   // get Library directory content
   paths.clear();
   Om_lsFileFiltered(&paths, this->_library_path, L"*.zip", true, this->_library_showhidden);
@@ -967,44 +1453,132 @@ void OmModChan::reloadModLibrary()
   if(this->_library_devmode)
     Om_lsDir(&paths, this->_library_path, true, this->_library_showhidden);
 
-  // Link Sources to matching Backup, or add new Sources
-  for(size_t i = 0; i < paths.size(); ++i) {
+  // load Library cache, records are indexed by Source path hash
+  OmWString cache_path;
+  Om_concatPaths(cache_path, this->_home, OM_MODCHN_LIBCACHE_FILE);
 
-    uint64_t name_hash = Om_getXXHash3(Om_getFilePart(paths[i]));
+  uint64_t cache_size = 0;
+  uint8_t* cache_data = Om_loadBinary(&cache_size, cache_path);
 
-    bool found = false;
+  modlib_cache_idx_t cache_index;
 
-    // check whether this Mod Source matches an existing Backup
-    for(size_t p = 0; p < this->_modpack_list.size(); p++) {
-      if(name_hash == this->_modpack_list[p]->hash()) {
-        this->_modpack_list[p]->parseSource(paths[i]);
-        found = true; break;
+  if(cache_data && cache_size >= 2 * sizeof(uint32_t)) {
+
+    uint32_t cache_head[2];
+    memcpy(cache_head, cache_data, sizeof(cache_head));
+
+    if(cache_head[0] == MODLIB_CACHE_MAGIC && cache_head[1] == MODLIB_CACHE_VERSION) {
+
+      uint64_t pos = sizeof(cache_head);
+
+      // records have variable size, they are copied out of cache data
+      // rather than accessed in place at unaligned offsets
+      modlib_cache_ent_t ent;
+
+      while(cache_size - pos >= sizeof(modlib_cache_rec_t)) {
+
+        memcpy(&ent.rec, cache_data + pos, sizeof(modlib_cache_rec_t));
+        pos += sizeof(modlib_cache_rec_t);
+
+        if(cache_size - pos < ent.rec.data_size)
+          break; //< truncated
+
+        ent.data = cache_data + pos;
+        cache_index[ent.rec.path_hash] = ent;
+
+        pos += ent.rec.data_size;
       }
     }
+  }
+
+  // new cache content, rewritten only if something changed
+  OmCString cache_out;
+  uint32_t cache_head[2] = {MODLIB_CACHE_MAGIC, MODLIB_CACHE_VERSION};
+  cache_out.append(reinterpret_cast<const char*>(cache_head), sizeof(cache_head));
+
+  size_t cache_hits = 0;
+  bool cache_dirty = false;
+
+  // Backups indexed by name hash, for Source linking
+  std::unordered_map<uint64_t, OmModPack*> backup_index;
+  for(size_t p = 0; p < this->_modpack_list.size(); p++)
+    backup_index.emplace(this->_modpack_list[p]->hash(), this->_modpack_list[p]);
+
+  // Link Sources to matching Backup, or create new Mod Packs, listed names
+  // are unique so each Mod Pack is parsed by a single job
+  jobs.resize(paths.size());
+
+  for(size_t i = 0; i < paths.size(); ++i) {
+
+    uint64_t name_hash = Om_getXXHash3(Om_getFilePart(paths[i]));
+
+    // check whether this Mod Source matches an existing Backup
+    auto it = backup_index.find(name_hash);
 
     // no Backup found for this Mod Source, adding new
-    if(!found) {
-      OmModPack* ModPack = new OmModPack(this);
-      if(ModPack->parseSource(paths[i])) {
-        this->_modpack_list.push_back(ModPack);
+    jobs[i].created = (it == backup_index.end());
+    jobs[i].ModPack = jobs[i].created ? new OmModPack(this) : it->second;
+    jobs[i].path = &paths[i];
+    jobs[i].backup = false;
+    jobs[i].parsed = false;
+    jobs[i].cache_hit = false;
+  }
+
+  // parse Sources using parallel workers
+  __modlib_load_many(&jobs, &cache_index);
+
+  // merge results in listing order
+  for(size_t i = 0; i < jobs.size(); ++i) {
+
+    if(jobs[i].cache_hit) {
+      cache_hits++;
+    } else {
+      cache_dirty = true;
+    }
+
+    cache_out.append(jobs[i].cache_rec);
+
+    if(jobs[i].created) {
+      if(jobs[i].parsed) {
+        this->_modpack_list.push_back(jobs[i].ModPack);
       } else {
-        delete ModPack;
+        delete jobs[i].ModPack;
       }
     }
   }
 
+  // removed Sources also need cache to be rewritten
+  if(cache_hits != cache_index.size())
+    cache_dirty = true;
+
+  if(cache_data)
+    Om_free(cache_data);
+
+  if(cache_dirty) {
+    int32_t result = Om_saveBinary(cache_path, reinterpret_cast<const uint8_t*>(cache_out.data()), cache_out.size());
+    if(result != 0)
+      this->_log(OM_LOG_WRN, L"reloadModLibrary", Om_errCreate(L"Library cache file", cache_path, result));
+  }
+
   // sort library
   this->sortModLibrary(); //< this will send rebuild notification
 
+  // index footprint of installed Mods
+  this->_fpidx_build();
+
   // refresh Mod Packs analytical parameters
   this->refreshModLibrary();
 
   // as changes in local library may change status in Network library
   // we also refresh Network library
-  this->refreshNetLibrary();
-
-  #ifdef DEBUG
-  std::cout << "DEBUG => OmModChan::reloadModLibrary\n";
+  this->refreshNetLibrary();
+
+  // resume compression of Backups left staged
+  if(!this->_locked_mod_library)
+    this->_bckcmp_start();
+
+  #ifdef DEBUG
+  std::cout << "DEBUG => OmModChan::reloadModLibrary\n";
   #endif
 }
 
@@ -1028,6 +1602,9 @@ bool OmModChan::refreshModLibrary()
     }
   }
 
+  // all Mod Packs are now up to date
+  this->_fpidx_dirty.clear();
+
   #ifdef DEBUG
   std::cout << "DEBUG => OmModChan::refreshModLibrary " << (has_change ? "~=" : "==") << "\n";
   #endif
@@ -1065,6 +1642,9 @@ bool OmModChan::ghostbusterModLibrary()
     }
   }
 
+  if(has_change)
+    this->_modpack_index_build();
+
   #ifdef DEBUG
   std::cout << "DEBUG => OmModChan::ghostbusterModLibrary " << (has_change ? "+-" : "==") << "\n";
   #endif
@@ -1188,10 +1768,9 @@ OmResult OmModChan::importToLibrary(const OmWStringArray& paths, Om_progressCb p
 ///
 int32_t OmModChan::indexOfModpack(const OmModPack* ModPack) const
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
-    if(this->_modpack_list[i] == ModPack)
-      return i;
-  }
+  auto it = this->_modpack_ptr_idx.find(ModPack);
+  if(it != this->_modpack_ptr_idx.end())
+    return it->second;
 
   return -1;
 }
@@ -1201,10 +1780,9 @@ int32_t OmModChan::indexOfModpack(const OmModPack* ModPack) const
 ///
 int32_t OmModChan::indexOfModpack(uint64_t hash) const
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
-    if(this->_modpack_list[i]->hash() == hash)
-      return i;
-  }
+  auto it = this->_modpack_hash_idx.find(hash);
+  if(it != this->_modpack_hash_idx.end())
+    return it->second.front();
 
   return -1;
 }
@@ -1214,13 +1792,20 @@ int32_t OmModChan::indexOfModpack(uint64_t hash) const
 ///
 OmModPack* OmModChan::findModpack(uint64_t hash, bool nodir) const
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
+  auto it = this->_modpack_hash_idx.find(hash);
+  if(it == this->_modpack_hash_idx.end())
+    return nullptr;
+
+  // Directory and archive Sources may share the same name, indices are
+  // stored in list order so we get the same result than a plain search
+  for(size_t i = 0; i < it->second.size(); ++i) {
+
+    OmModPack* ModPack = this->_modpack_list[it->second[i]];
 
-    if(nodir && this->_modpack_list[i]->sourceIsDir())
+    if(nodir && ModPack->sourceIsDir())
       continue;
 
-    if(this->_modpack_list[i]->hash() == hash)
-      return this->_modpack_list[i];
+    return ModPack;
   }
 
   return nullptr;
@@ -1231,18 +1816,54 @@ OmModPack* OmModChan::findModpack(uint64_t hash, bool nodir) const
 ///
 OmModPack* OmModChan::findModpack(const OmWString& iden, bool nodir) const
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
+  auto it = this->_modpack_iden_idx.find(__lookup_key(iden));
+  if(it == this->_modpack_iden_idx.end())
+    return nullptr;
+
+  // index is case-insensitive, search remains case-sensitive
+  for(size_t i = 0; i < it->second.size(); ++i) {
+
+    OmModPack* ModPack = this->_modpack_list[it->second[i]];
 
-    if(nodir && this->_modpack_list[i]->sourceIsDir())
+    if(nodir && ModPack->sourceIsDir())
       continue;
 
-    if(this->_modpack_list[i]->iden() == iden)
-      return this->_modpack_list[i];
+    if(ModPack->iden() == iden)
+      return ModPack;
   }
 
   return nullptr;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_modpack_index_add(size_t i)
+{
+  const OmModPack* ModPack = this->_modpack_list[i];
+
+  this->_modpack_hash_idx[ModPack->hash()].push_back(i);
+  this->_modpack_iden_idx[__lookup_key(ModPack->iden())].push_back(i);
+  this->_modpack_ptr_idx[ModPack] = i;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_modpack_index_build()
+{
+  this->_modpack_hash_idx.clear();
+  this->_modpack_iden_idx.clear();
+  this->_modpack_ptr_idx.clear();
+
+  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
+    this->_modpack_index_add(i);
+
+  // graph nodes are list positions, it is built here, along with lookup
+  // indices, so const queries only read it and never modify it
+  this->_depgraph_build();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -1360,6 +1981,9 @@ void OmModChan::sortModLibrary()
     std::reverse(this->_modpack_list.begin(), this->_modpack_list.end());
   }
 
+  // list order changed, lookup indices must be rebuilt
+  this->_modpack_index_build();
+
   if(this->_modpack_notify_cb)
     this->_modpack_notify_cb(this->_modpack_notify_ptr, OM_NOTIFY_REBUILD, 0);
 }
@@ -1399,24 +2023,84 @@ void OmModChan::setModLibrarySort(OmSort sorting)
 ///
 bool OmModChan::isOverlapped(size_t index) const
 {
-  uint64_t mod_hash = this->_modpack_list[index]->hash();
+  return (this->_fpidx_ovlpby.count(this->_modpack_list[index]->hash()) != 0);
+}
 
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(this->_modpack_list[i]->hasOverlap(mod_hash))
-      return true;
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::isOverlapped(const OmModPack* ModPack) const
+{
+  return (this->_fpidx_ovlpby.count(ModPack->hash()) != 0);
+}
 
-  return false;
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::findOverlaps(const OmModPack* ModPack, OmUint64Array* overlaps) const
+{
+  OmPModPackArray found;
+  this->findOverlaps(ModPack, &found);
+
+  for(size_t i = 0; i < found.size(); ++i)
+    overlaps->push_back(found[i]->hash());
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModChan::isOverlapped(const OmModPack* ModPack) const
+void OmModChan::findOverlaps(const OmModPack* ModPack, OmPModPackArray* overlaps) const
 {
-  uint64_t mod_hash = ModPack->hash();
+  // gather installed Mods owning any of the Source files
+  std::unordered_set<uint64_t> owners;
+
+  for(size_t i = 0; i < ModPack->sourceEntryCount(); ++i) {
+
+    const OmModEntry_t& entry = ModPack->getSourceEntry(i);
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR)) //< we don't care directories
+      continue;
+
+    auto it = this->_fpidx_path.find(__lookup_key(entry.path));
+    if(it == this->_fpidx_path.end())
+      continue;
 
+    for(size_t j = 0; j < it->second.size(); ++j)
+      if(!OM_HAS_BIT(it->second[j].attr, OM_MODENTRY_DIR))
+        owners.insert(it->second[j].hash);
+  }
+
+  if(owners.empty())
+    return;
+
+  // keep library order
   for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(this->_modpack_list[i]->hasOverlap(mod_hash))
+    if(owners.count(this->_modpack_list[i]->hash()))
+      overlaps->push_back(this->_modpack_list[i]);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::getOverlaps(const OmModPack* ModPack, OmPModPackArray* overlaps) const
+{
+  for(size_t i = 0; i < ModPack->overlapCount(); ++i) {
+    OmModPack* Overlapped = this->findModpack(ModPack->getOverlapHash(i));
+    if(Overlapped) overlaps->push_back(Overlapped);
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::backupEntryExists(const OmWString& path, int32_t attr) const
+{
+  auto it = this->_fpidx_path.find(__lookup_key(path));
+  if(it == this->_fpidx_path.end())
+    return false;
+
+  for(size_t i = 0; i < it->second.size(); ++i)
+    if(it->second[i].attr == attr)
       return true;
 
   return false;
@@ -1425,92 +2109,390 @@ bool OmModChan::isOverlapped(const OmModPack* ModPack) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::findOverlaps(const OmModPack* ModPack, OmUint64Array* overlaps) const
+void OmModChan::indexFootprint(const OmModPack* ModPack)
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(this->_modpack_list[i]->hasBackup())
-      if(ModPack->canOverlap(this->_modpack_list[i]))
-        overlaps->push_back(this->_modpack_list[i]->hash());
+  this->_fpidx_rem(ModPack->hash());
+  this->_fpidx_add(ModPack);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::findOverlaps(const OmModPack* ModPack, OmPModPackArray* overlaps) const
+void OmModChan::_fpidx_add(const OmModPack* ModPack)
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(this->_modpack_list[i]->hasBackup())
-      if(ModPack->canOverlap(this->_modpack_list[i]))
-        overlaps->push_back(this->_modpack_list[i]);
+  if(!ModPack->hasBackup())
+    return;
+
+  uint64_t mod_hash = ModPack->hash();
+
+  fpidx_own_t& owner = this->_fpidx_owner[mod_hash];
+
+  fpidx_rec_t rec;
+  rec.hash = mod_hash;
+
+  // Backup entries describe what Mod wrote in Target, either saved original
+  // files or added files, this also avoid to load lazy Source entries
+  for(size_t i = 0; i < ModPack->backupEntryCount(); ++i) {
+
+    const OmModEntry_t& entry = ModPack->getBackupEntry(i);
+
+    uint64_t key = __lookup_key(entry.path);
+
+    rec.attr = entry.attr;
+    this->_fpidx_path[key].push_back(rec);
+    owner.keys.push_back(key);
+  }
+
+  // reverse overlap relation, counts of Mods overlapping each Mod
+  for(size_t i = 0; i < ModPack->overlapCount(); ++i) {
+
+    uint64_t ovl_hash = ModPack->getOverlapHash(i);
+
+    // Mod becomes overlapped, its analytics must be refreshed
+    if(++this->_fpidx_ovlpby[ovl_hash] == 1)
+      this->_fpidx_dirty.insert(ovl_hash);
+
+    owner.overlaps.push_back(ovl_hash);
+  }
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::getOverlaps(const OmModPack* ModPack, OmPModPackArray* overlaps) const
+void OmModChan::_fpidx_rem(uint64_t hash)
 {
-  for(size_t i = 0; i < ModPack->overlapCount(); ++i)
-    for(size_t j = 0; j < this->_modpack_list.size(); ++j)
-      if(ModPack->getOverlapHash(i) == this->_modpack_list[j]->hash()) {
-        overlaps->push_back(this->_modpack_list[j]); break;
+  auto own = this->_fpidx_owner.find(hash);
+  if(own == this->_fpidx_owner.end())
+    return;
+
+  // keys were recorded when indexed, since Mod entries may have changed
+  const OmUint64Array& keys = own->second.keys;
+
+  for(size_t i = 0; i < keys.size(); ++i) {
+
+    auto it = this->_fpidx_path.find(keys[i]);
+    if(it == this->_fpidx_path.end())
+      continue; //< already processed duplicate key
+
+    std::vector<fpidx_rec_t>& recs = it->second;
+
+    for(size_t j = 0; j < recs.size(); ) {
+      if(recs[j].hash == hash) {
+        recs[j] = recs.back(); recs.pop_back();
+      } else {
+        ++j;
       }
+    }
+
+    if(recs.empty())
+      this->_fpidx_path.erase(it);
+  }
+
+  const OmUint64Array& overlaps = own->second.overlaps;
+
+  for(size_t i = 0; i < overlaps.size(); ++i) {
+
+    auto it = this->_fpidx_ovlpby.find(overlaps[i]);
+    if(it == this->_fpidx_ovlpby.end())
+      continue;
+
+    // Mod is no longer overlapped, its analytics must be refreshed
+    if(--it->second == 0) {
+      this->_fpidx_ovlpby.erase(it);
+      this->_fpidx_dirty.insert(overlaps[i]);
+    }
+  }
+
+  this->_fpidx_owner.erase(own);
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModChan::backupEntryExists(const OmWString& path, int32_t attr) const
+void OmModChan::_fpidx_build()
 {
+  this->_fpidx_path.clear();
+  this->_fpidx_owner.clear();
+  this->_fpidx_ovlpby.clear();
+
   for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(this->_modpack_list[i]->hasBackup())
-      if(this->_modpack_list[i]->backupHasEntry(path, attr))
-        return true;
+    this->_fpidx_add(this->_modpack_list[i]);
 
-  return false;
+  // whole library is to be refreshed anyway
+  this->_fpidx_dirty.clear();
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModChan::isDependency(const OmModPack* ModPack) const
+bool OmModChan::_fpidx_refresh()
 {
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
-    if(ModPack != this->_modpack_list[i])
-      if(this->_modpack_list[i]->hasDepend(ModPack->iden()))
-        return true;
+  bool has_change = false;
 
-  return false;
+  // only Mods whose overlapped status may have flipped are evaluated
+  for(auto it = this->_fpidx_dirty.begin(); it != this->_fpidx_dirty.end(); ++it) {
+
+    auto idx = this->_modpack_hash_idx.find(*it);
+    if(idx == this->_modpack_hash_idx.end())
+      continue;
+
+    for(size_t i = 0; i < idx->second.size(); ++i) {
+
+      OmModPack* ModPack = this->_modpack_list[idx->second[i]];
+
+      if(ModPack->refreshAnalytics()) {
+
+        // notify changes
+        if(this->_modpack_notify_cb)
+          this->_modpack_notify_cb(this->_modpack_notify_ptr, OM_NOTIFY_ALTERED, ModPack->hash());
+
+        has_change = true;
+      }
+    }
+  }
+
+  this->_fpidx_dirty.clear();
+
+  return has_change;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModChan::hasMissingDepend(const OmModPack* ModPack) const
+bool OmModChan::targetFileMatches(const OmWString& path, uint64_t size, uint32_t crc)
 {
+  WIN32_FILE_ATTRIBUTE_DATA fad;
 
-  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
+  if(!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &fad))
+    return false;
+
+  if(fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+    return false;
+
+  trgcrc_rec_t rec;
+  rec.size = (static_cast<uint64_t>(fad.nFileSizeHigh) << 32) | fad.nFileSizeLow;
+  rec.time = (static_cast<uint64_t>(fad.ftLastWriteTime.dwHighDateTime) << 32) | fad.ftLastWriteTime.dwLowDateTime;
 
-    bool is_missing = true;
+  // different size, no need to go further
+  if(rec.size != size)
+    return false;
+
+  OmWString key = path; Om_strToUpper(&key);
+  uint64_t path_hash = Om_getXXHash3(key);
+
+  bool cached = false;
+
+  EnterCriticalSection(&this->_trgcrc_lock);
+
+  std::map<uint64_t, trgcrc_rec_t>::iterator it = this->_trgcrc_cache.find(path_hash);
+  if(it != this->_trgcrc_cache.end()) {
+    // cached value is valid only if file did not changed since
+    if(it->second.size == rec.size && it->second.time == rec.time) {
+      rec.crc = it->second.crc; cached = true;
+    }
+  }
+
+  LeaveCriticalSection(&this->_trgcrc_lock);
+
+  if(!cached) {
+
+    if(!Om_getCRC32digest(&rec.crc, path))
+      return false;
+
+    EnterCriticalSection(&this->_trgcrc_lock);
+    this->_trgcrc_cache[path_hash] = rec;
+    LeaveCriticalSection(&this->_trgcrc_lock);
+  }
+
+  return (rec.crc == crc);
+}
 
-    for(size_t j = 0; j < this->_modpack_list.size(); ++j) {
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_depgraph_build()
+{
+  size_t count = this->_modpack_list.size();
+
+  this->_depgraph.assign(count, depgraph_node_t());
+  this->_depgraph_rdeps.clear();
+
+  for(size_t i = 0; i < count; ++i) {
+
+    const OmModPack* ModPack = this->_modpack_list[i];
+
+    depgraph_node_t& node = this->_depgraph[i];
+
+    for(size_t d = 0; d < ModPack->dependCount(); ++d) {
+
+      const OmWString& iden = ModPack->getDependIden(d);
+
+      // reverse relation, by identity since dependency may be missing
+      this->_depgraph_rdeps[__lookup_key(iden)].push_back(i);
+
+      // dependencies rely only on packages, not directories
+      OmModPack* Depend = this->findModpack(iden, true);
+
+      if(Depend) {
+        node.depends.push_back(this->indexOfModpack(Depend));
+      } else {
+        Om_push_backUnique(node.missings, iden);
+      }
+    }
+  }
+
+  // transitive closures are computed per strongly connected component, so
+  // Mods of a dependency cycle all get the same complete closure. Components
+  // are found by an iterative Tarjan's walk, which emits each component after
+  // all components it depends on, and does not recurse on deep chains.
+  const uint32_t unseen = static_cast<uint32_t>(-1);
+
+  std::vector<uint32_t> order(count, unseen);
+  std::vector<uint32_t> lowlink(count, 0);
+  std::vector<uint8_t> onstack(count, 0);
+
+  OmIndexArray stack;
+  std::vector<std::pair<uint32_t, size_t>> walk;
+  uint32_t counter = 0;
+
+  for(size_t r = 0; r < count; ++r) {
+
+    if(order[r] != unseen)
+      continue;
+
+    order[r] = lowlink[r] = counter++;
+    stack.push_back(r); onstack[r] = 1;
+    walk.push_back(std::make_pair(static_cast<uint32_t>(r), 0));
+
+    while(!walk.empty()) {
+
+      uint32_t v = walk.back().first;
+      const OmIndexArray& depends = this->_depgraph[v].depends;
+
+      if(walk.back().second < depends.size()) {
+
+        uint32_t w = depends[walk.back().second++];
+
+        if(order[w] == unseen) {
+          order[w] = lowlink[w] = counter++;
+          stack.push_back(w); onstack[w] = 1;
+          walk.push_back(std::make_pair(w, 0));
+        } else if(onstack[w] && order[w] < lowlink[v]) {
+          lowlink[v] = order[w];
+        }
 
-      // ignore directory Mods
-      if(this->_modpack_list[j]->sourceIsDir())
         continue;
+      }
+
+      walk.pop_back();
 
-      if(ModPack->getDependIden(i) == this->_modpack_list[j]->iden()) {
+      if(!walk.empty() && lowlink[v] < lowlink[walk.back().first])
+        lowlink[walk.back().first] = lowlink[v];
 
-        // recursively check
-        if(this->hasMissingDepend(this->_modpack_list[j]))
-          return true;
+      if(lowlink[v] == order[v]) {
 
-        is_missing = false;
+        OmIndexArray component;
+        uint32_t w;
 
-        break;
+        do {
+          w = stack.back(); stack.pop_back(); onstack[w] = 0;
+          component.push_back(w);
+        } while(w != v);
+
+        this->_depgraph_close(component);
       }
     }
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_depgraph_close(const OmIndexArray& component)
+{
+  std::unordered_set<uint32_t> members(component.begin(), component.end());
+  std::unordered_set<uint32_t> found;
+
+  OmIndexArray closure;
+  OmWStringArray closure_missings;
+
+  // closure is built in depth-first order so dependencies always come
+  // before Mods depending on them, components of dependencies are already
+  // closed since they are emitted first
+  for(size_t m = 0; m < component.size(); ++m) {
+
+    const depgraph_node_t& node = this->_depgraph[component[m]];
+
+    for(size_t d = 0; d < node.depends.size(); ++d) {
+
+      uint32_t j = node.depends[d];
+      if(members.count(j)) continue;
+
+      const depgraph_node_t& depend = this->_depgraph[j];
+
+      for(size_t c = 0; c < depend.closure.size(); ++c)
+        if(found.insert(depend.closure[c]).second)
+          closure.push_back(depend.closure[c]);
+
+      if(found.insert(j).second)
+        closure.push_back(j);
+
+      for(size_t k = 0; k < depend.closure_missings.size(); ++k)
+        Om_push_backUnique(closure_missings, depend.closure_missings[k]);
+    }
+
+    for(size_t k = 0; k < node.missings.size(); ++k)
+      Om_push_backUnique(closure_missings, node.missings[k]);
+  }
+
+  if(component.size() > 1) {
+
+    this->_log(OM_LOG_WRN, L"_depgraph_close", L"dependency cycle involving \""+this->_modpack_list[component.back()]->iden()+L"\"");
+
+    // Mods of a cycle depend on each other, component is popped from walk
+    // stack so the first discovered Mod comes last
+    for(size_t m = 0; m < component.size(); ++m)
+      closure.push_back(component[m]);
+  }
+
+  for(size_t m = 0; m < component.size(); ++m) {
+
+    depgraph_node_t& node = this->_depgraph[component[m]];
+
+    for(size_t c = 0; c < closure.size(); ++c)
+      if(closure[c] != component[m])
+        node.closure.push_back(closure[c]);
+
+    node.closure_missings = closure_missings;
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+const OmModChan::depgraph_node_t* OmModChan::_depgraph_node(const OmModPack* ModPack) const
+{
+  int32_t i = this->indexOfModpack(ModPack);
+  if(i < 0 || static_cast<size_t>(i) >= this->_depgraph.size())
+    return nullptr;
+
+  return &this->_depgraph[i];
+}
 
-    if(is_missing)
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::isDependency(const OmModPack* ModPack) const
+{
+  auto it = this->_depgraph_rdeps.find(__lookup_key(ModPack->iden()));
+  if(it == this->_depgraph_rdeps.end())
+    return false;
+
+  for(size_t i = 0; i < it->second.size(); ++i) {
+
+    const OmModPack* Dependent = this->_modpack_list[it->second[i]];
+
+    if(ModPack != Dependent && Dependent->hasDepend(ModPack->iden()))
       return true;
   }
 
@@ -1520,36 +2502,47 @@ bool OmModChan::hasMissingDepend(const OmModPack* ModPack) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_modops_depends(const OmModPack* ModPack, OmPModPackArray* depends, OmWStringArray* missings) const
+bool OmModChan::hasMissingDepend(const OmModPack* ModPack) const
 {
-  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
+  const depgraph_node_t* node = this->_depgraph_node(ModPack);
 
-    bool missing = true;
+  if(node)
+    return !node->closure_missings.empty();
 
-    for(size_t j = 0; j < this->_modpack_list.size(); ++j) {
+  // Mod outside library, check its dependencies which are in library
+  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
 
-      // rely only on packages
-      if(this->_modpack_list[j]->sourceIsDir())
-        continue;
+    OmModPack* Depend = this->findModpack(ModPack->getDependIden(i), true);
 
-      if(ModPack->getDependIden(i) == this->_modpack_list[j]->iden()) {
+    if(!Depend || this->hasMissingDepend(Depend))
+      return true;
+  }
 
-        this->_get_modops_depends(this->_modpack_list[j], depends, missings);
+  return false;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_get_modops_depends(const OmModPack* ModPack, OmPModPackArray* depends, OmWStringArray* missings) const
+{
+  const depgraph_node_t* node = this->_depgraph_node(ModPack);
+  if(!node)
+    return;
 
-        // we add to list only if unique and not already installed, this allow
-        // us to get a consistent dependency list for a bunch of package by
-        // calling this function for each package without clearing the list
-        if(!this->_modpack_list[j]->hasBackup())
-          Om_push_backUnique(*depends, this->_modpack_list[j]);
+  for(size_t i = 0; i < node->closure.size(); ++i) {
 
-        missing = false;
-        break;
-      }
-    }
+    OmModPack* Depend = this->_modpack_list[node->closure[i]];
 
-    if(missing)
-      Om_push_backUnique(*missings, ModPack->getDependIden(i));
+    // we add to list only if unique and not already installed, this allow
+    // us to get a consistent dependency list for a bunch of package by
+    // calling this function for each package without clearing the list
+    if(!Depend->hasBackup())
+      Om_push_backUnique(*depends, Depend);
   }
+
+  for(size_t i = 0; i < node->closure_missings.size(); ++i)
+    Om_push_backUnique(*missings, node->closure_missings[i]);
 }
 
 ///
@@ -1557,24 +2550,31 @@ void OmModChan::_get_modops_depends(const OmModPack* ModPack, OmPModPackArray* d
 ///
 void OmModChan::prepareInstalls(const OmPModPackArray& selection, OmPModPackArray* installs, OmWStringArray* overlaps, OmWStringArray* depends, OmWStringArray* missings) const
 {
-  // gather dependencies and create missing lists
-  OmPModPackArray found_depends;
-  for(size_t i = 0; i < selection.size(); ++i)
+  // compose the final install list in topological order, each selected Mod
+  // comes after its not yet installed dependencies, which may be selected
+  // Mods as well
+  std::unordered_set<const OmModPack*> listed;
+
+  for(size_t i = 0; i < selection.size(); ++i) {
+
+    OmPModPackArray found_depends;
     this->_get_modops_depends(selection[i], &found_depends, missings);
 
-  // create the extra install list
-  for(size_t i = 0; i < found_depends.size(); ++i) {
-    if(!Om_arrayContain(selection, found_depends[i])) {
-      // add to installs list
-      installs->push_back(found_depends[i]);
+    for(size_t j = 0; j < found_depends.size(); ++j) {
+
+      if(!listed.insert(found_depends[j]).second)
+        continue;
+
+      installs->push_back(found_depends[j]);
+
       // add to extra depends list
-      depends->push_back(found_depends[i]->iden());
+      if(!Om_arrayContain(selection, found_depends[j]))
+        depends->push_back(found_depends[j]->iden());
     }
-  }
 
-  // compose the final install list
-  for(size_t i = 0; i < selection.size(); ++i)
-    Om_push_backUnique(*installs, selection.at(i));
+    if(listed.insert(selection[i]).second)
+      installs->push_back(selection[i]);
+  }
 
   // get installation footprint of Mods to be installed
   std::vector<OmModEntryArray> footprintArray;
@@ -1584,12 +2584,11 @@ void OmModChan::prepareInstalls(const OmPModPackArray& selection, OmPModPackArra
   for(size_t i = 0; i < installs->size(); ++i) {
 
     // test overlapping against installed Mods
-    for(size_t j = 0; j < this->_modpack_list.size(); ++j) {
-      if(this->_modpack_list[j]->hasBackup()) {
-        if(installs->at(i)->canOverlap(this->_modpack_list[j]))
-          overlaps->push_back(this->_modpack_list[j]->iden());
-      }
-    }
+    OmPModPackArray installed;
+    this->findOverlaps(installs->at(i), &installed);
+
+    for(size_t j = 0; j < installed.size(); ++j)
+      overlaps->push_back(installed[j]->iden());
 
     // test overlapping against Mods to be installed
     for(size_t j = 0; j < footprintArray.size(); ++j) {
@@ -1599,7 +2598,9 @@ void OmModChan::prepareInstalls(const OmPModPackArray& selection, OmPModPackArra
 
     // create installation footprint of package
     footprint.clear();
-    installs->at(i)->getFootprint(&footprint);
+    if(!installs->at(i)->getFootprint(&footprint))
+      this->_log(OM_LOG_ERR, L"prepareInstalls", Om_errLoad(L"Source archive file", installs->at(i)->sourcePath(), L"cannot read entries"));
+
     footprintArray.push_back(footprint);
   }
 }
@@ -1607,34 +2608,196 @@ void OmModChan::prepareInstalls(const OmPModPackArray& selection, OmPModPackArra
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_backup_relations(const OmModPack* ModPack, OmPModPackArray* relations, OmWStringArray* overlappers, OmWStringArray* dependents) const
+void OmModChan::planInstalls(const OmPModPackArray& installs, OmModPlan_t* plan) const
 {
+  plan->backup_files.clear();
+  plan->backup_bytes = 0;
+  plan->comp_bytes = 0;
+  plan->create_dirs.clear();
+  plan->write_files = 0;
+  plan->write_bytes = 0;
+  plan->io_bytes = 0;
+  plan->estimate = -1.0;
+
+  bool bck_isdir = (this->_backup_method < 0);
+
+  // Backup on the same volume than Target is made by renaming files, either
+  // as final directory Backup or as staged files compressed in background
+  bool bck_samevol = (bck_isdir || this->_backup_staging) &&
+                     Om_pathSameVolume(this->_target_path, this->_backup_path);
+
+  // Target items written by previous Mods of the list, as if installed
+  std::unordered_map<uint64_t, uint64_t> planned_files;
+  std::unordered_set<uint64_t> planned_dirs;
+
+  OmWString path;
+
+  for(size_t p = 0; p < installs.size(); ++p) {
+
+    const OmModPack* ModPack = installs[p];
+
+    if(!ModPack->hasSource())
+      continue;
+
+    // only central-directory is read, no data is decompressed
+    OmArchive source_zip;
+
+    if(!ModPack->sourceIsDir()) {
+      if(!source_zip.read(ModPack->sourcePath(), true)) {
+        this->_log(OM_LOG_WRN, L"planInstalls", Om_errLoad(L"Source archive file", ModPack->sourcePath(), source_zip.lastErrorStr()));
+        continue;
+      }
+    }
+
+    // hard links are created instead of copies when possible
+    bool src_link = ModPack->sourceIsDir() && this->_library_hardlink &&
+                    Om_pathSameVolume(ModPack->sourcePath(), this->_target_path);
+
+    size_t count = ModPack->sourceEntryCount();
+
+    // probe Target for existing items using parallel workers
+    OmWStringArray tgt_files(count);
+
+    for(size_t i = 0; i < count; ++i)
+      Om_concatPaths(tgt_files[i], this->_target_path, ModPack->getSourceEntry(i).path);
+
+    std::vector<uint8_t> tgt_exists(count);
+
+    Om_pathExistsMany(tgt_files, tgt_exists.data());
+
+    for(size_t i = 0; i < count; ++i) {
+
+      const OmModEntry_t& entry = ModPack->getSourceEntry(i);
+
+      path = entry.path;
+      Om_strToUpper(&path);
+
+      uint64_t key = Om_getXXHash3(path);
+
+      if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR)) {
+
+        if(!tgt_exists[i] && planned_dirs.insert(key).second)
+          plan->create_dirs.push_back(tgt_files[i]);
+
+        continue;
+      }
+
+      uint64_t src_size;
+
+      if(ModPack->sourceIsDir()) {
+        OmWString src_file;
+        Om_concatPaths(src_file, ModPack->sourcePath(), entry.path);
+        src_size = Om_itemSize(src_file);
+      } else {
+        src_size = source_zip.entrySize(entry.cdid);
+      }
+
+      // existing Target file, or file written by a previous Mod of the
+      // list, is saved to Backup before being overwritten
+      std::unordered_map<uint64_t, uint64_t>::iterator it = planned_files.find(key);
+
+      if(tgt_exists[i] || it != planned_files.end()) {
+
+        uint64_t tgt_size = (it != planned_files.end()) ? it->second : Om_itemSize(tgt_files[i]);
+
+        plan->backup_files.push_back(tgt_files[i]);
+        plan->backup_bytes += tgt_size;
+
+        if(!bck_isdir)
+          plan->comp_bytes += tgt_size;
+
+        // on the same volume files are renamed, and compressed later in
+        // background, otherwise they are copied or compressed right away
+        if(!bck_samevol)
+          plan->io_bytes += tgt_size;
+      }
+
+      planned_files[key] = src_size;
+
+      plan->write_files++;
+
+      if(!src_link) {
+        plan->write_bytes += src_size;
+        plan->io_bytes += src_size;
+      }
+    }
+
+    if(!ModPack->sourceIsDir())
+      source_zip.close();
+  }
+
+  if(this->_modops_rate > 0.0)
+    plan->estimate = static_cast<double>(plan->io_bytes) / this->_modops_rate;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_get_overlap_index(std::unordered_map<uint64_t, OmIndexArray>* overlaps) const
+{
+  // index installed Mods by hash of Mods they overlap
   for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
 
+    const OmModPack* ModPack = this->_modpack_list[i];
+
+    if(!ModPack->hasBackup())
+      continue;
+
+    for(size_t j = 0; j < ModPack->overlapCount(); ++j)
+      (*overlaps)[ModPack->getOverlapHash(j)].push_back(i);
+  }
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_get_backup_relations(const OmModPack* ModPack, const std::unordered_map<uint64_t, OmIndexArray>& overlaps, OmPModPackArray* relations, OmWStringArray* overlappers, OmWStringArray* dependents, std::unordered_set<const OmModPack*>* visited) const
+{
+  // candidates are Mods overlapping or depending on the specified one, in
+  // Library order, from overlap index and dependency graph
+  OmIndexArray candidates;
+
+  auto ot = overlaps.find(ModPack->hash());
+  if(ot != overlaps.end())
+    candidates = ot->second;
+
+  auto dt = this->_depgraph_rdeps.find(__lookup_key(ModPack->iden()));
+  if(dt != this->_depgraph_rdeps.end())
+    candidates.insert(candidates.end(), dt->second.begin(), dt->second.end());
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  for(size_t c = 0; c < candidates.size(); ++c) {
+
+    OmModPack* Relation = this->_modpack_list[candidates[c]];
+
     // search only among installed packages and ignore auto-reference
-    if(!this->_modpack_list[i]->hasBackup() || this->_modpack_list[i] == ModPack)
+    if(!Relation->hasBackup() || Relation == ModPack)
       continue;
 
     // check both if Mod is overlapping and/or depend on
     // the currently specified one
-    bool is_overlapper = this->_modpack_list[i]->hasOverlap(ModPack->hash());
-    bool is_dependent = this->_modpack_list[i]->hasDepend(ModPack->iden());
+    bool is_overlapper = Relation->hasOverlap(ModPack->hash());
+    bool is_dependent = Relation->hasDepend(ModPack->iden());
 
     if(is_overlapper || is_dependent) {
 
       // we go for recursive search to get a properly sorted list of
-      // packages in depth-first search order.
-      this->_get_backup_relations(this->_modpack_list[i], relations, overlappers, dependents);
+      // packages in depth-first search order, each Mod is explored
+      // only once since its relations are already in lists
+      if(visited->insert(Relation).second)
+        this->_get_backup_relations(Relation, overlaps, relations, overlappers, dependents, visited);
 
       // we now add to the proper lists
       if(is_overlapper)
-        Om_push_backUnique(*overlappers, this->_modpack_list[i]->iden());
+        Om_push_backUnique(*overlappers, Relation->iden());
 
       if(is_dependent)
-        Om_push_backUnique(*dependents, this->_modpack_list[i]->iden());
+        Om_push_backUnique(*dependents, Relation->iden());
 
       // finally add to main list
-      Om_push_backUnique(*relations, this->_modpack_list[i]);
+      Om_push_backUnique(*relations, Relation);
     }
   }
 }
@@ -1644,13 +2807,19 @@ void OmModChan::_get_backup_relations(const OmModPack* ModPack, OmPModPackArray*
 ///
 void OmModChan::prepareRestores(const OmPModPackArray& selection, OmPModPackArray* restores, OmWStringArray* overlappers, OmWStringArray* dependents) const
 {
+  // Mods already explored during search
+  std::unordered_set<const OmModPack*> visited;
+
+  // installed Mods indexed by overlapped Mod
+  std::unordered_map<uint64_t, OmIndexArray> overlaps;
+  this->_get_overlap_index(&overlaps);
+
   // get overlapping packages list to be uninstalled before selection
   for(size_t i = 0; i < selection.size(); ++i) {
 
-    // this is the only call we do, but the function is doubly recursive and
-    // can lead to huge complexity depending the actual state of package installation
-    // dependencies and overlapping...
-    this->_get_backup_relations(selection[i], restores, overlappers, dependents);
+    // the function is doubly recursive, visited set prevent exploring
+    // the same Mod relations several times
+    this->_get_backup_relations(selection[i], overlaps, restores, overlappers, dependents, &visited);
 
     // add selection
     Om_push_backUnique(*restores, selection[i]);
@@ -1660,44 +2829,48 @@ void OmModChan::prepareRestores(const OmPModPackArray& selection, OmPModPackArra
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_cleaning_depends(const OmModPack* ModPack, const OmPModPackArray& selection, OmPModPackArray* depends) const
+void OmModChan::_get_cleaning_depends(const OmModPack* ModPack, const OmPModPackArray& selection, OmPModPackArray* depends, std::unordered_set<const OmModPack*>* visited) const
 {
   // recursively found all installed (that have backup) dependencies Mods for the
   // specified Mod, then for each, verify if unused and can be uninstalled along
   // the first specified Mod
 
-  for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
+  const depgraph_node_t* node = this->_depgraph_node(ModPack);
+  if(!node)
+    return;
+
+  for(size_t i = 0; i < node->depends.size(); ++i) {
+
+    OmModPack* Depend = this->_modpack_list[node->depends[i]];
 
     // search only among installed Mods
-    if(!this->_modpack_list[i]->hasBackup() || Om_arrayContain(selection, this->_modpack_list[i]))
+    if(!Depend->hasBackup() || Om_arrayContain(selection, Depend))
       continue;
 
-    if(ModPack->hasDepend(this->_modpack_list[i]->iden())) {
+    bool is_breaking = false;
 
-      bool is_breaking = false;
+    // check whether this dependency Mod can be restored/uninstalled
+    // without breaking sibling dependency install
+    for(size_t j = 0; j < Depend->dependCount(); ++j) {
 
-      // check whether this dependency Mod can be restored/uninstalled
-      // without breaking sibling dependency install
-      for(size_t j = 0; j < this->_modpack_list[i]->dependCount(); ++j) {
+      // try to find this dependency in Mod Library
+      OmModPack* Sibling = this->findModpack(Depend->getDependIden(j));
 
-        // try to find this dependency in Mod Library
-        OmModPack* Sibling = this->findModpack(this->_modpack_list[i]->getDependIden(j));
-
-        // If Mod is found, check whether it is installed, meaning we cannot
-        // restore this dependency yet
-        if(Sibling && Sibling != ModPack && Sibling->hasBackup()) {
-          is_breaking = true; break;
-        }
+      // If Mod is found, check whether it is installed, meaning we cannot
+      // restore this dependency yet
+      if(Sibling && Sibling != ModPack && Sibling->hasBackup()) {
+        is_breaking = true; break;
       }
+    }
 
-      if(!is_breaking) {
+    if(!is_breaking) {
 
-        // check recursively, this give depth-first sorted list
-        this->_get_cleaning_depends(this->_modpack_list[i], selection, depends);
+      // check recursively, this give depth-first sorted list
+      if(visited->insert(Depend).second)
+        this->_get_cleaning_depends(Depend, selection, depends, visited);
 
-        // add only if unique
-        Om_push_backUnique(*depends, this->_modpack_list[i]);
-      }
+      // add only if unique
+      Om_push_backUnique(*depends, Depend);
     }
   }
 }
@@ -1705,7 +2878,7 @@ void OmModChan::_get_cleaning_depends(const OmModPack* ModPack, const OmPModPack
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_cleaning_relations(const OmModPack* ModPack, const OmPModPackArray& selection, OmPModPackArray* relations, OmWStringArray* overlappers) const
+void OmModChan::_get_cleaning_relations(const OmModPack* ModPack, const OmPModPackArray& selection, OmPModPackArray* relations, OmWStringArray* overlappers, std::unordered_set<const OmModPack*>* visited) const
 {
   for(size_t i = 0; i < this->_modpack_list.size(); ++i) {
 
@@ -1721,7 +2894,8 @@ void OmModChan::_get_cleaning_relations(const OmModPack* ModPack, const OmPModPa
 
       // we go for recursive search to get a properly sorted list of
       // packages in depth-first search order.
-      this->_get_cleaning_relations(this->_modpack_list[i], selection, relations, overlappers);
+      if(visited->insert(this->_modpack_list[i]).second)
+        this->_get_cleaning_relations(this->_modpack_list[i], selection, relations, overlappers, visited);
 
       // we now add to the proper lists
       if(is_overlapper)
@@ -1738,18 +2912,22 @@ void OmModChan::_get_cleaning_relations(const OmModPack* ModPack, const OmPModPa
 ///
 void OmModChan::prepareCleaning(const OmPModPackArray& selection, OmPModPackArray* restores, OmWStringArray* depends, OmWStringArray* overlappers, OmWStringArray* dependents) const
 {
+  // Mods already explored during search
+  std::unordered_set<const OmModPack*> visited;
+
   // get list of extra dependencies that can be cleaned with selection
   OmPModPackArray found_depends;
   for(size_t i = 0; i < selection.size(); ++i) {
 
-    this->_get_cleaning_depends(selection[i], selection, &found_depends);
+    this->_get_cleaning_depends(selection[i], selection, &found_depends, &visited);
   }
 
   // get overlappers Mods of the found unused dependencies
+  visited.clear();
   for(size_t i = 0; i < found_depends.size(); ++i) {
 
     // get overlappers packages
-    this->_get_cleaning_relations(found_depends[i], selection, restores, overlappers);
+    this->_get_cleaning_relations(found_depends[i], selection, restores, overlappers, &visited);
 
     if(!Om_arrayContain(selection, found_depends[i])) {
 
@@ -1761,11 +2939,16 @@ void OmModChan::prepareCleaning(const OmPModPackArray& selection, OmPModPackArra
     }
   }
 
+  // installed Mods indexed by overlapped Mod
+  std::unordered_map<uint64_t, OmIndexArray> overlaps;
+  this->_get_overlap_index(&overlaps);
+
   // get overlapping and dependents Mods of the selection
+  visited.clear();
   for(size_t i = 0; i < selection.size(); ++i) {
 
     // get overlappers and dependents
-    this->_get_backup_relations(selection[i], restores, overlappers, dependents);
+    this->_get_backup_relations(selection[i], overlaps, restores, overlappers, dependents, &visited);
 
     // add to restores list
     restores->push_back(selection[i]);
@@ -1826,6 +3009,9 @@ void OmModChan::queueModOps(const OmPModPackArray& selection, Om_beginCb begin_c
   // lock the local library to prevent concurrent array manipulation
   this->_locked_mod_library = true;
 
+  // pending Backup compression must not run concurrently
+  this->_bckcmp_stop();
+
   // reset abort flag
   this->_modops_abort = false;
 
@@ -1880,6 +3066,9 @@ OmResult OmModChan::execModOps(const OmPModPackArray& selection, Om_beginCb begi
   // lock the local library to prevent concurrent array manipulation
   this->_locked_mod_library = true;
 
+  // pending Backup compression must not run concurrently
+  this->_bckcmp_stop();
+
   // reset abort flag
   this->_modops_abort = false;
 
@@ -1902,90 +3091,304 @@ DWORD WINAPI OmModChan::_modops_run_fn(void* ptr)
 
   DWORD exit_code = OM_RESULT_OK;
 
+  // installs I/O are planned once for the whole queue, so the measured
+  // throughput follows the planner cost model
+  OmPModPackArray installs;
+  for(size_t i = 0; i < self->_modops_queue.size(); ++i)
+    if(!self->_modops_queue[i]->hasBackup())
+      installs.push_back(self->_modops_queue[i]);
+
+  OmModPlan_t plan;
+  plan.io_bytes = 0;
+
+  if(!installs.empty())
+    self->planInstalls(installs, &plan);
+
+  // installs duration, measure is relevant only if all succeed
+  double io_time = 0.0;
+  bool io_valid = true;
+
   #ifdef DEBUG
   std::wcout << "DEBUG => OmModChan::_modops_run_fn : enter\n";
   #endif // DEBUG
 
-  while(self->_modops_queue.size()) {
+  while(self->_modops_queue.size()) {
+
+    if(self->_modops_abort) {
+
+      // flush all queue with abort result
+
+      if(!self->_modops_queue.front()->hasBackup())
+        io_valid = false;
+
+      if(self->_modops_result_cb)
+        self->_modops_result_cb(self->_modops_user_ptr, OM_RESULT_ABORT, reinterpret_cast<uint64_t>(self->_modops_queue.front()));
+
+      self->_modops_queue.pop_front();
+
+      continue;
+    }
+
+    // select next Mod Packs to be processed concurrently
+    OmPModPackArray wave;
+    self->_modops_wave(&wave);
+
+    modops_work_t works[MODOPS_MAX_WORKERS];
+
+    for(size_t i = 0; i < wave.size(); ++i) {
+
+      works[i].ModChan = self;
+      works[i].ModPack = wave[i];
+      works[i].restore = wave[i]->hasBackup();
+      works[i].result = OM_RESULT_OK;
+
+      // call client result callback so it can perform proper operations
+      if(self->_modops_begin_cb)
+        self->_modops_begin_cb(self->_modops_user_ptr, reinterpret_cast<uint64_t>(wave[i]));
+    }
+
+    clock_t wave_time = clock();
+
+    if(wave.size() == 1) {
+
+      // single operation is processed by this thread
+      works[0].result = __modops_exec(wave[0], OmModChan::_modops_progress_fn, self);
+
+    } else {
+
+      HANDLE hthreads[MODOPS_MAX_WORKERS];
+      DWORD hthreads_count = 0;
+
+      for(size_t i = 0; i < wave.size(); ++i) {
+        HANDLE hth = Om_threadCreate(OmModChan::_modops_work_fn, &works[i]);
+        if(hth) {
+          hthreads[hthreads_count++] = hth;
+        } else {
+          OmModChan::_modops_work_fn(&works[i]); //< no thread, process here
+        }
+      }
+
+      // wait for workers, progression callback is called from this thread,
+      // which may be the UI thread so sent messages must be dispatched
+      while(hthreads_count) {
+
+        DWORD result = MsgWaitForMultipleObjects(hthreads_count, hthreads, FALSE, MODOPS_POLL_DELAY, QS_SENDMESSAGE);
+
+        if(result == WAIT_OBJECT_0 + hthreads_count) {
+          MSG msg; PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE);
+          continue;
+        }
+
+        for(size_t i = 0; i < wave.size(); ++i)
+          OmModChan::_modops_progress_fn(self, 0, 0, reinterpret_cast<uint64_t>(wave[i]));
+
+        if(result < WAIT_OBJECT_0 + hthreads_count) {
+          // remove ended worker
+          DWORD t = result - WAIT_OBJECT_0;
+          CloseHandle(hthreads[t]);
+          hthreads[t] = hthreads[--hthreads_count];
+        } else if(result != WAIT_TIMEOUT) {
+          // should never happen, wait without dispatching
+          WaitForMultipleObjects(hthreads_count, hthreads, TRUE, INFINITE);
+          break;
+        }
+      }
+
+      for(DWORD t = 0; t < hthreads_count; ++t)
+        CloseHandle(hthreads[t]);
+    }
+
+    wave_time = clock() - wave_time;
+
+    bool wave_ok = true;
+    for(size_t i = 0; i < wave.size(); ++i)
+      if(works[i].result != OM_RESULT_OK) wave_ok = false;
+
+    if(!works[0].restore) {
+      if(wave_ok) {
+        io_time += static_cast<double>(wave_time) / CLOCKS_PER_SEC;
+      } else {
+        io_valid = false;
+      }
+    }
+
+    // update footprint index with new Backup status
+    for(size_t i = 0; i < wave.size(); ++i)
+      self->indexFootprint(wave[i]);
+
+    // refresh analytical parameters of Mod Packs affected by the wave
+    self->_fpidx_refresh();
+
+    for(size_t i = 0; i < wave.size(); ++i) {
+
+      OmModPack* ModPack = wave[i];
+
+      OmResult result = works[i].result;
+
+      // call client result callback so it can perform proper operations
+      if(self->_modops_result_cb)
+        self->_modops_result_cb(self->_modops_user_ptr, result, reinterpret_cast<uint64_t>(ModPack));
+
+      if(result != OM_RESULT_OK) {
+
+        exit_code = result;
+
+        if(!works[i].restore) {
+
+          // restore any stored Backup data
+          ModPack->restoreData(OmModChan::_modops_progress_fn, self, true);
+          self->indexFootprint(ModPack);
+
+          // reset progression status
+          if(self->_modops_progress_cb)
+            self->_modops_progress_cb(self->_modops_user_ptr, 0, 0, reinterpret_cast<uint64_t>(ModPack));
+        }
+
+        if(result == OM_RESULT_ABORT)
+          self->_modops_abort = true;
+      }
+
+      self->_modops_dones++;
+
+      for(size_t q = 0; q < self->_modops_queue.size(); ++q) {
+        if(self->_modops_queue[q] == ModPack) {
+          self->_modops_queue.erase(self->_modops_queue.begin() + q); break;
+        }
+      }
+    }
+  }
+
+  // Mod Packs affected by undone installs
+  self->_fpidx_refresh();
+
+  if(io_valid)
+    self->_modops_rate_update(plan.io_bytes, io_time);
+
+  #ifdef DEBUG
+  std::wcout << "DEBUG => OmModChan::_modops_run_fn : leave\n";
+  #endif // DEBUG
+
+  return exit_code;
+}
 
-    OmModPack* ModPack = self->_modops_queue.front();
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_modops_rate_update(uint64_t bytes, double secs)
+{
+  // too short operations does not give relevant measure
+  if(secs < 0.1 || !bytes)
+    return;
 
-    if(self->_modops_abort) {
+  double rate = static_cast<double>(bytes) / secs;
 
-      // flush all queue with abort result
+  // smooth with previous measures, disk cache makes throughput vary a lot
+  if(this->_modops_rate > 0.0) {
+    this->_modops_rate = (this->_modops_rate * 0.75) + (rate * 0.25);
+  } else {
+    this->_modops_rate = rate;
+  }
+}
 
-      if(self->_modops_result_cb)
-        self->_modops_result_cb(self->_modops_user_ptr, OM_RESULT_ABORT, reinterpret_cast<uint64_t>(ModPack));
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_modops_rate_save()
+{
+  if(!this->_xml.valid() || this->_modops_rate <= 0.0)
+    return;
 
-      self->_modops_queue.pop_front();
+  if(this->_xml.hasChild(L"modops_rate")) {
+    if(this->_xml.child(L"modops_rate").attrAsDouble(L"bps") == this->_modops_rate)
+      return;
+    this->_xml.child(L"modops_rate").setAttr(L"bps", this->_modops_rate);
+  } else {
+    this->_xml.addChild(L"modops_rate").setAttr(L"bps", this->_modops_rate);
+  }
 
-      continue;
-    }
+  this->_xml.save();
+}
 
-    // call client result callback so it can perform proper operations
-    if(self->_modops_begin_cb)
-      self->_modops_begin_cb(self->_modops_user_ptr, reinterpret_cast<uint64_t>(ModPack));
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_modops_wave(OmPModPackArray* wave)
+{
+  // Mod Packs are taken in queue order, a Mod Pack joins the wave only if its
+  // footprint does not intersect footprint of any previous Mod Pack in queue,
+  // either selected or left for a later wave, so operations order on shared
+  // paths is preserved. Installs and restores never run in the same wave since
+  // installs look up Backup entries that restores modify.
+  //
+  // Written paths are exclusive while walked through directories are shared,
+  // so Mod Packs writing files in the same existing directory may run in the
+  // same wave, but not along with one creating or removing that directory.
+  std::unordered_set<uint64_t> claimed;
+  std::unordered_set<uint64_t> crossed;
 
-    OmResult result;
+  bool restore = this->_modops_queue.front()->hasBackup();
 
-    if(ModPack->hasBackup()) {
+  OmUint64Array keys;
+  std::unordered_set<uint64_t> dirs;
 
-      // This is a Restore operation
-      result = ModPack->restoreData(OmModChan::_modops_progress_fn, self);
+  for(size_t i = 0; i < this->_modops_queue.size(); ++i) {
 
-      // refresh Mod Packs analytical parameters
-      self->refreshModLibrary();
+    if(wave->size() >= MODOPS_MAX_WORKERS)
+      break;
 
-      // call client result callback so it can perform proper operations
-      if(self->_modops_result_cb)
-        self->_modops_result_cb(self->_modops_user_ptr, result, reinterpret_cast<uint64_t>(ModPack));
-
-      if(result != OM_RESULT_OK) {
-        exit_code = result;
-        if(result == OM_RESULT_ABORT)
-          self->_modops_abort = true;
-      }
+    OmModPack* ModPack = this->_modops_queue[i];
 
-    } else {
+    keys.clear();
+    dirs.clear();
+    __modops_footprint(ModPack, this->_target_path, &keys, &dirs);
 
-      // This is an Install operation
-      result = ModPack->makeBackup(OmModChan::_modops_progress_fn, self);
-      if(result == OM_RESULT_OK)
-        result = ModPack->applySource(OmModChan::_modops_progress_fn, self);
+    bool conflict = false;
 
-      // refresh Mod Packs analytical parameters
-      self->refreshModLibrary();
+    for(size_t k = 0; k < keys.size(); ++k) {
+      if(claimed.count(keys[k]) || crossed.count(keys[k])) {
+        conflict = true; break;
+      }
+    }
 
-      // call client result callback so it can perform proper operations
-      if(self->_modops_result_cb)
-        self->_modops_result_cb(self->_modops_user_ptr, result, reinterpret_cast<uint64_t>(ModPack));
+    if(!conflict) {
+      for(std::unordered_set<uint64_t>::const_iterator it = dirs.begin(); it != dirs.end(); ++it) {
+        if(claimed.count(*it)) {
+          conflict = true; break;
+        }
+      }
+    }
 
-      if(result != OM_RESULT_OK) {
-
-        exit_code = result;
+    claimed.insert(keys.begin(), keys.end());
+    crossed.insert(dirs.begin(), dirs.end());
 
-        // restore any stored Backup data
-        ModPack->restoreData(OmModChan::_modops_progress_fn, self, true);
+    if(!conflict && ModPack->hasBackup() == restore)
+      wave->push_back(ModPack);
+  }
+}
 
-        // reset progression status
-        if(self->_modops_progress_cb)
-          self->_modops_progress_cb(self->_modops_user_ptr, 0, 0, reinterpret_cast<uint64_t>(ModPack));
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+DWORD WINAPI OmModChan::_modops_work_fn(void* ptr)
+{
+  modops_work_t* work = static_cast<modops_work_t*>(ptr);
 
-        if(result == OM_RESULT_ABORT)
-          self->_modops_abort = true;
-      }
+  work->result = __modops_exec(work->ModPack, OmModChan::_modops_work_progress_fn, work->ModChan);
 
-    }
+  return 0;
+}
 
-    self->_modops_dones++;
-    self->_modops_queue.pop_front();
-  }
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::_modops_work_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  OM_UNUSED(tot); OM_UNUSED(cur); OM_UNUSED(param);
 
-  #ifdef DEBUG
-  std::wcout << "DEBUG => OmModChan::_modops_run_fn : leave\n";
-  #endif // DEBUG
+  OmModChan* self = static_cast<OmModChan*>(ptr);
 
-  return exit_code;
+  // client is notified by the polling thread, workers only check abort
+  return !self->_modops_abort;
 }
 
 ///
@@ -2024,6 +3427,9 @@ VOID WINAPI OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
 
   // clean potential ghost packages, that may appear after restores
   self->ghostbusterModLibrary();
+
+  // store throughput measured by operations
+  self->_modops_rate_save();
 
   // unlock the local library
   self->_locked_mod_library = false;
@@ -2041,11 +3447,111 @@ VOID WINAPI OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
   self->_modops_hth = nullptr;
   self->_modops_hwo = nullptr;
 
-  self->_modops_user_ptr = nullptr;
+  self->_modops_user_ptr = nullptr;
   self->_modops_begin_cb = nullptr;
   self->_modops_progress_cb = nullptr;
-  self->_modops_result_cb = nullptr;
+  self->_modops_result_cb = nullptr;
   self->_modops_notify_cb = nullptr;
+
+  // compress Backups staged by installations
+  self->_bckcmp_start();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_bckcmp_start()
+{
+  // this may be called from UI thread and end callback of operations
+  EnterCriticalSection(&this->_bckcmp_lock);
+
+  this->_bckcmp_stop();
+
+  for(size_t i = 0; i < this->_modpack_list.size(); ++i)
+    if(this->_modpack_list[i]->backupIsStaged())
+      this->_bckcmp_queue.push_back(this->_modpack_list[i]);
+
+  if(!this->_bckcmp_queue.empty()) {
+
+    this->_bckcmp_abort = false;
+
+    // launch thread
+    this->_bckcmp_hth = Om_threadCreate(OmModChan::_bckcmp_run_fn, this);
+  }
+
+  LeaveCriticalSection(&this->_bckcmp_lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_bckcmp_stop()
+{
+  EnterCriticalSection(&this->_bckcmp_lock);
+
+  if(this->_bckcmp_hth) {
+
+    // compression is aborted between two files, staged Backup stay valid
+    this->_bckcmp_abort = true;
+
+    // compression thread may log, thus send messages to UI windows, so sent
+    // messages are dispatched while waiting
+    HANDLE hth = static_cast<HANDLE>(this->_bckcmp_hth);
+    while(MsgWaitForMultipleObjects(1, &hth, FALSE, INFINITE, QS_SENDMESSAGE) == WAIT_OBJECT_0 + 1) {
+      MSG msg;
+      PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE);
+    }
+
+    Om_threadClear(this->_bckcmp_hth, nullptr);
+    this->_bckcmp_hth = nullptr;
+  }
+
+  this->_bckcmp_queue.clear();
+
+  LeaveCriticalSection(&this->_bckcmp_lock);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+DWORD WINAPI OmModChan::_bckcmp_run_fn(void* ptr)
+{
+  OmModChan* self = static_cast<OmModChan*>(ptr);
+
+  #ifdef DEBUG
+  std::wcout << "DEBUG => OmModChan::_bckcmp_run_fn : enter\n";
+  #endif // DEBUG
+
+  // low CPU and I/O priority, this must not slow down user operations
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+  for(size_t i = 0; i < self->_bckcmp_queue.size(); ++i) {
+
+    if(self->_bckcmp_abort)
+      break;
+
+    self->_bckcmp_queue[i]->compressBackup(OmModChan::_bckcmp_progress_fn, self);
+  }
+
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+
+  #ifdef DEBUG
+  std::wcout << "DEBUG => OmModChan::_bckcmp_run_fn : leave\n";
+  #endif // DEBUG
+
+  return 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModChan::_bckcmp_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  OM_UNUSED(tot); OM_UNUSED(cur); OM_UNUSED(param);
+
+  OmModChan* self = static_cast<OmModChan*>(ptr);
+
+  return !self->_bckcmp_abort;
 }
 
 ///
@@ -2053,6 +3559,9 @@ VOID WINAPI OmModChan::_modops_end_fn(void* ptr, uint8_t fired)
 ///
 bool OmModChan::discardBackups(const OmPModPackArray& selection, Om_progressCb progress_cb, void* user_ptr)
 {
+  // Backups to discard may be currently compressed
+  this->_bckcmp_stop();
+
   bool has_error = false;
 
   for(size_t i = 0; i < selection.size(); ++i) {
@@ -2062,14 +3571,20 @@ bool OmModChan::discardBackups(const OmPModPackArray& selection, Om_progressCb p
     if(ModPack->hasBackup()) {
       if(ModPack->discardBackup() == OM_RESULT_ERROR)
         has_error = true;
+
+      this->indexFootprint(ModPack);
     }
 
     if(progress_cb)
       progress_cb(user_ptr, selection.size(), i, reinterpret_cast<uint64_t>(selection[i]));
   }
 
-  // refresh Mod Packs analytical parameters
-  this->refreshModLibrary();
+  // refresh analytical parameters of Mod Packs affected by discard
+  this->_fpidx_refresh();
+
+  // resume compression of remaining staged Backups
+  if(!this->_locked_mod_library)
+    this->_bckcmp_start();
 
   return !has_error;
 }
@@ -2095,6 +3610,8 @@ void OmModChan::clearNetLibrary()
     delete this->_netpack_list[i];
 
   this->_netpack_list.clear();
+
+  this->_netpack_index_build();
 }
 
 
@@ -2129,9 +3646,9 @@ bool OmModChan::refreshNetLibrary()
 ///
 OmNetPack* OmModChan::findNetpack(uint64_t hash) const
 {
-  for(size_t i = 0; i < this->_netpack_list.size(); ++i)
-    if(this->_netpack_list[i]->hash() == hash)
-      return this->_netpack_list[i];
+  auto it = this->_netpack_hash_idx.find(hash);
+  if(it != this->_netpack_hash_idx.end())
+    return this->_netpack_list[it->second.front()];
 
   return nullptr;
 }
@@ -2141,9 +3658,14 @@ OmNetPack* OmModChan::findNetpack(uint64_t hash) const
 ///
 OmNetPack* OmModChan::findNetpack(const OmWString& iden) const
 {
-  for(size_t i = 0; i < this->_netpack_list.size(); ++i)
-    if(this->_netpack_list[i]->iden() == iden)
-      return this->_netpack_list[i];
+  auto it = this->_netpack_iden_idx.find(__lookup_key(iden));
+  if(it == this->_netpack_iden_idx.end())
+    return nullptr;
+
+  // index is case-insensitive, search remains case-sensitive
+  for(size_t i = 0; i < it->second.size(); ++i)
+    if(this->_netpack_list[it->second[i]]->iden() == iden)
+      return this->_netpack_list[it->second[i]];
 
   return nullptr;
 }
@@ -2153,9 +3675,9 @@ OmNetPack* OmModChan::findNetpack(const OmWString& iden) const
 ///
 int32_t OmModChan::indexOfNetpack(const OmNetPack* NetPack) const
 {
-  for(size_t i = 0; i < this->_netpack_list.size(); ++i)
-    if(this->_netpack_list[i] == NetPack)
-      return i;
+  auto it = this->_netpack_ptr_idx.find(NetPack);
+  if(it != this->_netpack_ptr_idx.end())
+    return it->second;
 
   return -1;
 }
@@ -2163,36 +3685,58 @@ int32_t OmModChan::indexOfNetpack(const OmNetPack* NetPack) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_missing_depends(const OmModPack* ModPack, OmWStringArray* missings) const
+void OmModChan::_netpack_index_add(size_t i)
 {
-  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
+  const OmNetPack* NetPack = this->_netpack_list[i];
 
-    bool is_missing = true;
+  this->_netpack_hash_idx[NetPack->hash()].push_back(i);
+  this->_netpack_iden_idx[__lookup_key(NetPack->iden())].push_back(i);
+  this->_netpack_ptr_idx[NetPack] = i;
+}
 
-    for(size_t m = 0; m < this->_modpack_list.size(); ++m) {
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_netpack_index_build()
+{
+  this->_netpack_hash_idx.clear();
+  this->_netpack_iden_idx.clear();
+  this->_netpack_ptr_idx.clear();
 
-      // ignore directory Mods
-      if(this->_modpack_list[m]->sourceIsDir())
-        continue;
+  for(size_t i = 0; i < this->_netpack_list.size(); ++i)
+    this->_netpack_index_add(i);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::_get_missing_depends(const OmModPack* ModPack, OmWStringArray* missings) const
+{
+  const depgraph_node_t* node = this->_depgraph_node(ModPack);
 
-      if(ModPack->getDependIden(i) == this->_modpack_list[m]->iden()) {
+  if(node) {
+    for(size_t i = 0; i < node->closure_missings.size(); ++i)
+      Om_push_backUnique(*missings, node->closure_missings[i]);
+    return;
+  }
 
-        this->_get_missing_depends(ModPack, missings);
+  // Mod outside library, check its dependencies which are in library
+  for(size_t i = 0; i < ModPack->dependCount(); ++i) {
 
-        is_missing = false;
-        break;
-      }
-    }
+    OmModPack* Depend = this->findModpack(ModPack->getDependIden(i), true);
 
-    if(is_missing)
+    if(Depend) {
+      this->_get_missing_depends(Depend, missings);
+    } else {
       Om_push_backUnique(*missings, ModPack->getDependIden(i));
+    }
   }
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::_get_source_downloads(const OmModPack* ModPack, OmPNetPackArray* downloads, OmWStringArray* missings) const
+void OmModChan::_get_source_downloads(const OmModPack* ModPack, OmPNetPackArray* downloads, OmWStringArray* missings, std::unordered_set<const OmNetPack*>* visited) const
 {
   // get all missing dependencies for this package
   OmWStringArray missing_depends;
@@ -2205,83 +3749,76 @@ void OmModChan::_get_source_downloads(const OmModPack* ModPack, OmPNetPackArray*
   // try to found packages in the network library list
   for(size_t i = 0; i < missing_depends.size(); ++i) {
 
-    bool is_missing = true;
+    OmNetPack* Depend = this->findNetpack(missing_depends.at(i));
 
-    for(size_t n = 0; n < this->_netpack_list.size(); ++n) {
+    if(Depend) {
 
-      if(missing_depends.at(i) == this->_netpack_list[n]->iden()) {
+      // add Mod dependencies
+      if(visited->insert(Depend).second)
+        this->_get_net_depends(Depend, downloads, missings, visited);
 
-        // add Mod dependencies
-        this->getDepends(this->_netpack_list[n], downloads, missings);
+      // add Mod itslef
+      Om_push_backUnique(*downloads, Depend);
 
-        // add Mod itslef
-        Om_push_backUnique(*downloads, this->_netpack_list[n]);
-
-        is_missing = false;
-      }
-    }
+    } else {
 
-    if(is_missing)
       Om_push_backUnique(*missings, missing_depends.at(i));
+    }
   }
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModChan::getDepends(const OmNetPack* NetPack, OmPNetPackArray* depends, OmWStringArray* missings) const
+void OmModChan::_get_net_depends(const OmNetPack* NetPack, OmPNetPackArray* depends, OmWStringArray* missings, std::unordered_set<const OmNetPack*>* visited) const
 {
   // first check required dependency in local library to
   // gather all missing dependencies, this will add dependencies
   // to found in the remote package list
   for(size_t i = 0; i < NetPack->dependCount(); ++i) {
 
-    bool in_library = false;
-
     // first check whether required dependency is in package library
-    for(size_t m = 0; m < this->_modpack_list.size(); ++m) {
-
-      // ignore directories
-      if(this->_modpack_list[m]->sourceIsDir())
-        continue;
-
-      // if we found package, we must verify its dependencies list
-      if(NetPack->getDependIden(i) == this->_modpack_list[m]->iden()) {
+    OmModPack* ModPack = this->findModpack(NetPack->getDependIden(i), true);
 
-        // get all available dependencies for this Mod
-        this->_get_source_downloads(this->_modpack_list[m], depends, missings);
+    // if we found package, we must verify its dependencies list
+    if(ModPack) {
 
-        in_library = true;
+      // get all available dependencies for this Mod
+      this->_get_source_downloads(ModPack, depends, missings, visited);
 
-        break;
-      }
+      continue; //< skip since already in library
     }
 
-    if(in_library) //< skip if already in library
-      continue;
-
-    bool is_missing = true;
-
-    for(size_t n = 0; n < this->_netpack_list.size(); ++n) {
+    OmNetPack* Depend = this->findNetpack(NetPack->getDependIden(i));
 
-      if(NetPack->getDependIden(i) == this->_netpack_list[n]->iden()) {
+    if(Depend) {
 
-        // add Mod dependencies
-        this->getDepends(this->_netpack_list[n], depends, missings);
+      // add Mod dependencies, each Net Pack is explored only once
+      // which also prevent infinite recursion with cyclic dependencies
+      if(visited->insert(Depend).second)
+        this->_get_net_depends(Depend, depends, missings, visited);
 
-        // add Mod itslef
-        Om_push_backUnique(*depends, this->_netpack_list[n]);
+      // add Mod itslef
+      Om_push_backUnique(*depends, Depend);
 
-        is_missing = false;
-        break;
-      }
-    }
+    } else {
 
-    if(is_missing)
       Om_push_backUnique(*missings, NetPack->getDependIden(i));
+    }
   }
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::getDepends(const OmNetPack* NetPack, OmPNetPackArray* depends, OmWStringArray* missings) const
+{
+  std::unordered_set<const OmNetPack*> visited;
+  visited.insert(NetPack);
+
+  this->_get_net_depends(NetPack, depends, missings, &visited);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -2625,6 +4162,9 @@ void OmModChan::queueUpgrades(const OmPNetPackArray& selection, Om_beginCb begin
   // lock the local library to prevent concurrent array manipulation
   this->_locked_mod_library = true;
 
+  // pending Backup compression must not run concurrently
+  this->_bckcmp_stop();
+
   // reset abort flag
   this->_upgrade_abort = false;
 
@@ -2760,6 +4300,9 @@ VOID WINAPI OmModChan::_upgrade_end_fn(void* ptr, uint8_t fired)
   self->_upgrade_result_cb = nullptr;
   self->_upgrade_notify_cb = nullptr;
   self->_upgrade_begin_cb = nullptr;
+
+  // compress Backups staged by installations
+  self->_bckcmp_start();
 }
 
 ///
@@ -2941,6 +4484,9 @@ void OmModChan::sortNetLibrary()
     std::reverse(this->_netpack_list.begin(), this->_netpack_list.end());
   }
 
+  // list order changed, lookup indices must be rebuilt
+  this->_netpack_index_build();
+
   if(this->_netpack_notify_cb)
     this->_netpack_notify_cb(this->_netpack_notify_ptr, OM_NOTIFY_REBUILD, 0);
 }
@@ -3087,6 +4633,8 @@ void OmModChan::removeRepository(size_t index)
     }
   }
 
+  this->_netpack_index_build();
+
   // delete object and remove it from local list
   delete NetRepo;
   this->_repository_list.erase(this->_repository_list.begin() + index);
@@ -3233,6 +4781,8 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
         }
       }
 
+      self->_netpack_index_build();
+
       // 2. parse and add referenced Mods in lists
       for(size_t r = 0; r < NetRepo->referenceCount(); ++r) {
 
@@ -3241,20 +4791,24 @@ DWORD WINAPI OmModChan::_query_run_fn(void* ptr)
         if(NetPack->parseReference(NetRepo, r)) {
 
           // we want to be sure Net Pack is unique in list
-          bool is_unique = true;
+          OmNetPack* Previous = self->findNetpack(NetPack->iden());
 
-          for(size_t j = 0; j < self->_netpack_list.size(); ++j) {
+          if(Previous) {
 
-            if(self->_netpack_list[j]->iden() == NetPack->iden()) {
+            int32_t j = self->indexOfNetpack(Previous);
 
-              delete self->_netpack_list[j]; //< remove previous
-              self->_netpack_list[j] = NetPack; //< replace object
-              is_unique = false; break;
-            }
-          }
+            // same identity, only object changes, list is sorted later
+            self->_netpack_ptr_idx.erase(Previous);
+            self->_netpack_ptr_idx[NetPack] = j;
+
+            delete Previous; //< remove previous
+            self->_netpack_list[j] = NetPack; //< replace object
+
+          } else {
 
-          if(is_unique)
             self->_netpack_list.push_back(NetPack);
+            self->_netpack_index_add(self->_netpack_list.size() - 1);
+          }
 
         } else {
 
@@ -3500,6 +5054,9 @@ OmResult OmModChan::setCustBackupPath(const OmWString& path)
 
   if(!Om_namesMatches(this->_backup_path, path)) {
 
+    // Backups must not be written while moved
+    this->_bckcmp_stop();
+
     // move content from old to new backup directory
     OmWStringArray items;
     Om_lsAll(&items, this->_backup_path);
@@ -3561,6 +5118,9 @@ OmResult OmModChan::setDefBackupPath()
 
   if(!Om_namesMatches(this->_backup_path, default_path)) {
 
+    // Backups must not be written while moved
+    this->_bckcmp_stop();
+
     // move content from old to new backup directory
     OmWStringArray items;
     Om_lsAll(&items, this->_backup_path);
@@ -3618,6 +5178,44 @@ void OmModChan::setLibraryDevmod(bool enable)
   this->reloadModLibrary();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::setLibraryHardlink(bool enable)
+{
+  if(!this->_xml.valid())
+    return;
+
+  this->_library_hardlink = enable;
+
+  if(this->_xml.hasChild(L"library_hardlink")) {
+    this->_xml.child(L"library_hardlink").setAttr(L"enable", this->_library_hardlink ? 1 : 0);
+  } else {
+    this->_xml.addChild(L"library_hardlink").setAttr(L"enable", this->_library_hardlink ? 1 : 0);
+  }
+
+  this->_xml.save();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::setLibrarySkipsame(bool enable)
+{
+  if(!this->_xml.valid())
+    return;
+
+  this->_library_skipsame = enable;
+
+  if(this->_xml.hasChild(L"library_skipsame")) {
+    this->_xml.child(L"library_skipsame").setAttr(L"enable", this->_library_skipsame ? 1 : 0);
+  } else {
+    this->_xml.addChild(L"library_skipsame").setAttr(L"enable", this->_library_skipsame ? 1 : 0);
+  }
+
+  this->_xml.save();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -3773,6 +5371,44 @@ void OmModChan::setBackupComp(int32_t method, int32_t level)
   this->_xml.save();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::setBackupStaging(bool enable)
+{
+  if(!this->_xml.valid())
+    return;
+
+  this->_backup_staging = enable;
+
+  if(this->_xml.hasChild(L"backup_staging")) {
+    this->_xml.child(L"backup_staging").setAttr(L"enable", this->_backup_staging ? 1 : 0);
+  } else {
+    this->_xml.addChild(L"backup_staging").setAttr(L"enable", this->_backup_staging ? 1 : 0);
+  }
+
+  this->_xml.save();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void OmModChan::setBackupAdaptive(bool enable)
+{
+  if(!this->_xml.valid())
+    return;
+
+  this->_backup_adaptive = enable;
+
+  if(this->_xml.hasChild(L"backup_adaptive")) {
+    this->_xml.child(L"backup_adaptive").setAttr(L"enable", this->_backup_adaptive ? 1 : 0);
+  } else {
+    this->_xml.addChild(L"backup_adaptive").setAttr(L"enable", this->_backup_adaptive ? 1 : 0);
+  }
+
+  this->_xml.save();
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
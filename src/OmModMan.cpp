@@ -52,7 +52,8 @@ OmModMan::OmModMan() :
   _icon_size(16),
   _no_markdown(false)
 {
-
+  // Mod operations may log from several threads
+  InitializeCriticalSection(&this->_log_lock);
 }
 
 ///
@@ -67,6 +68,8 @@ OmModMan::~OmModMan()
   if(this->_log_hfile) {
     CloseHandle(this->_log_hfile);
   }
+
+  DeleteCriticalSection(&this->_log_lock);
 }
 
 ///
@@ -1122,6 +1125,9 @@ void OmModMan::_log(unsigned level, const OmWString& origin, const OmWString& de
   for(size_t i = 0; i < this->_log_notify_cb.size(); ++i)
     this->_log_notify_cb[i](this->_log_user_ptr[i], OM_NOTIFY_CREATED, reinterpret_cast<uint64_t>(log_entry.c_str()));
 
+  // callbacks may wait for another thread, only log storage is serialized
+  EnterCriticalSection(&this->_log_lock);
+
   // write to log file
   if(this->_log_hfile) {
 
@@ -1133,6 +1139,8 @@ void OmModMan::_log(unsigned level, const OmWString& origin, const OmWString& de
   }
 
   this->_log_str += log_entry;
+
+  LeaveCriticalSection(&this->_log_lock);
 }
 
 ///
@@ -22,10 +22,12 @@
 #include "OmUtilFs.h"
 #include "OmUtilStr.h"
 #include "OmUtilErr.h"
+#include "OmUtilWin.h"
 #include "OmUtilHsh.h"
 #include "OmUtilPkg.h"
 #include "OmUtilB64.h"
 #include <ctime>
+#include <unordered_map>
 
 #include "OmModChan.h"
 
@@ -37,6 +39,229 @@
 #define SAVEAS_README_NAME      L"readme.md"
 #define SAVEAS_MODDEF_NAME      L"modpack.xml"
 
+/// \brief Batch progression relay
+///
+/// Structure used to relay per-entry progression of OmArchive batch
+/// operations to the Mod Pack operation progression callback.
+///
+typedef struct batch_progress_
+{
+  Om_progressCb   progress_cb;
+
+  void*           user_ptr;
+
+  size_t          tot;        //< operation progression total
+
+  size_t          base;       //< operation progression before batch
+
+  uint64_t        param;      //< parameter passed to callback
+
+  uint32_t*       percent;    //< optional progression percent to update
+
+  bool            aborted;    //< callback returned false
+
+  bool            reverse;    //< progression goes backward from base
+
+} batch_progress_t;
+
+/// \brief Batch progression relay function
+///
+/// Progression callback given to OmArchive batch operations which relays
+/// progression to Mod Pack operation callback.
+///
+static bool __batch_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  OM_UNUSED(tot); OM_UNUSED(param);
+
+  batch_progress_t* relay = static_cast<batch_progress_t*>(ptr);
+
+  size_t progress_cur = relay->reverse ? relay->base - cur : relay->base + cur;
+
+  if(relay->percent)
+    *relay->percent = ((double)progress_cur / relay->tot) * 100;
+
+  if(!relay->progress_cb(relay->user_ptr, relay->tot, progress_cur, relay->param)) {
+    relay->aborted = true;
+    return false;
+  }
+
+  return true;
+}
+
+/// \brief Restore progression relay function
+///
+/// Progression callback given to OmArchive batch operations while restoring
+/// Backup data, it relays progression like the batch relay function but
+/// never stops the batch, abort is only recorded to be reported later.
+///
+static bool __restore_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  __batch_progress_fn(ptr, tot, cur, param);
+
+  return true;
+}
+
+/// \brief Save-as progression relay
+///
+/// Structure used to relay per-entry progression of OmArchive batch add
+/// to both Mod Pack operation and compression progression callbacks.
+///
+typedef struct saveas_progress_
+{
+  batch_progress_t  batch;      //< operation progression relay
+
+  Om_progressCb     compress_cb;
+
+} saveas_progress_t;
+
+/// \brief Save-as progression relay function
+///
+/// Progression callback given to OmArchive batch add while saving directory
+/// Source, each added entry is reported to compression callback with its
+/// name, then relayed to Mod Pack operation callback.
+///
+static bool __saveas_progress_fn(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  saveas_progress_t* relay = static_cast<saveas_progress_t*>(ptr);
+
+  if(relay->compress_cb) {
+    if(!relay->compress_cb(relay->batch.user_ptr, tot, cur, param)) {
+      relay->batch.aborted = true;
+      return false;
+    }
+  }
+
+  if(relay->batch.progress_cb)
+    return __batch_progress_fn(&relay->batch, tot, cur, param);
+
+  return true;
+}
+
+/// \brief Adaptive compression report
+///
+/// Composes report string about entries the given written archive stored
+/// without compression because their data is already compressed.
+///
+/// \param[out] str     : Pointer to string to receive report.
+/// \param[in]  zip     : Written archive to get statistics from.
+///
+/// \return True if some entries were stored, false otherwise.
+///
+static bool __adapt_report(OmWString* str, const OmArchive& zip)
+{
+  uint64_t count, size;
+  zip.adaptStats(&count, &size);
+
+  if(!count)
+    return false;
+
+  wchar_t num_str[64];
+  swprintf(num_str, 64, L"%u already compressed files, ", (unsigned)count);
+
+  str->assign(num_str);
+  str->append(Om_formatSizeSysStr(size));
+  str->append(L" stored without compression");
+
+  return true;
+}
+
+/// \brief Append integer to cache data
+///
+/// \param[out] data    : Pointer to cache data to append to.
+/// \param[in]  value   : Value to append.
+///
+static inline void __cache_put_u32(OmCString* data, uint32_t value)
+{
+  data->append(reinterpret_cast<const char*>(&value), sizeof(uint32_t));
+}
+
+/// \brief Append string to cache data
+///
+/// \param[out] data    : Pointer to cache data to append to.
+/// \param[in]  str     : String to append.
+///
+static inline void __cache_put_str(OmCString* data, const OmWString& str)
+{
+  __cache_put_u32(data, str.size());
+  data->append(reinterpret_cast<const char*>(str.data()), str.size() * sizeof(wchar_t));
+}
+
+/// \brief Read integer from cache data
+///
+/// \param[in]  ptr     : Pointer to read position, moved after read value.
+/// \param[in]  end     : End of cache data.
+/// \param[out] value   : Pointer that receive value.
+///
+/// \return True if value was read, false if data is truncated.
+///
+static inline bool __cache_get_u32(const uint8_t** ptr, const uint8_t* end, uint32_t* value)
+{
+  if(static_cast<size_t>(end - *ptr) < sizeof(uint32_t))
+    return false;
+
+  memcpy(value, *ptr, sizeof(uint32_t));
+  *ptr += sizeof(uint32_t);
+
+  return true;
+}
+
+/// \brief Read string from cache data
+///
+/// \param[in]  ptr     : Pointer to read position, moved after read string.
+/// \param[in]  end     : End of cache data.
+/// \param[out] str     : Pointer to string that receive value.
+///
+/// \return True if string was read, false if data is truncated.
+///
+static inline bool __cache_get_str(const uint8_t** ptr, const uint8_t* end, OmWString* str)
+{
+  uint32_t len;
+  if(!__cache_get_u32(ptr, end, &len))
+    return false;
+
+  if(static_cast<size_t>(end - *ptr) / sizeof(wchar_t) < len)
+    return false;
+
+  str->assign(reinterpret_cast<const wchar_t*>(*ptr), len);
+  *ptr += len * sizeof(wchar_t);
+
+  return true;
+}
+
+/// \brief Gather Mod entries from archive
+///
+/// Gather entries of the given Mod Pack archive which are located under
+/// the specified data root.
+///
+/// \param[out] entries : Array to receive Mod entries.
+/// \param[in]  zip     : Mod Pack archive opened for reading.
+/// \param[in]  root    : Data root within archive.
+///
+static void __src_parse_zip(OmModEntryArray* entries, const OmArchive& zip, const OmWString& root)
+{
+  OmWString zcd_path;
+
+  for(size_t i = 0; i < zip.entryCount(); ++i) {
+
+    zip.entryPath(i, zcd_path);
+
+    OmModEntry_t entry;
+
+    if(Om_getRelativePath(&entry.path, root, zcd_path)) {
+
+      entry.cdid = i;
+
+      if(zip.entryIsDir(i)) {
+        entry.attr = OM_MODENTRY_DIR;
+      } else {
+        entry.attr = 0;
+      }
+
+      entries->push_back(entry);
+    }
+  }
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -45,15 +270,21 @@ OmModPack::OmModPack() :
   _hash(0),
   _has_src(false),
   _src_isdir(false),
+  _src_lazy(false),
   _has_bck(false),
   _bck_isdir(false),
+  _bck_stage(false),
   _is_overlapped(false),
   _op_backup(false),
   _op_restore(false),
   _op_apply(false),
   _op_progress(0)
 {
+  // lazy Source entries may be first required by several threads
+  InitializeCriticalSection(&this->_src_lock);
 
+  // staged Backup is switched to archive by background thread
+  InitializeCriticalSection(&this->_bck_lock);
 }
 
 ///
@@ -64,15 +295,21 @@ OmModPack::OmModPack(OmModChan* ModChan) :
   _hash(0),
   _has_src(false),
   _src_isdir(false),
+  _src_lazy(false),
   _has_bck(false),
   _bck_isdir(false),
+  _bck_stage(false),
   _is_overlapped(false),
   _op_backup(false),
   _op_restore(false),
   _op_apply(false),
   _op_progress(0)
 {
+  // lazy Source entries may be first required by several threads
+  InitializeCriticalSection(&this->_src_lock);
 
+  // staged Backup is switched to archive by background thread
+  InitializeCriticalSection(&this->_bck_lock);
 }
 
 ///
@@ -80,7 +317,8 @@ OmModPack::OmModPack(OmModChan* ModChan) :
 ///
 OmModPack::~OmModPack()
 {
-
+  DeleteCriticalSection(&this->_src_lock);
+  DeleteCriticalSection(&this->_bck_lock);
 }
 
 ///
@@ -116,13 +354,7 @@ bool OmModPack::refreshAnalytics()
   if(!this->_ModChan)
     return false;
 
-  bool is_overlapped = false;
-
-  for(size_t i = 0; i < this->_ModChan->modpackCount(); ++i) {
-    if(this->_ModChan->getModpack(i)->hasOverlap(this->_hash)) {
-      is_overlapped = true; break;
-    }
-  }
+  bool is_overlapped = this->_ModChan->isOverlapped(this);
 
   if(is_overlapped != this->_is_overlapped)
     has_changes = true;
@@ -144,6 +376,7 @@ void OmModPack::clearSource()
   this->_src_isdir = false;
   this->_src_root.clear();
   this->_src_entry.clear();
+  this->_src_lazy = false;
   this->_src_depend.clear();
 
   // Optional properties liked to source
@@ -203,6 +436,48 @@ void OmModPack::_src_parse_dir(OmModEntryArray* entries, const OmWString& orig,
   FindClose(hnd);
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_src_load_entries(OmWString* error) const
+{
+  bool result = true;
+
+  EnterCriticalSection(&this->_src_lock);
+
+  // entries may have been loaded by another thread while waiting
+  if(this->_src_lazy) {
+
+    OmArchive source_zip;
+
+    if(source_zip.read(this->_src_path, true)) {
+
+      __src_parse_zip(&this->_src_entry, source_zip, this->_src_root);
+
+      // accessors test the flag without lock, entries must be visible first
+      MemoryBarrier();
+
+      this->_src_lazy = false;
+
+    } else {
+
+      // entries are left unloaded so the Mod cannot be processed as empty,
+      // read is retried at next access
+      if(error) {
+        *error = source_zip.lastErrorStr();
+      } else {
+        const_cast<OmModPack*>(this)->_log(OM_LOG_WRN, L"_src_load_entries", Om_errLoad(L"archive file", this->_src_path, source_zip.lastErrorStr()));
+      }
+
+      result = false;
+    }
+  }
+
+  LeaveCriticalSection(&this->_src_lock);
+
+  return result;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -211,8 +486,9 @@ bool OmModPack::parseSource(const OmWString& path)
   this->clearSource();
 
   bool isdir = false;
+  bool lazy = false;
 
-  OmWString src_root, src_iden;
+  OmWString src_root;
 
   if(Om_isDir(path)) {
 
@@ -223,28 +499,44 @@ bool OmModPack::parseSource(const OmWString& path)
     OmModPack::_src_parse_dir(&this->_src_entry, path, L"");
     src_root = path;
 
-    src_iden = Om_getFilePart(path);
-
   } else if(Om_isFileZip(path)) {
 
     // Parse compressed file Mod Package
 
     OmArchive source_zip;
 
-    if(!source_zip.read(path)) {
-      this->_error(L"parseSource", Om_errLoad(L"archive file", path, source_zip.lastErrorStr()));
-      return false;
-    }
-
     // Try to find modern Mod Package XML definition file
     OmXmlConf source_cfg;
 
     int32_t zcd_idx;
     OmWString zcd_path;
 
+    // Probe archive central directory for XML definition file, this avoid
+    // to mirror the whole central directory for a simple library scan.
+    OmCString def_data;
+    bool has_def = source_zip.probe(path, OM_PKG_DEF_FILE_EXT, L"ModPack.xml", &def_data, &zcd_path);
+
+    if(has_def) {
+      if(!source_cfg.parse(Om_toUTF16(def_data), OM_XMAGIC_PKG)) {
+        this->_error(L"parseSource", Om_errParse(L"definition file", zcd_path, source_cfg.lastErrorStr()));
+        return false;
+      }
+    }
+
+    // Mod entries are gathered later, when first required, unless archive
+    // must be browsed anyway for legacy package or deprecated picture
+    lazy = source_cfg.valid() && !source_cfg.hasChild(L"picture");
+
+    if(!lazy) {
+      if(!source_zip.read(path, true)) {
+        this->_error(L"parseSource", Om_errLoad(L"archive file", path, source_zip.lastErrorStr()));
+        return false;
+      }
+    }
+
     // Search in backward since XML definition file is usually the last added
     // in zip archive so appear at the end of Central Directory.
-    unsigned i = source_zip.entryCount();
+    unsigned i = has_def ? 0 : source_zip.entryCount();
     while(i--) {
 
       source_zip.entryPath(i, zcd_path);
@@ -393,42 +685,64 @@ bool OmModPack::parseSource(const OmWString& path)
     }
 
     // Mod Pack appear valid, now we gather all Mod entries
-    for(size_t i = 0; i < source_zip.entryCount(); ++i) {
+    if(!lazy)
+      __src_parse_zip(&this->_src_entry, source_zip, src_root);
 
-      source_zip.entryPath(i, zcd_path);
+  } else {
+    this->_error(L"parseSource", L"unknown or wrong file type \""+path+L"\"");
+    return false;
+  }
 
-      OmModEntry_t entry;
+  // ultimately check against already parsed data from the Source
+  if(!this->_src_link(path, isdir)) {
+    this->_error(L"parseSource", L"parsed Source mismatch already parsed Backup \""+path+L"\"");
+    return false;
+  }
+
+  // All appear correct, now finalizing Mod Package setup
+  this->_src_path = path;
 
-      if(Om_getRelativePath(&entry.path, src_root, zcd_path)) {
+  this->_src_isdir = isdir;
 
-        entry.cdid = i;
+  this->_src_root = src_root;
 
-        if(source_zip.entryIsDir(i)) {
-          entry.attr = OM_MODENTRY_DIR;
-        } else {
-          entry.attr = 0;
-        }
+  this->_src_lazy = lazy;
 
-        this->_src_entry.push_back(entry);
-      }
-    }
+  this->_src_home = Om_getDirPart(path);
 
-    src_iden = Om_getNamePart(path);
+  this->_src_time = Om_itemTime(path);
+
+  if(this->_src_isdir) {
+
+    this->loadDirDescription();
+
+    this->loadDirThumbnail();
+  }
+
+  this->_has_src = true;
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_src_link(const OmWString& path, bool isdir)
+{
+  OmWString src_iden;
 
+  if(isdir) {
+    src_iden = Om_getFilePart(path);
   } else {
-    this->_error(L"parseSource", L"unknown or wrong file type \""+path+L"\"");
-    return false;
+    src_iden = Om_getNamePart(path);
   }
 
   uint64_t src_hash = Om_getXXHash3(Om_getFilePart(path));
 
-  // ultimately check against already parsed data from the Source
   if(this->_has_bck) {
 
-    if(src_hash != this->_hash || this->_iden != src_iden) {
-      this->_error(L"parseSource", L"parsed Source mismatch already parsed Backup \""+path+L"\"");
+    if(src_hash != this->_hash || this->_iden != src_iden)
       return false;
-    }
 
   } else {
 
@@ -442,23 +756,84 @@ bool OmModPack::parseSource(const OmWString& path)
       this->_version.parse(vers_str);
   }
 
-  // All appear correct, now finalizing Mod Package setup
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::parseSourceCache(const OmWString& path, const uint8_t* data, size_t size)
+{
+  this->clearSource();
+
+  const uint8_t* ptr = data;
+  const uint8_t* end = data + size;
+
+  uint32_t flags, count;
+  OmWString src_root, str;
+
+  bool valid = __cache_get_u32(&ptr, end, &flags) &&
+               __cache_get_str(&ptr, end, &src_root) &&
+               __cache_get_str(&ptr, end, &this->_category) &&
+               __cache_get_str(&ptr, end, &this->_description);
+
+  // dependencies
+  if(valid) valid = __cache_get_u32(&ptr, end, &count);
+
+  for(uint32_t i = 0; valid && i < count; ++i) {
+    valid = __cache_get_str(&ptr, end, &str);
+    if(valid) this->_src_depend.push_back(str);
+  }
+
+  // Mod entries, absent if they were not yet gathered
+  if(valid) valid = __cache_get_u32(&ptr, end, &count);
+
+  for(uint32_t i = 0; valid && i < count; ++i) {
+
+    OmModEntry_t entry;
+    uint32_t attr, cdid;
+
+    valid = __cache_get_str(&ptr, end, &entry.path) &&
+            __cache_get_u32(&ptr, end, &attr) &&
+            __cache_get_u32(&ptr, end, &cdid);
+
+    if(valid) {
+      entry.attr = attr;
+      entry.cdid = cdid;
+      this->_src_entry.push_back(entry);
+    }
+  }
+
+  // thumbnail PNG data
+  if(valid) valid = __cache_get_u32(&ptr, end, &count);
+
+  if(valid && count) {
+    valid = (static_cast<size_t>(end - ptr) >= count);
+    if(valid) this->_thumbnail.load(const_cast<uint8_t*>(ptr), count);
+  }
+
+  if(!valid) {
+    this->clearSource();
+    return false;
+  }
+
+  if(!this->_src_link(path, false)) {
+    this->clearSource();
+    this->_error(L"parseSourceCache", L"cached Source mismatch already parsed Backup \""+path+L"\"");
+    return false;
+  }
+
   this->_src_path = path;
 
-  this->_src_isdir = isdir;
+  this->_src_isdir = false;
 
   this->_src_root = src_root;
 
+  this->_src_lazy = (flags & 0x1);
+
   this->_src_home = Om_getDirPart(path);
 
-  this->_src_time = Om_itemTime(path);
-
-  if(this->_src_isdir) {
-
-    this->loadDirDescription();
-
-    this->loadDirThumbnail();
-  }
+  this->_src_time = Om_itemTime(path);
 
   this->_has_src = true;
 
@@ -468,18 +843,64 @@ bool OmModPack::parseSource(const OmWString& path)
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-bool OmModPack::refreshSource()
+bool OmModPack::writeSourceCache(OmCString* data) const
 {
-  if(this->_has_src) {
+  if(!this->_has_src || this->_src_isdir)
+    return false;
 
-    if(this->_src_isdir) {
-      // we cannot rely on time for directory changes, we refresh in all cases
-      this->parseSource(OmWString(this->_src_path));
-      return true;
-    } else {
-      if(this->_src_time != Om_itemTime(this->_src_path))
-        return this->parseSource(OmWString(this->_src_path));
-    }
+  // entries not yet gathered are left to be gathered on demand
+  __cache_put_u32(data, this->_src_lazy ? 0x1 : 0x0);
+
+  __cache_put_str(data, this->_src_root);
+  __cache_put_str(data, this->_category);
+  __cache_put_str(data, this->_description);
+
+  __cache_put_u32(data, this->_src_depend.size());
+  for(size_t i = 0; i < this->_src_depend.size(); ++i)
+    __cache_put_str(data, this->_src_depend[i]);
+
+  size_t entry_count = this->_src_lazy ? 0 : this->_src_entry.size();
+
+  __cache_put_u32(data, entry_count);
+  for(size_t i = 0; i < entry_count; ++i) {
+    __cache_put_str(data, this->_src_entry[i].path);
+    __cache_put_u32(data, this->_src_entry[i].attr);
+    __cache_put_u32(data, this->_src_entry[i].cdid);
+  }
+
+  // thumbnail is stored as PNG to keep cache compact
+  uint64_t png_size = 0;
+  uint8_t* png_data = nullptr;
+
+  if(this->_thumbnail.valid())
+    png_data = Om_imgEncodePng(&png_size, this->_thumbnail.data(), this->_thumbnail.width(),
+                               this->_thumbnail.height(), this->_thumbnail.bpp(), 1);
+
+  __cache_put_u32(data, png_data ? png_size : 0);
+
+  if(png_data) {
+    data->append(reinterpret_cast<const char*>(png_data), png_size);
+    Om_free(png_data);
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::refreshSource()
+{
+  if(this->_has_src) {
+
+    if(this->_src_isdir) {
+      // we cannot rely on time for directory changes, we refresh in all cases
+      this->parseSource(OmWString(this->_src_path));
+      return true;
+    } else {
+      if(this->_src_time != Om_itemTime(this->_src_path))
+        return this->parseSource(OmWString(this->_src_path));
+    }
   }
 
   return false;
@@ -664,11 +1085,26 @@ void OmModPack::clearBackup()
  this->_has_bck = false;
  this->_bck_path.clear();
  this->_bck_isdir = false;
+ this->_bck_stage = false;
  this->_bck_root.clear();
+ this->_src_same.clear();
  this->_bck_entry.clear();
  this->_bck_overlap.clear();
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString OmModPack::backupPath() const
+{
+  // path is changed by background compression of staged Backup
+  EnterCriticalSection(&this->_bck_lock);
+  OmWString path = this->_bck_path;
+  LeaveCriticalSection(&this->_bck_lock);
+
+  return path;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -772,7 +1208,12 @@ bool OmModPack::parseBackup(const OmWString& path)
       return false;
     }
 
-    bck_root = backup_cfg.child(L"backup").content();
+    // for directory, data root is a sub-directory
+    if(isdir) {
+      Om_concatPaths(bck_root, path, backup_cfg.child(L"backup").content());
+    } else {
+      bck_root = backup_cfg.child(L"backup").content();
+    }
 
     bck_iden = backup_cfg.child(L"ident").content();
 
@@ -855,6 +1296,8 @@ bool OmModPack::parseBackup(const OmWString& path)
 
   this->_bck_isdir = isdir;
 
+  this->_bck_stage = isdir && backup_cfg.hasChild(L"staged");
+
   //this->_bck_home = Om_getDirPart(path);
 
   this->_bck_root = bck_root;
@@ -881,13 +1324,16 @@ bool OmModPack::backupHasEntry(const OmWString& path, int32_t attr) const
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-void OmModPack::getFootprint(OmModEntryArray* footprint) const
+bool OmModPack::getFootprint(OmModEntryArray* footprint) const
 {
   if(!this->_ModChan) {
     //this->_error(L"getFootprint", L"no Mod Channel");
-    return;
+    return true;
   }
 
+  if(this->_src_lazy && !this->_src_load_entries())
+    return false;
+
   OmModEntry_t entry;
   entry.cdid = -1;
 
@@ -905,6 +1351,8 @@ void OmModPack::getFootprint(OmModEntryArray* footprint) const
 
     footprint->push_back(entry);
   }
+
+  return true;
 }
 
 ///
@@ -925,6 +1373,12 @@ bool OmModPack::hasOverlap(uint64_t hash) const
 ///
 bool OmModPack::canOverlap(const OmModPack* other) const
 {
+  if(this->_src_lazy)
+    this->_src_load_entries();
+
+  if(other->_src_lazy)
+    other->_src_load_entries();
+
   // you don't like raw loops ? I LOVE row loops...
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
@@ -950,6 +1404,9 @@ bool OmModPack::canOverlap(const OmModPack* other) const
 ///
 bool OmModPack::canOverlap(const OmModEntryArray& footprint) const
 {
+  if(this->_src_lazy)
+    this->_src_load_entries();
+
   // you don't like raw loops ? I LOVE row loops...
   for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
@@ -990,6 +1447,14 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     return OM_RESULT_ABORT;
   }
 
+  OmWString load_err;
+
+  if(this->_src_lazy && !this->_src_load_entries(&load_err)) {
+    this->_error(L"makeBackup", Om_errLoad(L"Source archive file", this->_src_path, load_err));
+    this->_op_backup = false;
+    return OM_RESULT_ERROR;
+  }
+
   // start backup operation
   this->_op_backup = true;
 
@@ -1011,12 +1476,29 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
 
   bool isdir = (this->_ModChan->backupCompMethod() < 0);
 
+  // compressed Backup on the same volume than Target, original files are
+  // renamed to a staging directory, to be compressed later in background
+  bool stage = !isdir && this->_ModChan->backupStaging() &&
+               Om_pathSameVolume(this->_ModChan->targetPath(), this->_ModChan->backupPath());
+
+  if(stage) isdir = true;
+
   OmWString bck_root;
 
   OmWString bck_name = Om_getFilePart(this->_src_path);
 
   OmWString bck_path = this->_ModChan->backupPath() + L"\\";
 
+  // create operation journal, so an interrupted install can be recovered
+  OmWString jnl_path = bck_path + bck_name + L"." OM_JNL_FILE_EXT;
+
+  int32_t jnl_result = this->_journal.create(jnl_path);
+  if(jnl_result != 0) {
+    this->_error(L"makeBackup", Om_errCreate(L"operation journal file", jnl_path, jnl_result));
+    this->_op_backup = false;
+    return OM_RESULT_ERROR;
+  }
+
   if(isdir) {
 
     bck_path += bck_name;
@@ -1026,6 +1508,7 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     int32_t result = Om_dirCreateRecursive(bck_root);
     if(result != 0) {
       this->_error(L"makeBackup", Om_errCreate(L"initial Backup directories", bck_root, result));
+      this->_journal.close(true);
       this->_op_backup = false;
       return OM_RESULT_ERROR;
     }
@@ -1038,13 +1521,18 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     bck_root = BACKUP_DATA_ROOT_DIR;
 
     // initialize zip archive
-    if(!backup_zip.write(bck_path, this->_ModChan->backupCompMethod(), this->_ModChan->backupCompLevel())) {
+    if(!backup_zip.write(bck_path, this->_ModChan->backupCompMethod(), this->_ModChan->backupCompLevel(), this->_ModChan->backupAdaptive())) {
       this->_error(L"makeBackup", Om_errInit(L"Backup archive file", bck_path, backup_zip.lastErrorStr()));
+      this->_journal.close(true);
       this->_op_backup = false;
       return OM_RESULT_ERROR;
     }
   }
 
+  this->_journal.append(OM_JNL_BACKUP, bck_path);
+  this->_journal.append(OM_JNL_ROOT, bck_root);
+  this->_journal.append(OM_JNL_TARGET, this->_ModChan->targetPath());
+
   // initialize backup XML config
   OmXmlConf backup_cfg(OM_XMAGIC_BCK);
 
@@ -1055,20 +1543,83 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
   bool has_error = false;
   bool has_abort = false;
 
-  OmWString tgt_file, bck_file;
+  OmWString bck_file;
   OmXmlNode bck_node;
 
-  for(size_t i = 0, z = 0; i < this->_src_entry.size(); ++i) {
+  // probe Target for existing items using parallel workers
+  OmWStringArray tgt_files(this->_src_entry.size());
+
+  for(size_t i = 0; i < this->_src_entry.size(); ++i)
+    Om_concatPaths(tgt_files[i], this->_ModChan->targetPath(), this->_src_entry[i].path);
+
+  std::vector<uint8_t> tgt_exists(this->_src_entry.size());
+
+  Om_pathExistsMany(tgt_files, tgt_exists.data());
+
+  // search for Target files that already hold the same content than archived
+  // Source files, these are neither saved to Backup nor written by install
+  this->_src_same.assign(this->_src_entry.size(), 0);
+
+  size_t same_count = 0;
+  uint64_t same_size = 0;
+
+  if(this->_ModChan->librarySkipsame() && !this->_src_isdir) {
+
+    OmArchive source_zip;
+
+    if(source_zip.read(this->_src_path, true)) {
+
+      for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+
+        if(!tgt_exists[i] || OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR))
+          continue;
+
+        // file modified by another Mod must be saved as usual, otherwise its
+        // current content would be lost once the other Mod is uninstalled
+        if(this->_ModChan->backupEntryExists(this->_src_entry[i].path, this->_src_entry[i].attr))
+          continue;
+
+        uint64_t size = source_zip.entrySize(this->_src_entry[i].cdid);
+
+        if(this->_ModChan->targetFileMatches(tgt_files[i], size, source_zip.entryCrc(this->_src_entry[i].cdid))) {
+          this->_src_same[i] = 1;
+          same_count++; same_size += size;
+        }
+      }
+
+      source_zip.close();
+
+    } else {
+      this->_log(OM_LOG_WRN, L"makeBackup", Om_errLoad(L"Source archive file", this->_src_path, source_zip.lastErrorStr()));
+    }
+  }
+
+  // Target files about to be saved to Backup are journaled all at once before
+  // the first move, so a single disk synchronization is required
+  for(size_t i = 0; i < this->_src_entry.size(); ++i)
+    if(tgt_exists[i] && !this->_src_same[i] && !OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR))
+      this->_journal.append(isdir ? OM_JNL_MOVED : OM_JNL_SAVED, this->_src_entry[i].path);
+
+  jnl_result = this->_journal.sync();
+  if(jnl_result != 0) {
+    this->_error(L"makeBackup", Om_errSave(L"operation journal file", jnl_path, Om_getErrorStr(jnl_result)));
+    has_error = true;
+  }
+
+  // files to be compressed to Backup archive once all entries are parsed
+  OmWStringArray zip_srcs, zip_dsts;
+
+  for(size_t i = 0, z = 0; i < this->_src_entry.size() && !has_error; ++i) {
 
     OmModEntry_t entry;
     entry.path = this->_src_entry[i].path;
     entry.attr = this->_src_entry[i].attr;
     entry.cdid = -1; //< invalid zip central-directory index
 
-    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
+    const OmWString& tgt_file = tgt_files[i];
     Om_concatPaths(bck_file, bck_root, entry.path);
 
-    if(!Om_pathExists(tgt_file)) {
+    if(!tgt_exists[i]) {
 
       // file or directory does not exists in Target, this is a added/created file
       // by the Mod that must be deleted at uninstall
@@ -1108,6 +1659,10 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
           }
         }
 
+      } else if(this->_src_same[i]) {
+
+        // identical file, nothing to save
+
       } else {
 
         if(isdir) {
@@ -1132,14 +1687,13 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
 
         } else {
 
-          // set zip central-directory index
+          // set zip central-directory index, entries are added to zip in
+          // the same order they are queued
           entry.cdid = z;
 
-          // add zip entry
-          if(!backup_zip.entryAdd(tgt_file, bck_file)) {
-            this->_error(L"makeBackup", Om_errZipComp(L"Backup from Target file", tgt_file, backup_zip.lastErrorStr()));
-            backup_zip.close(); has_error = true; break;
-          }
+          // queue zip entry
+          zip_srcs.push_back(tgt_file);
+          zip_dsts.push_back(bck_file);
 
           z++; //< increment zip central-directory index
         }
@@ -1150,6 +1704,10 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
         bck_node.setAttr(L"dir", 0);
 
         this->_bck_entry.push_back(entry);
+
+        // progression for queued entry is reported by batch compression
+        if(entry.cdid >= 0)
+          continue;
       }
     }
 
@@ -1168,15 +1726,60 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     #endif
   }
 
+  // compress queued Target files to Backup archive using parallel workers
+  if(!has_error && !has_abort && !zip_srcs.empty()) {
+
+    batch_progress_t relay = {progress_cb, user_ptr, progress_tot, progress_cur,
+                              reinterpret_cast<uint64_t>(this), &this->_op_progress, false};
+
+    if(!backup_zip.entryAddMany(zip_srcs, zip_dsts, 0, progress_cb ? __batch_progress_fn : nullptr, &relay)) {
+      if(relay.aborted) {
+        this->_log(OM_LOG_WRN, L"makeBackup", L"process aborted by user.");
+        has_abort = true;
+      } else {
+        this->_error(L"makeBackup", Om_errZipComp(L"Backup from Target files", bck_path, backup_zip.lastErrorStr()));
+        has_error = true;
+      }
+      backup_zip.close();
+    }
+  }
+
+  // if archive is incomplete, archived entries cannot be restored, since
+  // Target files were only read they do not need to be anyway
+  if((has_abort || has_error) && !isdir) {
+    for(size_t i = 0; i < this->_bck_entry.size(); ) {
+      if(this->_bck_entry[i].cdid >= 0) {
+        this->_bck_entry.erase(this->_bck_entry.begin() + i);
+      } else {
+        ++i;
+      }
+    }
+  }
+
   // Required data for potential undo
   this->_bck_path = bck_path;
 
   this->_bck_isdir = isdir;
 
+  this->_bck_stage = stage;
+
   this->_bck_root = bck_root;
 
   // process aborted, either by user or encountered error
   if(has_abort || has_error) {
+
+    // put back Target files moved so far and delete incomplete Backup, the
+    // same way an interrupted operation is recovered
+    if(!isdir) backup_zip.close();
+
+    this->_journal.close();
+
+    OmJournal journal;
+    if(journal.load(jnl_path) == 0 && this->_jnl_revert(journal)) {
+      journal.close(true);
+      this->clearBackup();
+    }
+
     this->_op_backup = false;
     return has_error ? OM_RESULT_ERROR_BACKP : OM_RESULT_ABORT;
   }
@@ -1196,6 +1799,10 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
     this->_bck_overlap.assign(bck_overlap.begin(), bck_overlap.end());
   }
 
+  // mark Backup as waiting for compression
+  if(stage)
+    backup_cfg.addChild(L"staged");
+
   if(isdir) {
 
     OmWString cfg_path = bck_path + L"\\ModBack.xml";
@@ -1233,6 +1840,16 @@ OmResult OmModPack::makeBackup(Om_progressCb progress_cb, void* user_ptr)
   swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
   this->_log(OM_LOG_OK, L"makeBackup", done_str);
 
+  OmWString adapt_str;
+  if(__adapt_report(&adapt_str, backup_zip))
+    this->_log(OM_LOG_OK, L"makeBackup", adapt_str);
+
+  if(same_count) {
+    wchar_t same_str[64];
+    swprintf(same_str, 64, L"%u identical files skipped, ", (unsigned)same_count);
+    this->_log(OM_LOG_OK, L"makeBackup", same_str + Om_formatSizeSysStr(same_size) + L" not saved");
+  }
+
 
   return OM_RESULT_OK;
 }
@@ -1287,7 +1904,7 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
       return OM_RESULT_ERROR;
     }
   } else {
-    if(!backup_zip.read(this->_bck_path)) {
+    if(!backup_zip.read(this->_bck_path, true)) {
       this->_error(L"restoreData", Om_errLoad(L"Backup archive file", this->_bck_path, backup_zip.lastErrorStr()));
       this->_op_restore = false;
       return OM_RESULT_ERROR;
@@ -1298,16 +1915,24 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
   bool has_abort = false;
 
   // restore original files from Backup to Target
+  //
+  // entries are gathered first so archived files can be extracted at once
+  // using parallel workers, moved files are simple renames done in place.
+
+  OmIndexArray    zip_cdids;
+  OmWStringArray  zip_dsts;
+
   for(size_t i = 0; i < this->_bck_entry.size(); ++i) {
 
     if(OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
       continue;
 
-    OmWString tgt_file, bck_file;
+    OmWString tgt_file;
     Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_bck_entry[i].path);
 
     if(this->_bck_isdir) {
 
+      OmWString bck_file;
       Om_concatPaths(bck_file, this->_bck_root, this->_bck_entry[i].path);
 
       // move file from backup to target, overwriting existing
@@ -1317,26 +1942,62 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
         has_error = true;
       }
 
+      // call progression callback
+      if(progress_cb) {
+        if(isundo) progress_cur--; else progress_cur++;
+        this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+        if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
+          has_abort = true; //< process continue but will return with abort code
+      }
+
     } else {
 
-      // extract from backup archive to target, overwriting existing
-      if(!backup_zip.entrySave(this->_bck_entry[i].cdid, tgt_file)) { //< TODO: des erreur d'index ici, le cdid est incohrent... data perdue ? mal pars ?
-        this->_error(L"restoreData", Om_errZipExtr(L"Backup to Target file", this->_bck_entry[i].path, backup_zip.lastErrorStr()));
+      // Target file may be a hard link to a Mod source, made with current or
+      // former Channel options, we must not write through it, moved backup
+      // files replace links so need no care
+      int32_t result = Om_fileDetach(tgt_file);
+      if(result != 0) {
+        this->_error(L"restoreData", Om_errDelete(L"linked file in Target", tgt_file, result));
         has_error = true;
+        continue;
       }
+
+      zip_cdids.push_back(this->_bck_entry[i].cdid);
+      zip_dsts.push_back(tgt_file);
     }
+  }
 
-    // call progression callback
-    if(progress_cb) {
-      if(isundo) progress_cur--; else progress_cur++;
-      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
-      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
-        has_abort = true; //< process continue but will return with abort code
+  if(!zip_dsts.empty()) {
+
+    // extract from backup archive to target, overwriting existing, the
+    // relay does not stop workers on abort since originals must be restored
+    batch_progress_t relay = {progress_cb, user_ptr, progress_tot, progress_cur,
+                              reinterpret_cast<uint64_t>(this), &this->_op_progress, false, isundo};
+
+    std::vector<uint8_t> zip_saved(zip_dsts.size());
+
+    if(!backup_zip.entrySaveMany(zip_cdids, zip_dsts, 0, progress_cb ? __restore_progress_fn : nullptr, &relay, zip_saved.data())) {
+
+      // batch stops at first failure, we retry remaining entries one by one
+      // so we restore as much as possible and report each faulty entry
+      this->_log(OM_LOG_WRN, L"restoreData", Om_errZipExtr(L"Backup to Target files", this->_ModChan->targetPath(), backup_zip.lastErrorStr()));
+
+      for(size_t k = 0; k < zip_dsts.size(); ++k) {
+        if(zip_saved[k])
+          continue;
+        if(!backup_zip.entrySave(zip_cdids[k], zip_dsts[k])) {
+          this->_error(L"restoreData", Om_errZipExtr(L"Backup to Target file", zip_dsts[k], backup_zip.lastErrorStr()));
+          has_error = true;
+        }
+      }
     }
 
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
+    if(relay.aborted)
+      has_abort = true; //< process continued but will return with abort code
+
+    if(progress_cb) {
+      if(isundo) progress_cur -= zip_dsts.size(); else progress_cur += zip_dsts.size();
+    }
   }
 
   // close backup archive file
@@ -1344,40 +2005,76 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
 
   // delete added files and/or folders Mod may have created in Target
   //
-  // the "To Delete" entries are listed according tree hierarchy in depth-first
-  // order, so we walk list in backward to have the proper deletion sequence.
+  // added files are deleted at once using parallel workers, then folders are
+  // pruned in a single bottom-up pass. The "To Delete" entries are listed
+  // according tree hierarchy in depth-first order, so we walk list in
+  // backward to have the proper deletion sequence.
 
-  size_t i = this->_bck_entry.size();
-  while(i--) {
+  OmWStringArray del_files;
+
+  for(size_t i = 0; i < this->_bck_entry.size(); ++i) {
 
     if(!OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
       continue;
 
+    if(OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DIR))
+      continue;
+
     OmWString tgt_file;
     Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_bck_entry[i].path);
 
-    // if undo the file may not be installed yet, we prevent warnings
-    if(isundo && !Om_pathExists(tgt_file))
-      continue;
+    del_files.push_back(tgt_file);
+  }
 
-    if(OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DIR)) {
+  if(!del_files.empty()) {
 
-      // delete folder only if empty
-      if(Om_isDirEmpty(tgt_file)) {
+    std::vector<int32_t> del_results(del_files.size(), 0);
 
-        int32_t result = Om_dirDelete(tgt_file);
-        if(result != 0) {
-          // do not throw error, simple warning
-          this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"directory in Target", tgt_file, result));
-        }
+    if(Om_fileDeleteMany(del_files, del_results.data()) > 0) {
+
+      for(size_t k = 0; k < del_files.size(); ++k) {
+
+        int32_t result = del_results[k];
+        if(result == 0)
+          continue;
+
+        // if undo the file may not be installed yet, we prevent warnings
+        if(isundo && (result == ERROR_FILE_NOT_FOUND || result == ERROR_PATH_NOT_FOUND))
+          continue;
+
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"file in Target", del_files[k], result));
       }
+    }
 
-    } else {
+    // call progression callback
+    if(progress_cb) {
+      if(isundo) progress_cur -= del_files.size(); else progress_cur += del_files.size();
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
+        has_abort = true; //< process continue but will return with abort code
+    }
+  }
 
-      int32_t result = Om_fileDelete(tgt_file);
-      if(result != 0) {
-        // do not throw error, simple warning
-        this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"file in Target", tgt_file, result));
+  size_t i = this->_bck_entry.size();
+  while(i--) {
+
+    if(!OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
+      continue;
+
+    if(!OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DIR))
+      continue;
+
+    OmWString tgt_file;
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_bck_entry[i].path);
+
+    // delete folder only if empty, deletion simply fails otherwise
+    int32_t result = Om_dirDelete(tgt_file);
+    if(result != 0 && result != ERROR_DIR_NOT_EMPTY) {
+      // if undo the folder may not be created yet, we prevent warnings
+      if(!isundo || (result != ERROR_FILE_NOT_FOUND && result != ERROR_PATH_NOT_FOUND)) {
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"restoreData", Om_errDelete(L"directory in Target", tgt_file, result));
       }
     }
 
@@ -1385,13 +2082,9 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
     if(progress_cb) {
       if(isundo) progress_cur--; else progress_cur++;
       this->_op_progress = ((double)progress_cur / progress_tot) * 100;
-      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
+      if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this)))
         has_abort = true; //< process continue but will return with abort code
     }
-
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
   }
 
   // cleanup backup data
@@ -1416,6 +2109,9 @@ OmResult OmModPack::restoreData(Om_progressCb progress_cb, void* user_ptr, bool
   // revoke and clean Backup side of this instance
   this->clearBackup();
 
+  // journal of undone install is no longer needed
+  this->_journal.close(true);
+
   // making report
   wchar_t done_str[32];
   swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
@@ -1444,6 +2140,14 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
     return OM_RESULT_ABORT;
   }
 
+  OmWString load_err;
+
+  if(this->_src_lazy && !this->_src_load_entries(&load_err)) {
+    this->_error(L"applySource", Om_errLoad(L"Source archive file", this->_src_path, load_err));
+    this->_op_apply = false;
+    return OM_RESULT_ERROR;
+  }
+
   // start install operation
   this->_op_apply = true;
 
@@ -1471,7 +2175,7 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
       return OM_RESULT_ERROR;
     }
   } else {
-    if(!source_zip.read(this->_src_path)) {
+    if(!source_zip.read(this->_src_path, true)) {
       this->_error(L"applySource", Om_errLoad(L"Source archive file", this->_src_path, source_zip.lastErrorStr()));
       this->_op_apply = false;
       return OM_RESULT_ERROR;
@@ -1483,44 +2187,73 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
 
   OmWString tgt_file, src_file;
 
-  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+  // files to be installed once Target tree is created
+  OmIndexArray file_cdid;
+  OmWStringArray file_srcs, file_dsts;
+
+  // identical files found while making Backup
+  bool check_same = (this->_src_same.size() == this->_src_entry.size());
+
+  size_t same_count = 0;
+  uint64_t same_size = 0;
+
+  // Backup is completed, from now an interrupted operation is recovered by
+  // restoring Backup data
+  this->_journal.append(OM_JNL_APPLY);
+
+  int32_t jnl_result = this->_journal.sync();
+  if(jnl_result != 0) {
+    this->_error(L"applySource", Om_errSave(L"operation journal file", this->_journal.path(), Om_getErrorStr(jnl_result)));
+    has_error = true;
+  }
+
+  // first pass, create directory tree in Target, entries are ordered so
+  // that parent directories always come first
+  for(size_t i = 0; i < this->_src_entry.size() && !has_error; ++i) {
 
     Om_concatPaths(tgt_file, this->_ModChan->targetPath(), this->_src_entry[i].path);
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
+    if(!OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
 
-      // if directory does not exists in Target, create it
-      if(!Om_isDir(tgt_file)) {
-        int32_t result = Om_dirCreate(tgt_file);
-        if(result != 0) {
-          this->_error(L"applySource", Om_errCreate(L"directory in Target", tgt_file, result));
-          has_error = true; break;
-        }
+      // Target file already holds the same content
+      if(check_same && this->_src_same[i]) {
+        same_count++; same_size += source_zip.entrySize(this->_src_entry[i].cdid);
+        progress_cur++;
+        continue;
       }
 
-    } else {
+      // a Target file may be hard link to another Mod source, links may
+      // exist whatever the current Channel options, we must not write
+      // through it
+      int32_t result = Om_fileDetach(tgt_file);
+      if(result != 0) {
+        this->_error(L"applySource", Om_errDelete(L"linked file in Target", tgt_file, result));
+        has_error = true; break;
+      }
 
       if(this->_src_isdir) {
-
         Om_concatPaths(src_file, this->_src_root, this->_src_entry[i].path);
+        file_srcs.push_back(src_file);
+      } else {
+        file_cdid.push_back(this->_src_entry[i].cdid);
+      }
 
-        // Copy and overwrite
-        int32_t result = Om_fileCopy(src_file, tgt_file, true);
-        if(result != 0) {
-          this->_error(L"applySource", Om_errCopy(L"Source file to Target", tgt_file, result));
-          has_error = true; break;
-        }
+      file_dsts.push_back(tgt_file);
 
-      } else {
+      this->_journal.append(OM_JNL_WRITTEN, this->_src_entry[i].path);
 
-        // extract to destination
-        if(!source_zip.entrySave(this->_src_entry[i].cdid, tgt_file)) {
-          this->_error(L"applySource", Om_errZipExtr(L"Source file to Target", tgt_file, source_zip.lastErrorStr()));
-          has_error = true; break;
-        }
+      continue;
+    }
 
+    // if directory does not exists in Target, create it
+    if(!Om_isDir(tgt_file)) {
+      int32_t result = Om_dirCreate(tgt_file);
+      if(result != 0) {
+        this->_error(L"applySource", Om_errCreate(L"directory in Target", tgt_file, result));
+        has_error = true; break;
       }
 
+      this->_journal.append(OM_JNL_DIRECTORY, this->_src_entry[i].path);
     }
 
     // call progression callback
@@ -1532,15 +2265,67 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
         has_abort = true; break;
       }
     }
+  }
 
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
+  // files to be written are journaled before writing starts
+  if(!has_error && !has_abort) {
+    jnl_result = this->_journal.sync();
+    if(jnl_result != 0) {
+      this->_error(L"applySource", Om_errSave(L"operation journal file", this->_journal.path(), Om_getErrorStr(jnl_result)));
+      has_error = true;
+    }
+  }
+
+  // second pass, extract or copy files using parallel workers
+  if(!has_error && !has_abort && !file_dsts.empty()) {
+
+    batch_progress_t relay = {progress_cb, user_ptr, progress_tot, progress_cur,
+                              reinterpret_cast<uint64_t>(this), &this->_op_progress, false};
+
+    Om_progressCb relay_cb = progress_cb ? __batch_progress_fn : nullptr;
+
+    if(this->_src_isdir) {
+
+      size_t failed = 0;
+
+      int32_t result;
+
+      if(this->_ModChan->libraryHardlink()) {
+        result = Om_fileLinkMany(file_srcs, file_dsts, 0, &failed, relay_cb, &relay);
+      } else {
+        result = Om_fileCopyMany(file_srcs, file_dsts, 0, &failed, relay_cb, &relay);
+      }
+
+      if(result != 0) {
+        if(relay.aborted) {
+          has_abort = true;
+        } else {
+          this->_error(L"applySource", Om_errCopy(L"Source file to Target", file_dsts[failed], result));
+          has_error = true;
+        }
+      }
+
+    } else {
+
+      if(!source_zip.entrySaveMany(file_cdid, file_dsts, 0, relay_cb, &relay)) {
+        if(relay.aborted) {
+          has_abort = true;
+        } else {
+          this->_error(L"applySource", Om_errZipExtr(L"Source files to Target", this->_ModChan->targetPath(), source_zip.lastErrorStr()));
+          has_error = true;
+        }
+      }
+    }
+
+    if(has_abort)
+      this->_log(OM_LOG_WRN, L"applySource", L"process aborted by user.");
   }
 
   // close zip file
   if(!this->_src_isdir) source_zip.close();
 
+  this->_src_same.clear();
+
   // end install operation
   this->_op_apply = false;
 
@@ -1548,59 +2333,1228 @@ OmResult OmModPack::applySource(Om_progressCb progress_cb, void* user_ptr)
     return has_error ? OM_RESULT_ERROR_APPLY : OM_RESULT_ABORT; //< must undo
   }
 
+  // operation completed, journal is no longer needed
+  this->_journal.append(OM_JNL_COMMIT);
+  this->_journal.close(true);
+
   // making report
   wchar_t done_str[32];
   swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
   this->_log(OM_LOG_OK, L"applySource", done_str);
 
+  if(same_count) {
+    wchar_t same_str[64];
+    swprintf(same_str, 64, L"%u identical files skipped, ", (unsigned)same_count);
+    this->_log(OM_LOG_OK, L"applySource", same_str + Om_formatSizeSysStr(same_size) + L" not written");
+  }
+
   return OM_RESULT_OK;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmResult OmModPack::discardBackup()
+OmResult OmModPack::applyUpgrade(OmModPack* ModPack, Om_progressCb progress_cb, void* user_ptr)
 {
-
+  if(!this->_ModChan) {
+    this->_error(L"applyUpgrade", L"no Mod Channel.");
+    return OM_RESULT_ABORT;
+  }
+
+  // differences are computed from both archives central directories, former
+  // version must be installed while this one must not
+  if(!ModPack || ModPack->_ModChan != this->_ModChan || !ModPack->_has_bck ||
+     !ModPack->_has_src || ModPack->_src_isdir || !this->_has_src || this->_src_isdir || this->_has_bck)
+    return OM_RESULT_ABORT;
+
+  OmWString load_err;
+
+  if(this->_src_lazy && !this->_src_load_entries(&load_err)) {
+    this->_error(L"applyUpgrade", Om_errLoad(L"Source archive file", this->_src_path, load_err));
+    return OM_RESULT_ERROR;
+  }
+
+  if(ModPack->_src_lazy && !ModPack->_src_load_entries(&load_err)) {
+    this->_error(L"applyUpgrade", Om_errLoad(L"former Source archive file", ModPack->_src_path, load_err));
+    return OM_RESULT_ERROR;
+  }
+
+  // start install operation
+  this->_op_apply = true;
+
+  // initialize chrono
+  clock_t time = clock();
+
+  OmArchive source_zip, former_zip;
+
+  if(!source_zip.read(this->_src_path, true)) {
+    this->_error(L"applyUpgrade", Om_errLoad(L"Source archive file", this->_src_path, source_zip.lastErrorStr()));
+    this->_op_apply = false;
+    return OM_RESULT_ERROR;
+  }
+
+  if(!former_zip.read(ModPack->_src_path, true)) {
+    this->_error(L"applyUpgrade", Om_errLoad(L"former Source archive file", ModPack->_src_path, former_zip.lastErrorStr()));
+    this->_op_apply = false;
+    return OM_RESULT_ERROR;
+  }
+
+  OmWString key;
+
+  // index former Source and Backup entries by path
+  std::unordered_map<OmWString, size_t> former_index;
+
+  for(size_t i = 0; i < ModPack->_src_entry.size(); ++i) {
+    key = ModPack->_src_entry[i].path; Om_strToUpper(&key);
+    former_index[key] = i;
+  }
+
+  std::unordered_map<OmWString, size_t> bck_index;
+
+  for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+    key = ModPack->_bck_entry[i].path; Om_strToUpper(&key);
+    bck_index[key] = i;
+  }
+
+  std::vector<uint8_t> former_kept(ModPack->_src_entry.size(), 0);
+
+  // Backup entries for entries this version adds
+  OmModEntryArray bck_added;
+
+  // Target files to write and Target original files to save
+  OmIndexArray file_cdid;
+  OmWStringArray file_dsts, file_paths, dir_adds, dir_paths, orig_files, orig_paths;
+
+  uint64_t write_size = 0, full_size = 0;
+
+  size_t full_count = 0;
+
+  OmWString tgt_file;
+
+  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+
+    const OmModEntry_t& entry = this->_src_entry[i];
+
+    bool isdir = OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR);
+
+    uint64_t size = isdir ? 0 : source_zip.entrySize(entry.cdid);
+
+    full_size += size;
+
+    if(!isdir) full_count++;
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), entry.path);
+
+    key = entry.path; Om_strToUpper(&key);
+
+    auto it = former_index.find(key);
+
+    if(it != former_index.end()) {
+
+      const OmModEntry_t& former = ModPack->_src_entry[it->second];
+
+      former_kept[it->second] = 1;
+
+      if(isdir)
+        continue;
+
+      // same file in both versions, nothing to write
+      if(!OM_HAS_BIT(former.attr, OM_MODENTRY_DIR) &&
+         former_zip.entrySize(former.cdid) == size &&
+         former_zip.entryCrc(former.cdid) == source_zip.entryCrc(entry.cdid))
+        continue;
+
+      // former file was identical to Target original thus skipped without
+      // Backup entry, Target still holds original file which must be saved
+      // before being overwritten
+      if(!OM_HAS_BIT(former.attr, OM_MODENTRY_DIR) && bck_index.find(key) == bck_index.end()) {
+
+        OmModEntry_t bck_entry;
+        bck_entry.path = entry.path;
+        bck_entry.attr = entry.attr;
+        bck_entry.cdid = -1;
+
+        if(Om_pathExists(tgt_file)) {
+          orig_files.push_back(tgt_file);
+          orig_paths.push_back(entry.path);
+        } else {
+          bck_entry.attr |= OM_MODENTRY_DEL;
+        }
+
+        bck_added.push_back(bck_entry);
+      }
+
+    } else {
+
+      // added entry, same logic as for Backup creation
+      OmModEntry_t bck_entry;
+      bck_entry.path = entry.path;
+      bck_entry.attr = entry.attr;
+      bck_entry.cdid = -1;
+
+      if(Om_pathExists(tgt_file)) {
+
+        if(isdir) {
+
+          // directory was created by another Mod, we add it as to be deleted
+          // by this one too so we can delete unused shared folders if empty.
+          if(this->_ModChan->backupEntryExists(entry.path, entry.attr)) {
+            bck_entry.attr |= OM_MODENTRY_DEL;
+            bck_added.push_back(bck_entry);
+          }
+
+        } else {
+
+          // original file must be saved
+          orig_files.push_back(tgt_file);
+          orig_paths.push_back(entry.path);
+          bck_added.push_back(bck_entry);
+        }
+
+      } else {
+
+        bck_entry.attr |= OM_MODENTRY_DEL;
+        bck_added.push_back(bck_entry);
+
+        if(isdir) {
+          dir_adds.push_back(tgt_file);
+          dir_paths.push_back(entry.path);
+        }
+      }
+
+      if(isdir)
+        continue;
+    }
+
+    file_cdid.push_back(entry.cdid);
+    file_dsts.push_back(tgt_file);
+    file_paths.push_back(entry.path);
+
+    write_size += size;
+  }
+
+  // former Backup entries related to entries this version removes
+  std::vector<uint8_t> bck_removed(ModPack->_bck_entry.size(), 0);
+
+  size_t removed_count = 0;
+
+  for(size_t i = 0; i < ModPack->_src_entry.size(); ++i) {
+
+    if(former_kept[i])
+      continue;
+
+    key = ModPack->_src_entry[i].path; Om_strToUpper(&key);
+
+    auto it = bck_index.find(key);
+    if(it != bck_index.end()) {
+      bck_removed[it->second] = 1;
+      removed_count++;
+    }
+  }
+
+  former_zip.close();
+
+  // initialize progression callback
+  size_t progress_tot = 0, progress_cur = 0;
+  if(progress_cb) {
+    progress_tot = orig_files.size() + removed_count + file_dsts.size();
+    this->_op_progress = 0;
+    if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this))) {
+      this->_op_apply = false;
+      return OM_RESULT_ABORT;
+    }
+  }
+
+  bool isdir = ModPack->_bck_isdir;
+
+  OmWString bck_path = this->_ModChan->backupPath() + L"\\" + Om_getFilePart(this->_src_path);
+
+  OmWString jnl_path = bck_path + L"." OM_JNL_FILE_EXT;
+
+  if(!isdir) bck_path += L"." OM_BCK_FILE_EXT;
+
+  OmWString tmp_path = bck_path + L".tmp";
+
+  // create operation journal, so an interrupted upgrade can be recovered
+  int32_t jnl_result = this->_journal.create(jnl_path);
+  if(jnl_result != 0) {
+    this->_error(L"applyUpgrade", Om_errCreate(L"operation journal file", jnl_path, jnl_result));
+    this->_op_apply = false;
+    return OM_RESULT_ERROR;
+  }
+
+  // former Backup holds Target original files and must be kept if upgrade
+  // is reverted, new Backup archive is written aside
+  this->_journal.append(OM_JNL_FORMER, ModPack->_bck_path);
+
+  if(isdir) {
+    if(!Om_namesMatches(ModPack->_bck_path, bck_path))
+      this->_journal.append(OM_JNL_FORMER, bck_path);
+    this->_journal.append(OM_JNL_ROOT, ModPack->_bck_root);
+  } else {
+    this->_journal.append(OM_JNL_BACKUP, tmp_path);
+    if(!Om_namesMatches(ModPack->_bck_path, bck_path))
+      this->_journal.append(OM_JNL_BACKUP, bck_path);
+    this->_journal.append(OM_JNL_ROOT, BACKUP_DATA_ROOT_DIR);
+  }
+
+  this->_journal.append(OM_JNL_TARGET, this->_ModChan->targetPath());
+
+  // Target original files about to be moved to Backup
+  if(isdir) {
+    for(size_t i = 0; i < orig_paths.size(); ++i)
+      this->_journal.append(OM_JNL_MOVED, orig_paths[i]);
+  }
+
+  jnl_result = this->_journal.sync();
+  if(jnl_result != 0) {
+    this->_error(L"applyUpgrade", Om_errSave(L"operation journal file", jnl_path, Om_getErrorStr(jnl_result)));
+    this->_journal.close(true);
+    this->_op_apply = false;
+    return OM_RESULT_ERROR;
+  }
+
+  // Backup entries, former ones not removed followed by added ones
+  OmModEntryArray bck_entry;
+
+  OmArchive backup_old, backup_zip;
+
+  bool has_error = false;
+  bool has_abort = false;
+
+  OmWString bck_file;
+
+  // 1. save Target original files, overwritten by added entries, to Backup
+
+  if(isdir) {
+
+    for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i)
+      if(!bck_removed[i]) bck_entry.push_back(ModPack->_bck_entry[i]);
+
+    size_t moved = 0;
+
+    for(size_t i = 0; i < orig_files.size(); ++i) {
+
+      Om_concatPaths(bck_file, ModPack->_bck_root, orig_paths[i]);
+
+      // create required directory tree before moving file
+      OmWString bck_tree = Om_getDirPart(bck_file);
+
+      if(!Om_isDir(bck_tree)) {
+        int32_t result = Om_dirCreateRecursive(bck_tree);
+        if(result != 0) {
+          this->_error(L"applyUpgrade", Om_errCreate(L"tree in Backup", bck_tree, result));
+          has_error = true; break;
+        }
+      }
+
+      int32_t result = Om_fileMove(orig_files[i], bck_file);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errMove(L"Backup from Target file", orig_files[i], result));
+        has_error = true; break;
+      }
+
+      moved++;
+
+      if(progress_cb) {
+        progress_cur++;
+        this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+        if(!progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this))) {
+          has_abort = true; break;
+        }
+      }
+    }
+
+    if(!has_error && !has_abort)
+      has_error = !this->_jnl_upgrade(ModPack, file_paths, dir_paths, orig_paths);
+
+    // Target must be left untouched, move back saved files
+    if(has_error || has_abort) {
+      for(size_t i = 0; i < moved; ++i) {
+        Om_concatPaths(bck_file, ModPack->_bck_root, orig_paths[i]);
+        Om_fileMove(bck_file, orig_files[i]);
+      }
+    }
+
+  } else {
+
+    if(!backup_old.read(ModPack->_bck_path, true)) {
+      this->_error(L"applyUpgrade", Om_errLoad(L"Backup archive file", ModPack->_bck_path, backup_old.lastErrorStr()));
+      this->_journal.close(true);
+      this->_op_apply = false;
+      return OM_RESULT_ERROR;
+    }
+
+    int32_t method = this->_ModChan->backupCompMethod();
+    if(method < 0) method = OM_METHOD_STORE;
+
+    // new archive is written aside, former one is still needed for restoration
+    if(!backup_zip.write(tmp_path, method, this->_ModChan->backupCompLevel(), this->_ModChan->backupAdaptive())) {
+      this->_error(L"applyUpgrade", Om_errInit(L"Backup archive file", tmp_path, backup_zip.lastErrorStr()));
+      this->_journal.close(true);
+      this->_op_apply = false;
+      return OM_RESULT_ERROR;
+    }
+
+    int32_t z = 0; //< new zip central-directory index
+
+    // copy kept entries without recompression
+    for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+
+      if(bck_removed[i])
+        continue;
+
+      OmModEntry_t entry = ModPack->_bck_entry[i];
+
+      if(entry.cdid >= 0) {
+
+        Om_concatPaths(bck_file, BACKUP_DATA_ROOT_DIR, entry.path);
+
+        if(!backup_zip.entryCopyRaw(backup_old, entry.cdid, bck_file)) {
+          this->_error(L"applyUpgrade", Om_errZipComp(L"Backup kept file", entry.path, backup_zip.lastErrorStr()));
+          has_error = true; break;
+        }
+
+        entry.cdid = z++;
+      }
+
+      bck_entry.push_back(entry);
+    }
+
+    // compress Target original files
+    if(!has_error && !orig_files.empty()) {
+
+      OmWStringArray zip_dsts(orig_paths.size());
+
+      for(size_t i = 0; i < orig_paths.size(); ++i)
+        Om_concatPaths(zip_dsts[i], BACKUP_DATA_ROOT_DIR, orig_paths[i]);
+
+      batch_progress_t relay = {progress_cb, user_ptr, progress_tot, progress_cur,
+                                reinterpret_cast<uint64_t>(this), &this->_op_progress, false};
+
+      if(!backup_zip.entryAddMany(orig_files, zip_dsts, 0, progress_cb ? __batch_progress_fn : nullptr, &relay)) {
+        if(relay.aborted) {
+          has_abort = true;
+        } else {
+          this->_error(L"applyUpgrade", Om_errZipComp(L"Backup from Target files", tmp_path, backup_zip.lastErrorStr()));
+          has_error = true;
+        }
+      }
+
+      progress_cur += orig_files.size();
+    }
+
+    // set indexes of added entries, originals were added in the same order
+    for(size_t i = 0; i < bck_added.size(); ++i)
+      if(!OM_HAS_BIT(bck_added[i].attr, OM_MODENTRY_DEL))
+        bck_added[i].cdid = z++;
+
+    if(!has_error && !has_abort)
+      has_error = !this->_jnl_upgrade(ModPack, file_paths, dir_paths, orig_paths);
+
+    // Target is untouched at this stage, we can safely cancel
+    if(has_error || has_abort) {
+      backup_zip.close();
+      backup_old.close();
+      Om_fileDelete(tmp_path);
+    }
+  }
+
+  if(has_error || has_abort) {
+    this->_journal.close(true);
+    this->_op_apply = false;
+    if(has_abort)
+      this->_log(OM_LOG_WRN, L"applyUpgrade", L"process aborted by user.");
+    return has_error ? OM_RESULT_ERROR : OM_RESULT_ABORT;
+  }
+
+  bck_entry.insert(bck_entry.end(), bck_added.begin(), bck_added.end());
+
+  // 2. restore Target original files of removed entries
+
+  for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+
+    if(!bck_removed[i] || OM_HAS_BIT(ModPack->_bck_entry[i].attr, OM_MODENTRY_DEL))
+      continue;
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), ModPack->_bck_entry[i].path);
+
+    if(isdir) {
+
+      Om_concatPaths(bck_file, ModPack->_bck_root, ModPack->_bck_entry[i].path);
+
+      int32_t result = Om_fileMove(bck_file, tgt_file);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errMove(L"Backup to Target file", tgt_file, result));
+        has_error = true;
+      }
+
+    } else {
+
+      // Target file may be a hard link to old Mod Source directory
+      int32_t result = Om_fileDetach(tgt_file);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errDelete(L"linked file in Target", tgt_file, result));
+        has_error = true;
+      } else if(!backup_old.entrySave(ModPack->_bck_entry[i].cdid, tgt_file)) {
+        this->_error(L"applyUpgrade", Om_errZipExtr(L"Backup to Target file", ModPack->_bck_entry[i].path, backup_old.lastErrorStr()));
+        has_error = true;
+      }
+    }
+
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this));
+    }
+  }
+
+  if(!isdir) backup_old.close();
+
+  // delete files and folders of removed entries, in backward order to have
+  // the proper deletion sequence.
+  size_t i = ModPack->_bck_entry.size();
+  while(i--) {
+
+    if(!bck_removed[i] || !OM_HAS_BIT(ModPack->_bck_entry[i].attr, OM_MODENTRY_DEL))
+      continue;
+
+    Om_concatPaths(tgt_file, this->_ModChan->targetPath(), ModPack->_bck_entry[i].path);
+
+    if(OM_HAS_BIT(ModPack->_bck_entry[i].attr, OM_MODENTRY_DIR)) {
+
+      // delete folder only if empty
+      if(Om_isDirEmpty(tgt_file)) {
+        int32_t result = Om_dirDelete(tgt_file);
+        if(result != 0) {
+          // do not throw error, simple warning
+          this->_log(OM_LOG_WRN, L"applyUpgrade", Om_errDelete(L"directory in Target", tgt_file, result));
+        }
+      }
+
+    } else {
+
+      int32_t result = Om_fileDelete(tgt_file);
+      if(result != 0) {
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"applyUpgrade", Om_errDelete(L"file in Target", tgt_file, result));
+      }
+    }
+
+    if(progress_cb) {
+      progress_cur++;
+      this->_op_progress = ((double)progress_cur / progress_tot) * 100;
+      progress_cb(user_ptr, progress_tot, progress_cur, reinterpret_cast<uint64_t>(this));
+    }
+  }
+
+  // 3. write added and changed files to Target
+
+  for(size_t i = 0; i < dir_adds.size(); ++i) {
+    if(!Om_isDir(dir_adds[i])) {
+      int32_t result = Om_dirCreate(dir_adds[i]);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errCreate(L"directory in Target", dir_adds[i], result));
+        has_error = true; break;
+      }
+    }
+  }
+
+  if(!has_error) {
+
+    // a Target file may be hard link to another Mod source, links may exist
+    // whatever the current Channel options, we must not write through it
+    for(size_t i = 0; i < file_dsts.size(); ++i) {
+      int32_t result = Om_fileDetach(file_dsts[i]);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errDelete(L"linked file in Target", file_dsts[i], result));
+        has_error = true; break;
+      }
+    }
+  }
+
+  if(!has_error && !file_dsts.empty()) {
+
+    // the process cannot be canceled from here, progression is only reported
+    batch_progress_t relay = {progress_cb, user_ptr, progress_tot, progress_cur,
+                              reinterpret_cast<uint64_t>(this), &this->_op_progress, false};
+
+    if(!source_zip.entrySaveMany(file_cdid, file_dsts, 0, progress_cb ? __batch_progress_fn : nullptr, &relay)) {
+      if(!relay.aborted) {
+        this->_error(L"applyUpgrade", Om_errZipExtr(L"Source files to Target", this->_ModChan->targetPath(), source_zip.lastErrorStr()));
+        has_error = true;
+      }
+    }
+  }
+
+  source_zip.close();
+
+  // 4. finalize Backup, now related to this Mod
+
+  OmXmlConf backup_cfg(OM_XMAGIC_BCK);
+
+  backup_cfg.addChild(L"ident").setContent(this->_iden);
+  backup_cfg.addChild(L"hash").setContent(Om_uint64ToStr(this->_hash));
+  backup_cfg.addChild(L"backup").setContent(BACKUP_DATA_ROOT_DIR);
+
+  for(size_t i = 0; i < bck_entry.size(); ++i) {
+
+    OmXmlNode bck_node;
+
+    if(OM_HAS_BIT(bck_entry[i].attr, OM_MODENTRY_DEL)) {
+      bck_node = backup_cfg.addChild(L"del");
+    } else {
+      bck_node = backup_cfg.addChild(L"cpy");
+    }
+
+    bck_node.setContent(bck_entry[i].path);
+    bck_node.setAttr(L"cdi", (int)bck_entry[i].cdid);
+    bck_node.setAttr(L"dir", OM_HAS_BIT(bck_entry[i].attr, OM_MODENTRY_DIR) ? 1 : 0);
+  }
+
+  // retrieve overlapped Mod list, except former version
+  OmUint64Array bck_overlap;
+
+  this->_ModChan->findOverlaps(this, &bck_overlap);
+
+  for(size_t i = 0; i < bck_overlap.size(); ) {
+    if(bck_overlap[i] == ModPack->_hash) {
+      bck_overlap.erase(bck_overlap.begin() + i);
+    } else {
+      ++i;
+    }
+  }
+
+  if(bck_overlap.size()) {
+
+    OmXmlNode xml_overlap = backup_cfg.addChild(L"overlap");
+
+    for(size_t i = 0; i < bck_overlap.size(); ++i)
+      xml_overlap.addChild(L"hash").setContent(Om_uint64ToStr(bck_overlap[i]));
+  }
+
+  if(ModPack->_bck_stage)
+    backup_cfg.addChild(L"staged");
+
+  if(isdir) {
+
+    OmWString cfg_path = ModPack->_bck_path + L"\\ModBack.xml";
+
+    if(!backup_cfg.save(cfg_path)) {
+      this->_error(L"applyUpgrade", Om_errSave(L"definition file", cfg_path, backup_cfg.lastErrorStr()));
+      has_error = true;
+    }
+
+    if(!Om_namesMatches(ModPack->_bck_path, bck_path)) {
+      int32_t result = Om_fileMove(ModPack->_bck_path, bck_path);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errRename(L"Backup directory", ModPack->_bck_path, result));
+        bck_path = ModPack->_bck_path;
+        has_error = true;
+      }
+    }
+
+  } else {
+
+    OmCString xml_data = backup_cfg.data();
+    if(!backup_zip.entryAdd(xml_data.c_str(), xml_data.size(), L"ModBack.xml")) {
+      this->_error(L"applyUpgrade", Om_errZipComp(L"definition file", L"ModBack.xml", backup_zip.lastErrorStr()));
+      has_error = true;
+    }
+
+    // finalize zip archive
+    backup_zip.close();
+
+    if(!has_error) {
+
+      int32_t result = Om_fileDelete(ModPack->_bck_path);
+      if(result != 0) {
+        this->_error(L"applyUpgrade", Om_errDelete(L"former Backup archive file", ModPack->_bck_path, result));
+        bck_path = ModPack->_bck_path;
+        has_error = true;
+      } else {
+        result = Om_fileMove(tmp_path, bck_path);
+        if(result != 0) {
+          this->_error(L"applyUpgrade", Om_errRename(L"Backup archive file", tmp_path, result));
+          has_error = true;
+        }
+      }
+    }
+  }
+
+  // this Mod now owns the Backup, whatever happened
+  this->_bck_path = bck_path;
+
+  this->_bck_isdir = isdir;
+
+  this->_bck_stage = ModPack->_bck_stage;
+
+  if(isdir) {
+    Om_concatPaths(this->_bck_root, bck_path, BACKUP_DATA_ROOT_DIR);
+  } else {
+    this->_bck_root = BACKUP_DATA_ROOT_DIR;
+  }
+
+  this->_bck_entry = bck_entry;
+
+  this->_bck_overlap = bck_overlap;
+
+  this->_has_bck = true;
+
+  ModPack->clearBackup();
+
+  // end install operation
+  this->_op_apply = false;
+
+  // journal is kept on error, it is either discarded once Mod is restored
+  // or replayed at next Mod Channel opening
+  if(has_error) {
+    this->_journal.close();
+    return OM_RESULT_ERROR;
+  }
+
+  // operation completed, journal is no longer needed
+  this->_journal.append(OM_JNL_COMMIT);
+  this->_journal.close(true);
+
+  // making report
+  wchar_t delta_str[128];
+  swprintf(delta_str, 128, L"%u of %u files written, ", (unsigned)file_dsts.size(), (unsigned)full_count);
+  this->_log(OM_LOG_OK, L"applyUpgrade", delta_str + Om_formatSizeSysStr(write_size) + L" instead of " + Om_formatSizeSysStr(full_size));
+
+  wchar_t done_str[32];
+  swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
+  this->_log(OM_LOG_OK, L"applyUpgrade", done_str);
+
+  OmWString adapt_str;
+  if(__adapt_report(&adapt_str, backup_zip))
+    this->_log(OM_LOG_OK, L"applyUpgrade", adapt_str);
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModPack::discardBackup()
+{
+
   // initialize local timer
   clock_t time = clock();
 
   bool has_error = false;
 
-  // cleanup backup data either zip file or sub-directory...
-  if(this->_bck_isdir) {
+  // cleanup backup data either zip file or sub-directory...
+  if(this->_bck_isdir) {
+
+    int32_t result = Om_moveToTrash(this->_bck_path);
+    if(result != 0) {
+      this->_error(L"discardBackup", Om_errDelete(L"Backup data directory", this->_bck_path, result));
+      has_error = true;
+    }
+
+  } else {
+
+    int32_t result = Om_moveToTrash(this->_bck_path);
+    if(result != 0) {
+      this->_error(L"discardBackup", Om_errDelete(L"Backup archive file", this->_bck_path, result));
+      has_error = true;
+    }
+
+  }
+
+  // revoke the backup side of this package
+  this->clearBackup();
+
+  // making report
+  wchar_t done_str[32];
+  swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
+  this->_log(OM_LOG_OK, L"discardBackup", done_str);
+
+  return has_error ? OM_RESULT_ERROR : OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModPack::compressBackup(Om_progressCb progress_cb, void* user_ptr)
+{
+  if(!this->_ModChan) {
+    this->_error(L"compressBackup", L"no Mod Channel.");
+    return OM_RESULT_ABORT;
+  }
+
+  // only staged Backup need to be compressed
+  if(!this->_has_bck || !this->_bck_stage)
+    return OM_RESULT_OK;
+
+  // Mod Channel was set to uncompressed Backup meanwhile, keep it as is
+  if(this->_ModChan->backupCompMethod() < 0)
+    return OM_RESULT_OK;
+
+  // initialize chrono
+  clock_t time = clock();
+
+  OmWString cfg_path = this->_bck_path + L"\\ModBack.xml";
+
+  // load staged Backup definition
+  OmXmlConf backup_cfg;
+
+  if(!backup_cfg.load(cfg_path, OM_XMAGIC_BCK)) {
+    this->_error(L"compressBackup", Om_errLoad(L"definition file", cfg_path, backup_cfg.lastErrorStr()));
+    return OM_RESULT_ERROR;
+  }
+
+  // archive is written aside then renamed once completed, so the staged
+  // Backup remains valid in case anything goes wrong
+  OmWString bck_path = this->_bck_path + L"." OM_BCK_FILE_EXT;
+  OmWString tmp_path = bck_path + L".tmp";
+
+  OmArchive backup_zip;
+
+  if(!backup_zip.write(tmp_path, this->_ModChan->backupCompMethod(), this->_ModChan->backupCompLevel(), this->_ModChan->backupAdaptive())) {
+    this->_error(L"compressBackup", Om_errInit(L"Backup archive file", tmp_path, backup_zip.lastErrorStr()));
+    return OM_RESULT_ERROR;
+  }
+
+  // queue staged files, entries are added to zip in the same order they
+  // are listed in definition
+  OmWStringArray zip_srcs, zip_dsts;
+  OmWString zip_file;
+
+  OmXmlNodeArray xml_node_ls;
+  backup_cfg.children(xml_node_ls, L"cpy");
+
+  for(size_t i = 0; i < xml_node_ls.size(); ++i) {
+
+    OmWString path = xml_node_ls[i].content();
+
+    Om_concatPaths(zip_file, this->_bck_root, path);
+    zip_srcs.push_back(zip_file);
+
+    Om_concatPaths(zip_file, BACKUP_DATA_ROOT_DIR, path);
+    zip_dsts.push_back(zip_file);
+
+    xml_node_ls[i].setAttr(L"cdi", static_cast<int>(i));
+  }
+
+  bool has_error = false;
+  bool has_abort = false;
+
+  // single worker, this is intended to run in background without disturbing
+  batch_progress_t relay = {progress_cb, user_ptr, zip_srcs.size(), 0,
+                            reinterpret_cast<uint64_t>(this), nullptr, false};
 
-    int32_t result = Om_moveToTrash(this->_bck_path);
-    if(result != 0) {
-      this->_error(L"discardBackup", Om_errDelete(L"Backup data directory", this->_bck_path, result));
+  if(!backup_zip.entryAddMany(zip_srcs, zip_dsts, 1, progress_cb ? __batch_progress_fn : nullptr, &relay)) {
+    if(relay.aborted) {
+      has_abort = true;
+    } else {
+      this->_error(L"compressBackup", Om_errZipComp(L"Backup from staged files", tmp_path, backup_zip.lastErrorStr()));
       has_error = true;
     }
+  }
 
-  } else {
+  if(!has_error && !has_abort) {
 
-    int32_t result = Om_moveToTrash(this->_bck_path);
+    // definition no longer marked as staged
+    backup_cfg.remChild(L"staged");
+
+    OmCString xml_data = backup_cfg.data();
+    if(!backup_zip.entryAdd(xml_data.c_str(), xml_data.size(), L"ModBack.xml")) {
+      this->_error(L"compressBackup", Om_errZipComp(L"definition file", L"ModBack.xml", backup_zip.lastErrorStr()));
+      has_error = true;
+    }
+  }
+
+  // finalize zip archive
+  backup_zip.close();
+
+  if(!has_error && !has_abort) {
+    int32_t result = Om_fileMove(tmp_path, bck_path);
     if(result != 0) {
-      this->_error(L"discardBackup", Om_errDelete(L"Backup archive file", this->_bck_path, result));
+      this->_error(L"compressBackup", Om_errRename(L"Backup archive file", tmp_path, result));
       has_error = true;
     }
+  }
+
+  // staged Backup is kept, it will be compressed next time
+  if(has_error || has_abort) {
+    Om_fileDelete(tmp_path);
+    return has_error ? OM_RESULT_ERROR : OM_RESULT_ABORT;
+  }
+
+  OmWString stg_path = this->_bck_path;
 
+  // switch to compressed Backup, this runs in background while Backup
+  // properties may be read by other threads
+  EnterCriticalSection(&this->_bck_lock);
+
+  // entries that are not to be deleted are listed in the same order than
+  // in definition
+  for(size_t i = 0, z = 0; i < this->_bck_entry.size(); ++i) {
+    if(!OM_HAS_BIT(this->_bck_entry[i].attr, OM_MODENTRY_DEL))
+      this->_bck_entry[i].cdid = z++;
   }
 
-  // revoke the backup side of this package
-  this->clearBackup();
+  this->_bck_path = bck_path;
+
+  this->_bck_isdir = false;
+
+  this->_bck_stage = false;
+
+  this->_bck_root = BACKUP_DATA_ROOT_DIR;
+
+  LeaveCriticalSection(&this->_bck_lock);
+
+  // delete staged definition first so a partially deleted staging directory
+  // cannot be parsed as Backup, if interrupted before, the Library reload
+  // discards the staging directory in favor of the archive
+  int32_t result = Om_fileDelete(cfg_path);
+  if(result == 0)
+    result = Om_dirDeleteRecursive(stg_path);
+
+  if(result != 0) {
+    // do not throw error, simple warning
+    this->_log(OM_LOG_WRN, L"compressBackup", Om_errDelete(L"Backup staging directory", stg_path, result));
+  }
 
   // making report
   wchar_t done_str[32];
   swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
-  this->_log(OM_LOG_OK, L"discardBackup", done_str);
+  this->_log(OM_LOG_OK, L"compressBackup", done_str);
 
-  return has_error ? OM_RESULT_ERROR : OM_RESULT_OK;
+  OmWString adapt_str;
+  if(__adapt_report(&adapt_str, backup_zip))
+    this->_log(OM_LOG_OK, L"compressBackup", adapt_str);
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmResult OmModPack::recoverJournal(const OmWString& path)
+{
+  if(!this->_ModChan) {
+    this->_error(L"recoverJournal", L"no Mod Channel.");
+    return OM_RESULT_ABORT;
+  }
+
+  OmJournal journal;
+
+  int32_t result = journal.load(path);
+  if(result != 0) {
+    this->_error(L"recoverJournal", Om_errLoad(L"operation journal file", path, Om_getErrorStr(result)));
+    return OM_RESULT_ERROR;
+  }
+
+  // interrupted after completion, nothing to recover
+  if(journal.hasRecord(OM_JNL_COMMIT)) {
+    journal.close(true);
+    return OM_RESULT_OK;
+  }
+
+  if(journal.hasRecord(OM_JNL_APPLY)) {
+
+    // Backup was completed, undo journaled install operations
+    if(!this->_jnl_replay(journal))
+      return OM_RESULT_ERROR;
+
+  } else {
+
+    // Backup was not completed, put back moved Target files
+    if(!this->_jnl_revert(journal))
+      return OM_RESULT_ERROR;
+  }
+
+  journal.close(true);
+
+  this->_log(OM_LOG_OK, L"recoverJournal", L"interrupted operation recovered");
+
+  return OM_RESULT_OK;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_jnl_revert(const OmJournal& journal)
+{
+  OmWString bck_root = journal.findRecord(OM_JNL_ROOT);
+  OmWString tgt_path = journal.findRecord(OM_JNL_TARGET);
+
+  // Backups created by the operation, former Backup of an upgraded Mod is
+  // not listed so it is kept
+  OmWStringArray bck_paths;
+  journal.findRecords(OM_JNL_BACKUP, &bck_paths);
+
+  if(tgt_path.empty() || (bck_paths.empty() && !journal.hasRecord(OM_JNL_FORMER))) {
+    this->_error(L"_jnl_revert", L"invalid operation journal.");
+    return false;
+  }
+
+  bool has_error = false;
+
+  OmWString bck_file, tgt_file;
+
+  // Target files are journaled before being moved, so only files actually
+  // found in Backup are put back, in reverse order
+  size_t i = journal.recordCount();
+  while(i--) {
+
+    const OmJnlRec_t& record = journal.getRecord(i);
+
+    if(record.type != OM_JNL_MOVED)
+      continue;
+
+    Om_concatPaths(bck_file, bck_root, record.data);
+    Om_concatPaths(tgt_file, tgt_path, record.data);
+
+    if(!Om_pathExists(bck_file) || Om_pathExists(tgt_file))
+      continue;
+
+    int32_t result = Om_fileMove(bck_file, tgt_file);
+    if(result != 0) {
+      this->_error(L"_jnl_revert", Om_errMove(L"Backup to Target file", tgt_file, result));
+      has_error = true;
+    }
+  }
+
+  // keep Backup data if some files remain
+  if(has_error)
+    return false;
+
+  // delete incomplete Backups
+  for(size_t b = 0; b < bck_paths.size(); ++b) {
+
+    int32_t result = 0;
+
+    if(Om_isDir(bck_paths[b])) {
+      result = Om_dirDeleteRecursive(bck_paths[b]);
+    } else if(Om_pathExists(bck_paths[b])) {
+      result = Om_fileDelete(bck_paths[b]);
+    }
+
+    if(result != 0) {
+      this->_error(L"_jnl_revert", Om_errDelete(L"incomplete Backup", bck_paths[b], result));
+      return false;
+    }
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_jnl_upgrade(const OmModPack* ModPack, const OmWStringArray& file_paths, const OmWStringArray& dir_paths, const OmWStringArray& orig_paths)
+{
+  // from now an interrupted upgrade is recovered by uninstalling both
+  // versions, so former Backup entries are journaled as if just installed
+  for(size_t i = 0; i < ModPack->_bck_entry.size(); ++i) {
+
+    const OmModEntry_t& entry = ModPack->_bck_entry[i];
+
+    if(OM_HAS_BIT(entry.attr, OM_MODENTRY_DEL)) {
+      this->_journal.append(OM_HAS_BIT(entry.attr, OM_MODENTRY_DIR) ? OM_JNL_DIRECTORY : OM_JNL_WRITTEN, entry.path);
+    } else {
+      this->_journal.append(ModPack->_bck_isdir ? OM_JNL_MOVED : OM_JNL_SAVED, entry.path);
+    }
+  }
+
+  // Target original files moved to Backup directory are already journaled
+  if(!ModPack->_bck_isdir) {
+    for(size_t i = 0; i < orig_paths.size(); ++i)
+      this->_journal.append(OM_JNL_SAVED, orig_paths[i]);
+  }
+
+  for(size_t i = 0; i < dir_paths.size(); ++i)
+    this->_journal.append(OM_JNL_DIRECTORY, dir_paths[i]);
+
+  for(size_t i = 0; i < file_paths.size(); ++i)
+    this->_journal.append(OM_JNL_WRITTEN, file_paths[i]);
+
+  this->_journal.append(OM_JNL_APPLY);
+
+  int32_t result = this->_journal.sync();
+  if(result != 0) {
+    this->_error(L"applyUpgrade", Om_errSave(L"operation journal file", this->_journal.path(), Om_getErrorStr(result)));
+    return false;
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmModPack::_jnl_replay(const OmJournal& journal)
+{
+  OmWString tgt_path = journal.findRecord(OM_JNL_TARGET);
+
+  // Backups holding Target original files, an upgrade may have saved them
+  // in both former and new Backup
+  OmWStringArray bck_paths;
+  journal.findRecords(OM_JNL_FORMER, &bck_paths);
+  journal.findRecords(OM_JNL_BACKUP, &bck_paths);
+
+  if(bck_paths.empty() || tgt_path.empty()) {
+    this->_error(L"_jnl_replay", L"invalid operation journal.");
+    return false;
+  }
+
+  bool has_error = false;
+
+  OmWString bck_file, tgt_file;
+
+  size_t count = journal.recordCount();
+
+  // 1. delete files written to Target, in reverse order
+  size_t i = count;
+  while(i--) {
+
+    const OmJnlRec_t& record = journal.getRecord(i);
+
+    if(record.type != OM_JNL_WRITTEN)
+      continue;
+
+    Om_concatPaths(tgt_file, tgt_path, record.data);
+
+    if(!Om_isFile(tgt_file))
+      continue;
+
+    int32_t result = Om_fileDelete(tgt_file);
+    if(result != 0) {
+      this->_error(L"_jnl_replay", Om_errDelete(L"file in Target", tgt_file, result));
+      has_error = true;
+    }
+  }
+
+  // 2. put back journaled Target original files, entries not found in
+  // Backups were either not yet saved or already put back
+  std::vector<uint8_t> restored(count, 0);
+
+  for(size_t b = 0; b < bck_paths.size(); ++b) {
+
+    if(Om_isDir(bck_paths[b])) {
+
+      OmWString bck_root;
+      Om_concatPaths(bck_root, bck_paths[b], BACKUP_DATA_ROOT_DIR);
+
+      i = count;
+      while(i--) {
+
+        const OmJnlRec_t& record = journal.getRecord(i);
+
+        if(record.type != OM_JNL_MOVED || restored[i])
+          continue;
+
+        Om_concatPaths(bck_file, bck_root, record.data);
+        Om_concatPaths(tgt_file, tgt_path, record.data);
+
+        if(!Om_isFile(bck_file))
+          continue;
+
+        int32_t result = Om_fileMove(bck_file, tgt_file);
+        if(result != 0) {
+          this->_error(L"_jnl_replay", Om_errMove(L"Backup to Target file", tgt_file, result));
+          has_error = true;
+        }
+
+        restored[i] = 1;
+      }
+
+    } else if(Om_isFile(bck_paths[b])) {
+
+      OmArchive backup_zip;
+
+      if(!backup_zip.read(bck_paths[b], true)) {
+        this->_error(L"_jnl_replay", Om_errLoad(L"Backup archive file", bck_paths[b], backup_zip.lastErrorStr()));
+        has_error = true; continue;
+      }
+
+      i = count;
+      while(i--) {
+
+        const OmJnlRec_t& record = journal.getRecord(i);
+
+        if(record.type != OM_JNL_SAVED || restored[i])
+          continue;
+
+        Om_concatPaths(bck_file, BACKUP_DATA_ROOT_DIR, record.data);
+        Om_concatPaths(tgt_file, tgt_path, record.data);
+
+        uint32_t cdid = backup_zip.entryLocate(bck_file);
+        if(cdid == static_cast<uint32_t>(-1))
+          continue;
+
+        restored[i] = 1;
+
+        // remaining Target file may be hard link to a Mod source
+        int32_t result = Om_fileDetach(tgt_file);
+        if(result != 0) {
+          this->_error(L"_jnl_replay", Om_errDelete(L"linked file in Target", tgt_file, result));
+          has_error = true; continue;
+        }
+
+        if(!backup_zip.entrySave(cdid, tgt_file)) {
+          this->_error(L"_jnl_replay", Om_errZipExtr(L"Backup to Target file", record.data, backup_zip.lastErrorStr()));
+          has_error = true;
+        }
+      }
+
+      backup_zip.close();
+    }
+  }
+
+  // 3. delete directories created in Target, in reverse order so children
+  // come before parents, directories are kept if not empty
+  i = count;
+  while(i--) {
+
+    const OmJnlRec_t& record = journal.getRecord(i);
+
+    if(record.type != OM_JNL_DIRECTORY)
+      continue;
+
+    Om_concatPaths(tgt_file, tgt_path, record.data);
+
+    if(Om_isDir(tgt_file) && Om_isDirEmpty(tgt_file)) {
+      int32_t result = Om_dirDelete(tgt_file);
+      if(result != 0) {
+        // do not throw error, simple warning
+        this->_log(OM_LOG_WRN, L"_jnl_replay", Om_errDelete(L"directory in Target", tgt_file, result));
+      }
+    }
+  }
+
+  // keep Backup data if some files remain
+  if(has_error)
+    return false;
+
+  // Backup data is no longer needed
+  for(size_t b = 0; b < bck_paths.size(); ++b) {
+
+    int32_t result = 0;
+
+    if(Om_isDir(bck_paths[b])) {
+      result = Om_dirDeleteRecursive(bck_paths[b]);
+    } else if(Om_pathExists(bck_paths[b])) {
+      result = Om_fileDelete(bck_paths[b]);
+    }
+
+    if(result != 0) {
+      this->_error(L"_jnl_replay", Om_errDelete(L"Backup data", bck_paths[b], result));
+      return false;
+    }
+  }
+
+  return true;
 }
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
-OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level, Om_progressCb progress_cb, Om_progressCb compress_cb, void* user_ptr)
+OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level, Om_progressCb progress_cb, Om_progressCb compress_cb, void* user_ptr, bool adaptive)
 {
   // initialize local timer
   clock_t time = clock();
@@ -1610,6 +3564,13 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
     return OM_RESULT_ERROR;
   }
 
+  OmWString load_err;
+
+  if(this->_src_lazy && !this->_src_load_entries(&load_err)) {
+    this->_error(L"saveAs", Om_errLoad(L"Source archive file", this->_src_path, load_err));
+    return OM_RESULT_ERROR;
+  }
+
   OmArchive source_zip;
 
   // verify we have source to save as...
@@ -1631,7 +3592,7 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
   OmWString tmp_path(path); tmp_path.append(L".zc_tmp");
 
   // open output archive for writing
-  if(!output_zip.write(tmp_path, method, level)) {
+  if(!output_zip.write(tmp_path, method, level, adaptive)) {
     this->_error(L"saveAs", Om_errInit(L"Output archive file", tmp_path, output_zip.lastErrorStr()));
     return OM_RESULT_ERROR;
   }
@@ -1651,70 +3612,83 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
 
   OmWString out_file;
 
-  // transfer data from source to output zip
-  for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+  if(this->_src_isdir) {
 
-    // output file path (in zip)
-    Om_concatPaths(out_file, out_root, this->_src_entry[i].path);
+    // compress source files using parallel workers, entries are added to
+    // destination archive in the original order
+    OmWStringArray src_files, out_files;
+    OmWString src_file;
 
-    if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
+    for(size_t i = 0; i < this->_src_entry.size(); ++i) {
+      Om_concatPaths(src_file, this->_src_root, this->_src_entry[i].path);
+      Om_concatPaths(out_file, out_root, this->_src_entry[i].path);
+      src_files.push_back(src_file);
+      out_files.push_back(out_file);
+    }
 
-      // add folder to destination archive
-      if(!output_zip.entryAdd(nullptr, 0, out_file)) {
-        this->_error(L"saveAs", Om_errZipComp(L"Source directory to destination", out_file, output_zip.lastErrorStr()));
-        has_error = true; break;
+    saveas_progress_t relay = {{progress_cb, user_ptr, this->_src_entry.size(), 0,
+                               reinterpret_cast<uint64_t>(this), nullptr, false, false}, compress_cb};
+
+    bool relayed = progress_cb || compress_cb;
+
+    if(!output_zip.entryAddMany(src_files, out_files, 0, relayed ? __saveas_progress_fn : nullptr, &relay)) {
+      if(relay.batch.aborted) {
+        has_abort = true;
+      } else {
+        this->_error(L"saveAs", Om_errZipComp(L"Source files to destination", out_root, output_zip.lastErrorStr()));
+        has_error = true;
       }
+    }
 
-    } else {
+  } else {
 
-      if(this->_src_isdir) {
+    // transfer data from source to output zip
+    for(size_t i = 0; i < this->_src_entry.size(); ++i) {
 
-        // source file path
-        OmWString src_file;
-        Om_concatPaths(src_file, this->_src_root, this->_src_entry[i].path);
+      // output file path (in zip)
+      Om_concatPaths(out_file, out_root, this->_src_entry[i].path);
 
-        if(!output_zip.entryAdd(src_file, out_file, compress_cb, user_ptr)) {
-          this->_error(L"saveAs", Om_errZipComp(L"Source file to destination", src_file, output_zip.lastErrorStr()));
+      if(OM_HAS_BIT(this->_src_entry[i].attr, OM_MODENTRY_DIR)) {
+
+        // add folder to destination archive
+        if(!output_zip.entryAdd(nullptr, 0, out_file)) {
+          this->_error(L"saveAs", Om_errZipComp(L"Source directory to destination", out_file, output_zip.lastErrorStr()));
           has_error = true; break;
         }
 
       } else {
 
-        //transfers data from source to destination via memory buffer
-        uint64_t data_len = source_zip.entrySize(this->_src_entry[i].cdid);
-        uint8_t* data_buf = new(std::nothrow) uint8_t[data_len];
+        if(source_zip.entryMethod(this->_src_entry[i].cdid) == method) {
 
-        if(!data_buf) {
-          this->_error(L"saveAs", Om_errBadAlloc(L"Source file extraction", this->_src_entry[i].path));
-          has_error = true; break;
-        }
+          // same compression method, transfers compressed data as-is
+          if(!output_zip.entryCopyRaw(source_zip, this->_src_entry[i].cdid, out_file, compress_cb, user_ptr)) {
+            this->_error(L"saveAs", Om_errZipComp(L"Destination file", out_file, output_zip.lastErrorStr()));
+            has_error = true; break;
+          }
 
-        if(!source_zip.entrySave(this->_src_entry[i].cdid, data_buf, compress_cb, user_ptr)) {
-          this->_error(L"saveAs", Om_errZipExtr(L"Source file", this->_src_entry[i].path, source_zip.lastErrorStr()));
-          delete [] data_buf; has_error = true; break;
-        }
+        } else {
 
-        if(!output_zip.entryAdd(data_buf, data_len, out_file, compress_cb, user_ptr)) {
-          this->_error(L"saveAs", Om_errZipComp(L"Destination file", out_file, output_zip.lastErrorStr()));
-          delete [] data_buf; has_error = true; break;
+          // transfers data from source to destination by streaming chunks
+          if(!output_zip.entryCopy(source_zip, this->_src_entry[i].cdid, out_file, compress_cb, user_ptr)) {
+            this->_error(L"saveAs", Om_errZipComp(L"Destination file", out_file, output_zip.lastErrorStr()));
+            has_error = true; break;
+          }
         }
 
-        delete [] data_buf;
       }
 
-    }
-
-    // call progression callback
-    if(progress_cb) {
-      entry_cur++;
-      if(!progress_cb(user_ptr, entry_tot, entry_cur, reinterpret_cast<uint64_t>(this))) {
-        has_abort = true; break;
-      }
-    }
+      // call progression callback
+      if(progress_cb) {
+        entry_cur++;
+        if(!progress_cb(user_ptr, entry_tot, entry_cur, reinterpret_cast<uint64_t>(this))) {
+          has_abort = true; break;
+        }
+      }
 
-    #ifdef DEBUG
-    Sleep(50); //< for debug
-    #endif
+      #ifdef DEBUG
+      Sleep(50); //< for debug
+      #endif
+    }
   }
 
   // we do not need source archive anymore
@@ -1872,6 +3846,10 @@ OmResult OmModPack::saveAs(const OmWString& path, int32_t method, int32_t level,
   swprintf(done_str, 32, L"done in %.2fs", (double)(clock()-time)/CLOCKS_PER_SEC);
   this->_log(OM_LOG_OK, L"saveAs", done_str);
 
+  OmWString adapt_str;
+  if(__adapt_report(&adapt_str, output_zip))
+    this->_log(OM_LOG_OK, L"saveAs", adapt_str);
+
   return OM_RESULT_OK;
 }
 
@@ -636,16 +636,58 @@ OmResult OmNetPack::upgradeReplace(Om_progressCb progress_cb, void* user_ptr)
   // prepare Mods uninstall and backups restoration
   this->_ModChan->prepareRestores(selection, &restores, &overlaps, &depends);
 
+  // if the only replaced Mod to uninstall is not overlapped nor required by
+  // others, this version is installed over it, applying only differences
+  bool delta_applied = false;
+
+  bool delta_allowed = (selection.size() == 1 && restores.size() == 1 && !this_ModPack->hasBackup());
+
+  if(delta_allowed) {
+
+    // this installs the new version right away, which is only acceptable
+    // when all its dependencies are already installed, otherwise Mod is
+    // left uninstalled ready for manual install (see step 4 below)
+    OmPModPackArray installs;
+    OmWStringArray inst_overlaps, inst_depends, inst_missings;
+
+    this->_ModChan->prepareInstalls(OmPModPackArray(1, this_ModPack), &installs, &inst_overlaps, &inst_depends, &inst_missings);
+
+    if(!inst_depends.empty() || !inst_missings.empty())
+      delta_allowed = false;
+  }
+
+  if(delta_allowed) {
+
+    OmResult result = this_ModPack->applyUpgrade(selection[0], OmNetPack::_upg_progress_fn, this);
+
+    // Backup may have moved from former to this version
+    this->_ModChan->indexFootprint(selection[0]);
+    this->_ModChan->indexFootprint(this_ModPack);
+
+    if(result != OM_RESULT_ABORT) {
+
+      // Backup now belongs to this version, whatever happened
+      delta_applied = true;
+
+      if(result != OM_RESULT_OK) {
+        this->_error(L"upgradeReplace", this_ModPack->lastError());
+        has_error = true;
+      }
+    }
+  }
+
   // perform Mods uninstall and backups restoration
-  for(size_t i = 0; i < restores.size(); ++i) {
+  for(size_t i = 0; i < restores.size() && !delta_applied; ++i) {
 
     // keep hash of uinstalled package to be re-installed later
     unins_hash.push_back(restores[i]->hash());
 
-    if(!restores[i]->restoreData(OmNetPack::_upg_progress_fn, this)) {
+    if(restores[i]->restoreData(OmNetPack::_upg_progress_fn, this) != OM_RESULT_OK) {
       this->_error(L"upgradeReplace", restores[i]->lastError());
       has_error = true;
     }
+
+    this->_ModChan->indexFootprint(restores[i]);
   }
 
   // 2. remove and replace all references in Mod Presets
@@ -155,6 +155,22 @@ bool OmUiPropChn::checkChanges()
     }
   }
 
+  if(UiPropChnLib->paramChanged(CHN_PROP_LIB_HARDLINK)) {
+    if(UiPropChnLib->msgItem(IDC_BC_CKBX8, BM_GETCHECK) != this->_ModChan->libraryHardlink()) {
+      changed = true;
+    } else {
+      UiPropChnLib->paramReset(CHN_PROP_LIB_HARDLINK);
+    }
+  }
+
+  if(UiPropChnLib->paramChanged(CHN_PROP_LIB_SKIPSAME)) {
+    if(UiPropChnLib->msgItem(IDC_BC_CKBX9, BM_GETCHECK) != this->_ModChan->librarySkipsame()) {
+      changed = true;
+    } else {
+      UiPropChnLib->paramReset(CHN_PROP_LIB_SKIPSAME);
+    }
+  }
+
   if(UiPropChnLib->paramChanged(CHN_PROP_LIB_WARNINGS)) {
 
     different = false;
@@ -243,6 +259,22 @@ bool OmUiPropChn::checkChanges()
 
   }
 
+  if(UiPropChnBck->paramChanged(CHN_PROP_BCK_STAGING)) {
+    if(UiPropChnBck->msgItem(IDC_BC_CKBX3, BM_GETCHECK) != this->_ModChan->backupStaging()) {
+      changed = true;
+    } else {
+      UiPropChnBck->paramReset(CHN_PROP_BCK_STAGING);
+    }
+  }
+
+  if(UiPropChnBck->paramChanged(CHN_PROP_BCK_ADAPTIVE)) {
+    if(UiPropChnBck->msgItem(IDC_BC_CKBX4, BM_GETCHECK) != this->_ModChan->backupAdaptive()) {
+      changed = true;
+    } else {
+      UiPropChnBck->paramReset(CHN_PROP_BCK_ADAPTIVE);
+    }
+  }
+
   // Mods Repositories Tab
   OmUiPropChnNet* UiPropChnNet  = static_cast<OmUiPropChnNet*>(this->childById(IDD_PROP_CHN_NET));
 /*
@@ -526,6 +558,22 @@ bool OmUiPropChn::applyChanges()
     UiPropChnLib->paramReset(CHN_PROP_LIB_DEVMODE);
   }
 
+  if(UiPropChnLib->paramChanged(CHN_PROP_LIB_HARDLINK)) {
+
+    this->_ModChan->setLibraryHardlink(UiPropChnLib->msgItem(IDC_BC_CKBX8, BM_GETCHECK));
+
+    // Reset parameter as unmodified
+    UiPropChnLib->paramReset(CHN_PROP_LIB_HARDLINK);
+  }
+
+  if(UiPropChnLib->paramChanged(CHN_PROP_LIB_SKIPSAME)) {
+
+    this->_ModChan->setLibrarySkipsame(UiPropChnLib->msgItem(IDC_BC_CKBX9, BM_GETCHECK));
+
+    // Reset parameter as unmodified
+    UiPropChnLib->paramReset(CHN_PROP_LIB_SKIPSAME);
+  }
+
   if(UiPropChnLib->paramChanged(CHN_PROP_LIB_WARNINGS)) {
 
     this->_ModChan->setWarnOverlaps(UiPropChnLib->msgItem(IDC_BC_CKBX3, BM_GETCHECK));
@@ -605,6 +653,22 @@ bool OmUiPropChn::applyChanges()
     UiPropChnBck->paramReset(CHN_PROP_BCK_COMP_LEVEL);
   }
 
+  if(UiPropChnBck->paramChanged(CHN_PROP_BCK_STAGING)) {
+
+    this->_ModChan->setBackupStaging(UiPropChnBck->msgItem(IDC_BC_CKBX3, BM_GETCHECK));
+
+    // Reset parameter as unmodified
+    UiPropChnBck->paramReset(CHN_PROP_BCK_STAGING);
+  }
+
+  if(UiPropChnBck->paramChanged(CHN_PROP_BCK_ADAPTIVE)) {
+
+    this->_ModChan->setBackupAdaptive(UiPropChnBck->msgItem(IDC_BC_CKBX4, BM_GETCHECK));
+
+    // Reset parameter as unmodified
+    UiPropChnBck->paramReset(CHN_PROP_BCK_ADAPTIVE);
+  }
+
   // Mods Repositories Tab
   OmUiPropChnNet* UiPropChnNet  = static_cast<OmUiPropChnNet*>(this->childById(IDD_PROP_CHN_NET));
 /*
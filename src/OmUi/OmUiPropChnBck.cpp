@@ -98,6 +98,8 @@ void OmUiPropChnBck::_comp_backup_toggle()
   this->enableItem(IDC_CB_ZMD, bm_chk);
   this->enableItem(IDC_SC_LBL02, bm_chk);
   this->enableItem(IDC_CB_ZLV, bm_chk);
+  this->enableItem(IDC_BC_CKBX3, bm_chk);
+  this->enableItem(IDC_BC_CKBX4, bm_chk);
 
   this->paramCheck(CHN_PROP_BCK_COMP_LEVEL);
 }
@@ -115,6 +117,8 @@ void OmUiPropChnBck::_onTbInit()
   this->_createTooltip(IDC_BC_CKBX2,  L"Use compressed archive instead of directories trees");
   this->_createTooltip(IDC_CB_ZMD,    L"Compression method for backup archives");
   this->_createTooltip(IDC_CB_ZLV,    L"Compression level for backup archives");
+  this->_createTooltip(IDC_BC_CKBX3,  L"When on the same drive, move original files to Backup directory then compress them in background");
+  this->_createTooltip(IDC_BC_CKBX4,  L"Store files such as images, sounds or archives, whose data is already compressed, without compressing them again");
 
   // Set buttons inner icons
   this->setBmIcon(IDC_BC_DEL, Om_getResIcon(IDI_BT_WRN));
@@ -207,6 +211,9 @@ void OmUiPropChnBck::_onTbRefresh()
 */
     this->enableItem(IDC_CB_ZLV, true);
 
+    this->enableItem(IDC_BC_CKBX3, true);
+    this->enableItem(IDC_BC_CKBX4, true);
+
   } else {
 
     this->msgItem(IDC_BC_CKBX2, BM_SETCHECK, 0);
@@ -214,7 +221,12 @@ void OmUiPropChnBck::_onTbRefresh()
     this->enableItem(IDC_CB_ZMD, false);
     this->msgItem(IDC_CB_ZLV, CB_SETCURSEL, 2);
     this->enableItem(IDC_CB_ZLV, false);
+    this->enableItem(IDC_BC_CKBX3, false);
+    this->enableItem(IDC_BC_CKBX4, false);
   }
+
+  this->msgItem(IDC_BC_CKBX3, BM_SETCHECK, ModChan->backupStaging());
+  this->msgItem(IDC_BC_CKBX4, BM_SETCHECK, ModChan->backupAdaptive());
 }
 
 ///
@@ -245,6 +257,12 @@ void OmUiPropChnBck::_onTbResize()
   this->_setItemPos(IDC_CB_ZLV, 190, y_base+135, this->cliWidth()-270, 21, true);
   // force ComboBox to repaint by invalidate rect, else it randomly disappears on resize
   InvalidateRect(this->getItem(IDC_CB_ZLV), nullptr, true);
+
+  // Backup staging CheckBox
+  this->_setItemPos(IDC_BC_CKBX3, 75, y_base+165, 350, 16, true);
+
+  // Backup adaptive compression CheckBox
+  this->_setItemPos(IDC_BC_CKBX4, 75, y_base+185, 350, 16, true);
 }
 
 ///
@@ -285,6 +303,16 @@ INT_PTR OmUiPropChnBck::_onTbMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
       if(HIWORD(wParam) == CBN_SELCHANGE)
         this->paramCheck(CHN_PROP_BCK_COMP_LEVEL);
       break;
+
+    case IDC_BC_CKBX3: //< CheckBox: stage backup data
+      if(HIWORD(wParam) == BN_CLICKED)
+        this->paramCheck(CHN_PROP_BCK_STAGING);
+      break;
+
+    case IDC_BC_CKBX4: //< CheckBox: store compressed data
+      if(HIWORD(wParam) == BN_CLICKED)
+        this->paramCheck(CHN_PROP_BCK_ADAPTIVE);
+      break;
     }
   }
 
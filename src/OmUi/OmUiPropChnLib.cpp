@@ -91,8 +91,11 @@ void OmUiPropChnLib::_onTbInit()
   this->_createTooltip(IDC_BC_BRW01,  L"Select custom Mod Library directory");
 
   this->_createTooltip(IDC_BC_CKBX2,  L"Parse Library's sub-directories as Mods for development purpose or legacy support");
+  this->_createTooltip(IDC_BC_CKBX8,  L"Install files of sub-directory Mods as hard links instead of copies, modifying installed files also modifies Library files");
 
   this->_createTooltip(IDC_BC_CKBX7,  L"Parse and show Library's hidden files and sub-directories");
+
+  this->_createTooltip(IDC_BC_CKBX9,  L"Do not backup nor overwrite files that already have the same content as Mod archive files");
 
   this->_createTooltip(IDC_BC_CKBX3,  L"Warn if Mod installation will overlap any previously installed");
   this->_createTooltip(IDC_BC_CKBX4,  L"Warn if Mod install require additional dependencies installation");
@@ -118,11 +121,14 @@ void OmUiPropChnLib::_onTbRefresh()
   this->enableItem(IDC_BC_BRW01, ModChan->hasCustLibraryPath());
 
   this->msgItem(IDC_BC_CKBX2, BM_SETCHECK, ModChan->libraryDevmod());
+  this->msgItem(IDC_BC_CKBX8, BM_SETCHECK, ModChan->libraryHardlink());
+  this->enableItem(IDC_BC_CKBX8, ModChan->libraryDevmod());
   this->msgItem(IDC_BC_CKBX3, BM_SETCHECK, ModChan->warnOverlaps());
   this->msgItem(IDC_BC_CKBX4, BM_SETCHECK, ModChan->warnExtraInst());
   this->msgItem(IDC_BC_CKBX5, BM_SETCHECK, ModChan->warnMissDeps());
   this->msgItem(IDC_BC_CKBX6, BM_SETCHECK, ModChan->warnExtraUnin());
   this->msgItem(IDC_BC_CKBX7, BM_SETCHECK, ModChan->libraryShowhidden());
+  this->msgItem(IDC_BC_CKBX9, BM_SETCHECK, ModChan->librarySkipsame());
 }
 
 
@@ -141,18 +147,23 @@ void OmUiPropChnLib::_onTbResize()
 
   // Library Dev Mode CheckBox
   this->_setItemPos(IDC_BC_CKBX2, 50, y_base+60, 300, 16, true);
+  // Library Hard Link CheckBox
+  this->_setItemPos(IDC_BC_CKBX8, 75, y_base+80, 300, 16, true);
 
   // Show Hidden CheckBox
   this->_setItemPos(IDC_BC_CKBX7, 50, y_base+100, 300, 16, true);
 
+  // Skip identical files CheckBox
+  this->_setItemPos(IDC_BC_CKBX9, 50, y_base+120, 300, 16, true);
+
   // Enable warnings Label
-  this->_setItemPos(IDC_SC_LBL01, 50, y_base+140, 300, 16, true);
+  this->_setItemPos(IDC_SC_LBL01, 50, y_base+160, 300, 16, true);
 
   // Enable warnings CheckBoxes
-  this->_setItemPos(IDC_BC_CKBX3, 75, y_base+160, 300, 16, true);
-  this->_setItemPos(IDC_BC_CKBX4, 75, y_base+180, 300, 16, true);
-  this->_setItemPos(IDC_BC_CKBX5, 75, y_base+200, 300, 16, true);
-  this->_setItemPos(IDC_BC_CKBX6, 75, y_base+220, 300, 16, true);
+  this->_setItemPos(IDC_BC_CKBX3, 75, y_base+180, 300, 16, true);
+  this->_setItemPos(IDC_BC_CKBX4, 75, y_base+200, 300, 16, true);
+  this->_setItemPos(IDC_BC_CKBX5, 75, y_base+220, 300, 16, true);
+  this->_setItemPos(IDC_BC_CKBX6, 75, y_base+240, 300, 16, true);
 }
 
 
@@ -183,10 +194,18 @@ INT_PTR OmUiPropChnLib::_onTbMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
         this->_browse_dir_library();
       break;
 
-    case IDC_BC_CKBX2: //< CheckBox: development mode
-      if(HIWORD(wParam) == BN_CLICKED)
+    case IDC_BC_CKBX2: //< CheckBox: development mode
+      if(HIWORD(wParam) == BN_CLICKED) {
+        this->enableItem(IDC_BC_CKBX8, this->msgItem(IDC_BC_CKBX2, BM_GETCHECK));
         // notify parameter changes
         this->paramCheck(CHN_PROP_LIB_DEVMODE);
+      }
+      break;
+
+    case IDC_BC_CKBX8: //< CheckBox: hard link install
+      if(HIWORD(wParam) == BN_CLICKED)
+        // notify parameter changes
+        this->paramCheck(CHN_PROP_LIB_HARDLINK);
       break;
 
     case IDC_BC_CKBX7: //< CheckBox : show hidden files/directories
@@ -194,6 +213,12 @@ INT_PTR OmUiPropChnLib::_onTbMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
         // notify parameter changes
         this->paramCheck(CHN_PROP_LIB_SHOWHIDDEN);
       break;
+
+    case IDC_BC_CKBX9: //< CheckBox : skip identical files
+      if(HIWORD(wParam) == BN_CLICKED)
+        // notify parameter changes
+        this->paramCheck(CHN_PROP_LIB_SKIPSAME);
+      break;
 
     case IDC_BC_CKBX3: //< CheckBox : Warn overlapping
     case IDC_BC_CKBX4: //< CheckBox : Warn extra installs
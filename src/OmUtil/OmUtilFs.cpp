@@ -21,6 +21,219 @@
 #include <ShlObj.h>           //< SHCreateDirectoryExW
 
 #define READ_BUF_SIZE 524288
+
+#define COPY_MAX_THREADS  16    //< maximum workers for batch copy
+#define COPY_POLL_DELAY   50    //< workers progression poll delay (ms)
+
+/// \brief Batch workers count
+///
+/// Get the actual count of batch workers to run for the given count of
+/// jobs, according requested count and processor count.
+///
+/// \param[in] threads   : Requested count of workers, zero for processor count.
+/// \param[in] jobs      : Count of jobs to process.
+///
+/// \return Count of workers to run.
+///
+static uint32_t __fs_batch_threads(uint32_t threads, size_t jobs)
+{
+  if(threads == 0) {
+    SYSTEM_INFO sys_info;
+    GetSystemInfo(&sys_info);
+    threads = sys_info.dwNumberOfProcessors;
+  }
+
+  if(threads > COPY_MAX_THREADS)
+    threads = COPY_MAX_THREADS;
+
+  if(threads > jobs)
+    threads = jobs;
+
+  return threads;
+}
+
+/// \brief Batch path check context
+///
+/// Internal structure shared by batch path check workers.
+///
+typedef struct fs_stat_batch_
+{
+  const OmWStringArray* paths;
+
+  uint8_t*              exists;
+
+  LONG                  jobs_count;
+
+  volatile LONG         jobs_next;
+
+} fs_stat_batch_t;
+
+/// \brief Batch path check worker
+///
+/// Thread function of batch path check worker, each worker checks paths
+/// until none remain.
+///
+/// \param[in] ptr       : Pointer to batch path check context.
+///
+static DWORD WINAPI __fs_stat_run_fn(void* ptr)
+{
+  fs_stat_batch_t* batch = static_cast<fs_stat_batch_t*>(ptr);
+
+  while(true) {
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    batch->exists[j] = PathFileExistsW((*batch->paths)[j].c_str()) ? 1 : 0;
+  }
+
+  return 0;
+}
+
+/// \brief Batch delete context
+///
+/// Internal structure shared by batch delete workers.
+///
+typedef struct fs_del_batch_
+{
+  const OmWStringArray* paths;
+
+  int32_t*              results;
+
+  LONG                  jobs_count;
+
+  volatile LONG         jobs_next;
+
+  volatile LONG         errors;
+
+} fs_del_batch_t;
+
+/// \brief Batch delete worker
+///
+/// Thread function of batch delete worker, each worker deletes files
+/// until none remain.
+///
+/// \param[in] ptr       : Pointer to batch delete context.
+///
+static DWORD WINAPI __fs_del_run_fn(void* ptr)
+{
+  fs_del_batch_t* batch = static_cast<fs_del_batch_t*>(ptr);
+
+  while(true) {
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    int32_t result = 0;
+
+    if(!DeleteFileW((*batch->paths)[j].c_str())) {
+      result = GetLastError();
+      InterlockedIncrement(&batch->errors);
+    }
+
+    if(batch->results)
+      batch->results[j] = result;
+  }
+
+  return 0;
+}
+
+/// \brief Batch copy context
+///
+/// Internal structure shared by batch copy workers.
+///
+typedef struct fs_copy_batch_
+{
+  const OmWStringArray* srcs;
+
+  const OmWStringArray* dsts;
+
+  LONG                  jobs_count;
+
+  volatile LONG         jobs_next;
+
+  volatile LONG         jobs_done;
+
+  volatile LONG         jobs_last;    //< index of last completed job
+
+  volatile LONG         abort;
+
+  volatile LONG         error;        //< first error code
+
+  volatile LONG         failed;       //< index of first failed job
+
+  bool                  link;         //< create hard links instead of copies
+
+} fs_copy_batch_t;
+
+/// \brief Link or copy file
+///
+/// Creates destination as hard link to source file, falling back to regular
+/// copy if source and destination volumes does not support or share links.
+///
+/// \param[in] src       : Source file path.
+/// \param[in] dst       : Destination file path.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __fs_link_file(const wchar_t* src, const wchar_t* dst)
+{
+  // hard link cannot replace existing file, this also ensure we never write
+  // through a link shared with another file
+  if(!DeleteFileW(dst)) {
+    if(GetLastError() != ERROR_FILE_NOT_FOUND)
+      return false;
+  }
+
+  if(CreateHardLinkW(dst, src, nullptr))
+    return true;
+
+  // not the same volume or file system does not support hard links, copy
+  // file, which also uses block cloning where the file system allows it
+  return CopyFileW(src, dst, false);
+}
+
+/// \brief Batch copy worker
+///
+/// Thread function of batch copy worker, each worker copies files until
+/// none remain or an error occurs.
+///
+/// \param[in] ptr       : Pointer to batch copy context.
+///
+static DWORD WINAPI __fs_copy_run_fn(void* ptr)
+{
+  fs_copy_batch_t* batch = static_cast<fs_copy_batch_t*>(ptr);
+
+  while(!batch->abort) {
+
+    LONG j = InterlockedIncrement(&batch->jobs_next) - 1;
+    if(j >= batch->jobs_count)
+      break;
+
+    bool done;
+
+    if(batch->link) {
+      done = __fs_link_file((*batch->srcs)[j].c_str(), (*batch->dsts)[j].c_str());
+    } else {
+      done = CopyFileW((*batch->srcs)[j].c_str(), (*batch->dsts)[j].c_str(), false);
+    }
+
+    if(!done) {
+      // keep only the first error
+      if(InterlockedCompareExchange(&batch->error, GetLastError(), 0) == 0)
+        InterlockedExchange(&batch->failed, j);
+      InterlockedExchange(&batch->abort, 1);
+      return 1;
+    }
+
+    InterlockedExchange(&batch->jobs_last, j);
+    InterlockedIncrement(&batch->jobs_done);
+  }
+
+  return 0;
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
@@ -75,6 +288,165 @@ int Om_fileCopy(const OmWString& src, const OmWString& dst, bool ow = true)
   return 0;
 }
 
+/// \brief Batch copy files
+///
+/// Common implementation for batch copy and batch link of files.
+///
+/// \param[in]  srcs        : Source files paths.
+/// \param[in]  dsts        : Destination files paths.
+/// \param[in]  threads     : Count of workers, zero to use processor count.
+/// \param[out] failed      : Optional pointer to receive failed file index.
+/// \param[in]  progress_cb : Optional progression callback.
+/// \param[in]  user_ptr    : Custom pointer passed to progression callback.
+/// \param[in]  link        : Create hard links instead of copies.
+///
+/// \return 0 if operation succeed, ERROR_CANCELLED if aborted, WinAPI error
+///         code otherwise.
+///
+static int __fs_copy_many(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads, size_t* failed, Om_progressCb progress_cb, void* user_ptr, bool link)
+{
+  if(srcs.size() != dsts.size())
+    return ERROR_INVALID_PARAMETER;
+
+  // get count of workers to run
+  threads = __fs_batch_threads(threads, srcs.size());
+
+  // single thread, we simply copy files one by one
+  if(threads <= 1) {
+
+    for(size_t i = 0; i < srcs.size(); ++i) {
+
+      bool done;
+
+      if(link) {
+        done = __fs_link_file(srcs[i].c_str(), dsts[i].c_str());
+      } else {
+        done = CopyFileW(srcs[i].c_str(), dsts[i].c_str(), false);
+      }
+
+      if(!done) {
+        if(failed) *failed = i;
+        return GetLastError();
+      }
+
+      if(progress_cb) {
+        if(!progress_cb(user_ptr, srcs.size(), i + 1, reinterpret_cast<uint64_t>(dsts[i].c_str())))
+          return ERROR_CANCELLED;
+      }
+    }
+
+    return 0;
+  }
+
+  fs_copy_batch_t batch;
+  batch.srcs = &srcs;
+  batch.dsts = &dsts;
+  batch.jobs_count = srcs.size();
+  batch.jobs_next = 0;
+  batch.jobs_done = 0;
+  batch.jobs_last = 0;
+  batch.abort = 0;
+  batch.error = 0;
+  batch.failed = 0;
+  batch.link = link;
+
+  HANDLE hthreads[COPY_MAX_THREADS];
+  DWORD hthreads_count = 0;
+
+  for(uint32_t t = 0; t < threads; ++t) {
+    HANDLE hth = Om_threadCreate(__fs_copy_run_fn, &batch);
+    if(hth) hthreads[hthreads_count++] = hth;
+  }
+
+  if(hthreads_count == 0)
+    return ERROR_TOO_MANY_TCBS;
+
+  // wait for workers, progression callback is called from this thread
+  LONG jobs_done = 0;
+  bool has_abort = false;
+
+  int wait_error = 0;
+
+  while(true) {
+
+    DWORD result = WaitForMultipleObjects(hthreads_count, hthreads, TRUE, COPY_POLL_DELAY);
+
+    if(result == WAIT_FAILED) {
+      // workers use this stack context, they must end before we return
+      wait_error = GetLastError();
+      InterlockedExchange(&batch.abort, 1);
+      for(DWORD t = 0; t < hthreads_count; ++t)
+        WaitForSingleObject(hthreads[t], INFINITE);
+      break;
+    }
+
+    if(progress_cb && !has_abort && batch.jobs_done != jobs_done) {
+      jobs_done = batch.jobs_done;
+      if(!progress_cb(user_ptr, srcs.size(), jobs_done, reinterpret_cast<uint64_t>(dsts[batch.jobs_last].c_str()))) {
+        InterlockedExchange(&batch.abort, 1);
+        has_abort = true;
+      }
+    }
+
+    if(result != WAIT_TIMEOUT)
+      break;
+  }
+
+  for(DWORD t = 0; t < hthreads_count; ++t)
+    CloseHandle(hthreads[t]);
+
+  if(wait_error != 0)
+    return wait_error;
+
+  if(batch.error != 0) {
+    if(failed) *failed = batch.failed;
+    return batch.error;
+  }
+
+  return has_abort ? ERROR_CANCELLED : 0;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileCopyMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads, size_t* failed, Om_progressCb progress_cb, void* user_ptr)
+{
+  return __fs_copy_many(srcs, dsts, threads, failed, progress_cb, user_ptr, false);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileLinkMany(const OmWStringArray& srcs, const OmWStringArray& dsts, uint32_t threads, size_t* failed, Om_progressCb progress_cb, void* user_ptr)
+{
+  return __fs_copy_many(srcs, dsts, threads, failed, progress_cb, user_ptr, true);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int Om_fileDetach(const OmWString& path)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES,
+                             FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return 0; //< nothing to detach
+
+  BY_HANDLE_FILE_INFORMATION info;
+  bool shared = GetFileInformationByHandle(hFile, &info) && info.nNumberOfLinks > 1;
+
+  CloseHandle(hFile);
+
+  if(shared) {
+    if(!DeleteFileW(path.c_str()))
+      return GetLastError();
+  }
+
+  return 0;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -97,6 +469,46 @@ int Om_fileDelete(const OmWString& path)
   return 0;
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+size_t Om_fileDeleteMany(const OmWStringArray& paths, int32_t* results, uint32_t threads)
+{
+  // get count of workers to run
+  threads = __fs_batch_threads(threads, paths.size());
+
+  fs_del_batch_t batch;
+  batch.paths = &paths;
+  batch.results = results;
+  batch.jobs_count = paths.size();
+  batch.jobs_next = 0;
+  batch.errors = 0;
+
+  HANDLE hthreads[COPY_MAX_THREADS];
+  DWORD hthreads_count = 0;
+
+  if(threads > 1) {
+    for(uint32_t t = 0; t < threads; ++t) {
+      HANDLE hth = Om_threadCreate(__fs_del_run_fn, &batch);
+      if(hth) hthreads[hthreads_count++] = hth;
+    }
+  }
+
+  // this thread takes its part of the work, or all the work if no worker
+  // could be created
+  __fs_del_run_fn(&batch);
+
+  if(hthreads_count) {
+
+    WaitForMultipleObjects(hthreads_count, hthreads, TRUE, INFINITE);
+
+    for(DWORD t = 0; t < hthreads_count; ++t)
+      CloseHandle(hthreads[t]);
+  }
+
+  return batch.errors;
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -138,6 +550,23 @@ bool Om_pathIsNetwork(const OmWString& path)
   return PathIsNetworkPathW(path.c_str());
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_pathSameVolume(const OmWString& path1, const OmWString& path2)
+{
+  wchar_t vol1[OM_MAX_PATH];
+  wchar_t vol2[OM_MAX_PATH];
+
+  if(!GetVolumePathNameW(path1.c_str(), vol1, OM_MAX_PATH))
+    return false;
+
+  if(!GetVolumePathNameW(path2.c_str(), vol2, OM_MAX_PATH))
+    return false;
+
+  return (lstrcmpiW(vol1, vol2) == 0);
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -146,6 +575,43 @@ bool Om_pathExists(const OmWString& path)
   return PathFileExistsW(path.c_str());
 }
 
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_pathExistsMany(const OmWStringArray& paths, uint8_t* exists, uint32_t threads)
+{
+  // get count of workers to run
+  threads = __fs_batch_threads(threads, paths.size());
+
+  fs_stat_batch_t batch;
+  batch.paths = &paths;
+  batch.exists = exists;
+  batch.jobs_count = paths.size();
+  batch.jobs_next = 0;
+
+  HANDLE hthreads[COPY_MAX_THREADS];
+  DWORD hthreads_count = 0;
+
+  if(threads > 1) {
+    for(uint32_t t = 0; t < threads; ++t) {
+      HANDLE hth = Om_threadCreate(__fs_stat_run_fn, &batch);
+      if(hth) hthreads[hthreads_count++] = hth;
+    }
+  }
+
+  // this thread takes its part of the work, or all the work if no worker
+  // could be created
+  __fs_stat_run_fn(&batch);
+
+  if(hthreads_count) {
+
+    WaitForMultipleObjects(hthreads_count, hthreads, TRUE, INFINITE);
+
+    for(DWORD t = 0; t < hthreads_count; ++t)
+      CloseHandle(hthreads[t]);
+  }
+}
+
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
 ///
@@ -879,6 +1345,46 @@ uint8_t* Om_loadBinary(uint64_t* size, const OmWString& path)
 
   return data;
 }
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int32_t Om_saveBinary(const OmWString& path, const uint8_t* data, uint64_t size)
+{
+  // create or truncate file for writing
+  HANDLE hFile = CreateFileW( path.c_str(), GENERIC_WRITE, 0,
+                              nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return GetLastError();
+
+  int32_t result = 0;
+
+  // write by chunks since a single write is limited to DWORD size
+  uint64_t done = 0;
+  while(done < size) {
+
+    DWORD chunk = (size - done) > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size - done);
+
+    DWORD wb;
+    if(!WriteFile(hFile, data + done, chunk, &wb, nullptr)) {
+      result = GetLastError(); break;
+    }
+
+    // short write without error, most likely out of space
+    if(wb != chunk) {
+      result = ERROR_HANDLE_DISK_FULL; break;
+    }
+
+    done += wb;
+  }
+
+  // close file
+  CloseHandle(hFile);
+
+  return result;
+}
 
 ///
 ///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
@@ -22,6 +22,8 @@
 
 #include "xxhash/xxh3.h"
 #include "md5/md5.h"
+#include "minizip-ng/mz.h"
+#include "minizip-ng/mz_crypt.h"
 
 static std::mt19937                             __rnd_generator(time(0));
 static std::uniform_int_distribution<uint8_t>   __rnd_uint8dist(0, 255);
@@ -366,6 +368,38 @@ uint64_t Om_getCRC64(const OmWString& str)
 {
   return __CRC64(0, (unsigned char*)str.c_str(), str.size()*sizeof(wchar_t));
 }
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_getCRC32digest(uint32_t* crc, const OmWString& path)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  DWORD rb;
+
+  uint32_t value = 0;
+
+  uint8_t read_buf[READ_BUF_SIZE];
+
+  while(ReadFile(hFile, read_buf, READ_BUF_SIZE, &rb, nullptr)) {
+
+    if(rb == 0)
+      break;
+
+    value = mz_crypt_crc32_update(value, read_buf, rb);
+  }
+
+  CloseHandle(hFile);
+
+  *crc = value;
+
+  return true;
+}
 
 /// \brief Generate file XXHash3 digest (checksum)
 ///
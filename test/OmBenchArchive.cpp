@@ -0,0 +1,435 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+
+#include "OmBaseWin.h"        //< WinAPI
+
+#include "OmUtilStr.h"
+#include "OmUtilFs.h"
+
+#include "OmArchive.h"
+
+#include "OmTest.h"
+
+#define BENCH_LOCATE_LOOKUPS  10000         //< hash index lookups per size
+#define BENCH_LOCATE_SCANS    200           //< linear scan lookups per size
+
+#define BENCH_MAPPED_SIZE     0x40000000ULL //< 1 GiB
+#define BENCH_MAPPED_ROUNDS   2
+
+#define BENCH_BATCH_FILES     64
+#define BENCH_BATCH_SIZE      0x100000      //< 1 MiB
+
+#define BENCH_MiB             1048576.0
+
+/// \brief Benchmark entry path
+///
+/// Composes path of entry at index, spread among subdirectories.
+///
+/// \param[in]  index   : Entry index.
+///
+/// \return Entry path.
+///
+static OmWString __bench_entry_path(size_t index)
+{
+  wchar_t path_buf[64];
+  swprintf(path_buf, 64, L"data\\dir_%03u\\File_%06u.dat", static_cast<unsigned>(index % 1000), static_cast<unsigned>(index));
+
+  return OmWString(path_buf);
+}
+
+/// \brief Count of processors
+///
+/// \return Count of logical processors of the system.
+///
+static uint32_t __bench_cpu_count()
+{
+  SYSTEM_INFO sys_info;
+  GetSystemInfo(&sys_info);
+
+  return sys_info.dwNumberOfProcessors;
+}
+
+/// \brief Create batch files
+///
+/// Creates the given count of data files in the specified directory, with
+/// either compressible text or pseudo-random data.
+///
+/// \param[in]  dir     : Directory to create files in.
+/// \param[in]  count   : Count of files to create.
+/// \param[in]  noise   : Every other file filled with pseudo-random data.
+/// \param[out] srcs    : Receives created file paths.
+/// \param[out] dsts    : Receives matching entry paths.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __bench_batch_files(const OmWString& dir, size_t count, bool noise, OmWStringArray* srcs, OmWStringArray* dsts)
+{
+  OmWString src_dir = Om_concatPaths(dir, L"src");
+  if(!Om_isDir(src_dir))
+    OM_TEST_CHECK(Om_dirCreate(src_dir) == 0);
+
+  srcs->clear(); dsts->clear();
+
+  for(size_t i = 0; i < count; ++i) {
+
+    dsts->push_back(__bench_entry_path(i));
+    srcs->push_back(Om_concatPaths(src_dir, Om_getFilePart(dsts->back())));
+
+    OM_TEST_CHECK(Om_testDataFile(srcs->back(), BENCH_BATCH_SIZE, i, noise && (i & 1)));
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_directory(const OmWString& dir, size_t count)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"directory.zip");
+
+  // archive with many tiny entries
+  OmArchive zip;
+  OM_TEST_CHECK(zip.write(zip_path, OM_METHOD_STORE, OM_LEVEL_NONE));
+
+  for(size_t i = 0; i < count; ++i)
+    OM_TEST_CHECK(zip.entryAdd("data", 4, __bench_entry_path(i)));
+
+  OM_TEST_CHECK(zip.close());
+
+  // central-directory mirror and hash index memory
+  uint64_t mem_base = Om_testPrivateBytes();
+  OM_TEST_CHECK(zip.read(zip_path));
+  uint64_t mem_read = Om_testPrivateBytes();
+
+  OM_TEST_CHECK(zip.entryCount() == count);
+
+  // lookups with different case than stored paths
+  OmWStringArray names;
+  uint32_t x = 0x9E3779B9;
+
+  for(size_t i = 0; i < BENCH_LOCATE_LOOKUPS; ++i) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    names.push_back(__bench_entry_path(x % count));
+    Om_strToUpper(&names.back());
+  }
+
+  double time = Om_testClock();
+
+  for(size_t i = 0; i < names.size(); ++i)
+    OM_TEST_CHECK(zip.entryLocate(names[i]) != static_cast<uint32_t>(-1));
+
+  double index_us = (Om_testClock() - time) * 1000000.0 / names.size();
+
+  // linear scan, as entry lookup was done before hash index
+  OmWString path;
+
+  time = Om_testClock();
+
+  for(size_t i = 0; i < BENCH_LOCATE_SCANS; ++i) {
+
+    bool found = false;
+
+    for(size_t j = 0; j < zip.entryCount() && !found; ++j) {
+      zip.entryPath(j, path);
+      found = Om_namesMatches(path, names[i]);
+    }
+
+    OM_TEST_CHECK(found);
+  }
+
+  double scan_us = (Om_testClock() - time) * 1000000.0 / BENCH_LOCATE_SCANS;
+
+  OM_TEST_CHECK(zip.close());
+
+  std::printf("  %7u entries: lookup %8.3f us (index) %10.1f us (scan), mirror %6.1f bytes/entry\n",
+              static_cast<unsigned>(count), index_us, scan_us,
+              static_cast<double>(mem_read - mem_base) / count);
+
+  Om_fileDelete(zip_path);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_archiveDirectory()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_directory(dir, 1000) &&
+                __bench_directory(dir, 10000) &&
+                __bench_directory(dir, 100000);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_mapped(const OmWString& dir)
+{
+  OmWString big_path = Om_concatPaths(dir, L"big.bin");
+  OmWString zip_path = Om_concatPaths(dir, L"big.zip");
+  OmWString out_path = Om_concatPaths(dir, L"out.bin");
+
+  // sparse zero filled file, stored so entry data is served as-is
+  HANDLE hFile = CreateFileW(big_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  OM_TEST_CHECK(hFile != INVALID_HANDLE_VALUE);
+
+  LARGE_INTEGER pos; pos.QuadPart = BENCH_MAPPED_SIZE;
+  bool sized = SetFilePointerEx(hFile, pos, nullptr, FILE_BEGIN) && SetEndOfFile(hFile);
+  CloseHandle(hFile);
+  OM_TEST_CHECK(sized);
+
+  OmArchive zip;
+  OM_TEST_CHECK(zip.write(zip_path, OM_METHOD_STORE, OM_LEVEL_NONE));
+  OM_TEST_CHECK(zip.entryAdd(big_path, L"big.bin"));
+  OM_TEST_CHECK(zip.close());
+
+  Om_fileDelete(big_path);
+
+  // first rounds include file cache warm up
+  for(size_t r = 0; r < BENCH_MAPPED_ROUNDS; ++r) {
+
+    for(int mapped = 0; mapped < 2; ++mapped) {
+
+      OM_TEST_CHECK(zip.read(zip_path, mapped != 0));
+
+      double time = Om_testClock();
+      OM_TEST_CHECK(zip.entrySave(0, out_path));
+      time = Om_testClock() - time;
+
+      OM_TEST_CHECK(zip.close());
+
+      Om_fileDelete(out_path);
+
+      std::printf("  round %u, %-8s: %8.1f MiB/s\n", static_cast<unsigned>(r + 1),
+                  mapped ? "mapped" : "streamed", (BENCH_MAPPED_SIZE / BENCH_MiB) / time);
+    }
+  }
+
+  Om_fileDelete(zip_path);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_archiveMapped()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_mapped(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_save_many(const OmWString& dir)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"batch.zip");
+  OmWString out_dir = Om_concatPaths(dir, L"out");
+
+  OmWStringArray srcs, dsts;
+  OM_TEST_CHECK(__bench_batch_files(dir, BENCH_BATCH_FILES, false, &srcs, &dsts));
+
+  OmArchive zip;
+  OM_TEST_CHECK(zip.write(zip_path, OM_METHOD_DEFLATE, OM_LEVEL_SLOW));
+  OM_TEST_CHECK(zip.entryAddMany(srcs, dsts));
+  OM_TEST_CHECK(zip.close());
+
+  OM_TEST_CHECK(zip.read(zip_path, true));
+
+  OmIndexArray indices;
+  OmWStringArray outs;
+
+  for(size_t i = 0; i < zip.entryCount(); ++i) {
+    indices.push_back(i);
+    outs.push_back(Om_concatPaths(out_dir, Om_getFilePart(zip.entryPath(i))));
+  }
+
+  uint32_t cpus = __bench_cpu_count();
+
+  for(uint32_t threads = 1; ; threads *= 2) {
+
+    if(threads > cpus) threads = cpus;
+
+    OM_TEST_CHECK(Om_dirCreate(out_dir) == 0);
+
+    double time = Om_testClock();
+    OM_TEST_CHECK(zip.entrySaveMany(indices, outs, threads));
+    time = Om_testClock() - time;
+
+    std::printf("  %2u threads: %6.3fs, %8.1f MiB/s\n", threads, time,
+                (BENCH_BATCH_FILES * BENCH_BATCH_SIZE / BENCH_MiB) / time);
+
+    Om_dirDeleteRecursive(out_dir);
+
+    if(threads == cpus)
+      break;
+  }
+
+  OM_TEST_CHECK(zip.close());
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_archiveSaveMany()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_save_many(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_add_many(const OmWString& dir)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"batch.zip");
+
+  OmWStringArray srcs, dsts;
+  OM_TEST_CHECK(__bench_batch_files(dir, BENCH_BATCH_FILES, false, &srcs, &dsts));
+
+  const int32_t methods[] = {OM_METHOD_DEFLATE, OM_METHOD_LZMA, OM_METHOD_LZMA2, OM_METHOD_ZSTD};
+  const wchar_t* method_names[] = {L"Deflate", L"LZMA", L"LZMA2", L"Zstd"};
+
+  const int32_t levels[] = {OM_LEVEL_FAST, OM_LEVEL_SLOW, OM_LEVEL_BEST};
+
+  uint32_t cpus = __bench_cpu_count();
+
+  double total = BENCH_BATCH_FILES * BENCH_BATCH_SIZE;
+
+  for(size_t m = 0; m < 4; ++m) {
+    for(size_t l = 0; l < 3; ++l) {
+      for(uint32_t threads = 1; ; threads *= 2) {
+
+        if(threads > cpus) threads = cpus;
+
+        OmArchive zip;
+        OM_TEST_CHECK(zip.write(zip_path, methods[m], levels[l]));
+
+        double time = Om_testClock();
+        OM_TEST_CHECK(zip.entryAddMany(srcs, dsts, threads));
+        OM_TEST_CHECK(zip.close());
+        time = Om_testClock() - time;
+
+        std::printf("  %-7ls level %u, %2u threads: %7.3fs, %8.1f MiB/s, ratio %5.3f\n",
+                    method_names[m], static_cast<unsigned>(levels[l]), threads, time,
+                    (total / BENCH_MiB) / time, Om_itemSize(zip_path) / total);
+
+        Om_fileDelete(zip_path);
+
+        if(threads == cpus)
+          break;
+      }
+    }
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_archiveAddMany()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_add_many(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_adaptive(const OmWString& dir)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"adapt.zip");
+
+  // half of files hold pseudo-random data, as already compressed payloads
+  OmWStringArray srcs, dsts;
+  OM_TEST_CHECK(__bench_batch_files(dir, BENCH_BATCH_FILES, true, &srcs, &dsts));
+
+  const int32_t methods[] = {OM_METHOD_DEFLATE, OM_METHOD_ZSTD};
+  const wchar_t* method_names[] = {L"Deflate", L"Zstd"};
+
+  double total = BENCH_BATCH_FILES * BENCH_BATCH_SIZE;
+
+  for(size_t m = 0; m < 2; ++m) {
+    for(int adaptive = 0; adaptive < 2; ++adaptive) {
+
+      OmArchive zip;
+      OM_TEST_CHECK(zip.write(zip_path, methods[m], OM_LEVEL_SLOW, adaptive != 0));
+
+      double time = Om_testClock();
+      OM_TEST_CHECK(zip.entryAddMany(srcs, dsts));
+      OM_TEST_CHECK(zip.close());
+      time = Om_testClock() - time;
+
+      uint64_t count, size;
+      zip.adaptStats(&count, &size);
+
+      std::printf("  %-7ls adaptive %-3s: %7.3fs, ratio %5.3f, %u entries (%.1f MiB) stored\n",
+                  method_names[m], adaptive ? "on" : "off", time, Om_itemSize(zip_path) / total,
+                  static_cast<unsigned>(count), size / BENCH_MiB);
+
+      Om_fileDelete(zip_path);
+    }
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_archiveAdaptive()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_adaptive(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
@@ -0,0 +1,484 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+
+#include "OmBaseApp.h"
+
+#include "OmUtilFs.h"
+#include "OmUtilStr.h"
+
+#include "OmArchive.h"
+#include "OmXmlConf.h"
+
+#include "OmModMan.h"
+#include "OmModHub.h"
+#include "OmModChan.h"
+#include "OmModPack.h"
+#include "OmModPset.h"
+
+#include "OmTest.h"
+
+#define BENCH_LIBRARY_PACKS     5000
+#define BENCH_LIBRARY_FILES     16
+
+#define BENCH_INSTALL_FILES     10000
+#define BENCH_INSTALL_SIZE      1024
+
+#define BENCH_HARDLINK_FILES    2000
+#define BENCH_HARDLINK_SIZE     0x10000       //< 64 KiB
+
+#define BENCH_MODOPS_PACKS      200
+#define BENCH_MODOPS_FILES      32
+
+#define BENCH_OVERLAP_PACKS     100
+#define BENCH_OVERLAP_FILES     1000
+#define BENCH_OVERLAP_LOOKUPS   10000
+
+#define BENCH_MiB               1048576.0
+
+/// \brief Make benchmark identity
+///
+/// Composes Mod Pack identity or file name from prefix and index.
+///
+/// \param[in]  prefix  : Identity prefix.
+/// \param[in]  index   : Index to append.
+///
+/// \return Composed identity.
+///
+static OmWString __bench_iden(const wchar_t* prefix, size_t index)
+{
+  wchar_t num_buf[16];
+  swprintf(num_buf, 16, L"%05u", static_cast<unsigned>(index));
+
+  OmWString iden(prefix);
+  iden.append(num_buf);
+
+  return iden;
+}
+
+/// \brief Create benchmark Mod Pack
+///
+/// Creates a Mod Pack file in the given library directory with the given
+/// count of small data files, placed in a subdirectory named after pack
+/// unless shared directory is specified.
+///
+/// \param[in]  library : Library directory path.
+/// \param[in]  iden    : Mod Pack identity, used as file name.
+/// \param[in]  count   : Count of data files.
+/// \param[in]  size    : Size of each data file.
+/// \param[in]  shared  : Directory where files are placed, if not empty.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __bench_make_pack(const OmWString& library, const OmWString& iden, size_t count, size_t size, const OmWString& shared = OmWString())
+{
+  OmXmlConf pack_cfg(OM_XMAGIC_PKG);
+  pack_cfg.addChild(L"install").setContent(iden);
+
+  OmCString cfg_data = pack_cfg.data();
+  OmCString txt_data(size, static_cast<char>('a' + (iden.size() % 26)));
+
+  OmWString path = Om_concatPaths(library, iden);
+  path.append(L"." OM_PKG_FILE_EXT);
+
+  OmWString root = shared.empty() ? iden : shared;
+
+  OmArchive pack_zip;
+
+  if(!pack_zip.write(path, OM_METHOD_STORE, OM_LEVEL_NONE))
+    return false;
+
+  bool result = true;
+
+  for(size_t i = 0; i < count && result; ++i) {
+    OmWString entry = Om_concatPaths(iden, Om_concatPaths(root, __bench_iden(L"File_", i) + L".dat"));
+    result = pack_zip.entryAdd(txt_data.c_str(), txt_data.size(), entry);
+  }
+
+  if(result)
+    result = pack_zip.entryAdd(cfg_data.c_str(), cfg_data.size(), L"modpack.xml");
+
+  return pack_zip.close() && result;
+}
+
+/// \brief Create benchmark Channel
+///
+/// Creates Hub in benchmark directory then Channel with the given Target
+/// and Library directories, whose Mod Packs are parsed once.
+///
+/// \param[in]  dir     : Benchmark directory.
+/// \param[in]  ModMan  : Mod Manager to create Hub in.
+/// \param[in]  target  : Target directory path.
+/// \param[in]  library : Library directory path.
+///
+/// \return Created Mod Channel or nullptr if failed.
+///
+static OmModChan* __bench_make_chan(const OmWString& dir, OmModMan* ModMan, const OmWString& target, const OmWString& library)
+{
+  if(ModMan->createHub(dir, L"Hub") != OM_RESULT_OK || !ModMan->activeHub())
+    return nullptr;
+
+  if(!ModMan->activeHub()->createChannel(L"Chan", target, library, L""))
+    return nullptr;
+
+  return ModMan->activeHub()->activeChannel();
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_library(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  for(size_t i = 0; i < BENCH_LIBRARY_PACKS; ++i)
+    OM_TEST_CHECK(__bench_make_pack(library, __bench_iden(L"Lib_", i), BENCH_LIBRARY_FILES, 16));
+
+  OmModMan ModMan;
+
+  // first load parses every Mod Pack and writes library cache
+  double time = Om_testClock();
+  OmModChan* ModChan = __bench_make_chan(dir, &ModMan, target, library);
+  time = Om_testClock() - time;
+
+  OM_TEST_CHECK(ModChan != nullptr);
+  OM_TEST_CHECK(ModChan->modpackCount() == BENCH_LIBRARY_PACKS);
+
+  std::printf("  create channel      : %7.3fs\n", time);
+
+  // cold reload without cache, then warm reload with cache
+  Om_fileDelete(Om_concatPaths(ModChan->home(), OM_MODCHN_LIBCACHE_FILE));
+
+  time = Om_testClock();
+  ModChan->reloadModLibrary();
+  std::printf("  reload (cold cache) : %7.3fs\n", Om_testClock() - time);
+
+  time = Om_testClock();
+  ModChan->reloadModLibrary();
+  std::printf("  reload (warm cache) : %7.3fs\n", Om_testClock() - time);
+
+  OM_TEST_CHECK(ModChan->modpackCount() == BENCH_LIBRARY_PACKS);
+
+  // preset with every Mod Pack of library
+  OmModPset* ModPset = ModMan.activeHub()->createPreset(L"All");
+  OM_TEST_CHECK(ModPset != nullptr);
+
+  time = Om_testClock();
+  for(size_t i = 0; i < ModChan->modpackCount(); ++i)
+    ModPset->addSetupEntry(ModChan, ModChan->getModpack(i));
+  std::printf("  preset setup        : %7.3fs\n", Om_testClock() - time);
+
+  OmPModPackArray selection, installs;
+  OmWStringArray overlaps, depends, missings;
+
+  time = Om_testClock();
+  OM_TEST_CHECK(ModPset->getSetupEntryList(ModChan, &selection) == BENCH_LIBRARY_PACKS);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+  std::printf("  preset resolve      : %7.3fs\n", Om_testClock() - time);
+
+  OM_TEST_CHECK(installs.size() == BENCH_LIBRARY_PACKS);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_modchanLibrary()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_library(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_install(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  OM_TEST_CHECK(__bench_make_pack(library, L"Many", BENCH_INSTALL_FILES, BENCH_INSTALL_SIZE));
+
+  OmModMan ModMan;
+
+  OmModChan* ModChan = __bench_make_chan(dir, &ModMan, target, library);
+  OM_TEST_CHECK(ModChan != nullptr);
+
+  OmModPack* ModPack = ModChan->findModpack(L"Many", true);
+  OM_TEST_CHECK(ModPack != nullptr);
+
+  double time = Om_testClock();
+  OM_TEST_CHECK(ModPack->makeBackup() == OM_RESULT_OK);
+  OM_TEST_CHECK(ModPack->applySource() == OM_RESULT_OK);
+  time = Om_testClock() - time;
+
+  std::printf("  install : %7.3fs, %8.0f files/s\n", time, BENCH_INSTALL_FILES / time);
+
+  time = Om_testClock();
+  OM_TEST_CHECK(ModPack->restoreData() == OM_RESULT_OK);
+  time = Om_testClock() - time;
+
+  std::printf("  restore : %7.3fs, %8.0f files/s\n", time, BENCH_INSTALL_FILES / time);
+
+  OM_TEST_CHECK(!ModPack->hasBackup());
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_modchanInstall()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_install(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_hardlink(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  // directory Mod Pack
+  OmWString pack_dir = Om_concatPaths(library, L"Linked");
+  OmWString data_dir = Om_concatPaths(pack_dir, L"Linked");
+  OM_TEST_CHECK(Om_dirCreateRecursive(data_dir) == 0);
+
+  for(size_t i = 0; i < BENCH_HARDLINK_FILES; ++i)
+    OM_TEST_CHECK(Om_testDataFile(Om_concatPaths(data_dir, __bench_iden(L"File_", i) + L".dat"), BENCH_HARDLINK_SIZE, i));
+
+  OmModMan ModMan;
+
+  OmModChan* ModChan = __bench_make_chan(dir, &ModMan, target, library);
+  OM_TEST_CHECK(ModChan != nullptr);
+
+  OmModPack* ModPack = ModChan->findModpack(L"Linked", true);
+  OM_TEST_CHECK(ModPack != nullptr);
+
+  for(int hardlink = 0; hardlink < 2; ++hardlink) {
+
+    ModChan->setLibraryHardlink(hardlink != 0);
+
+    ULARGE_INTEGER free_bef, free_aft;
+    OM_TEST_CHECK(GetDiskFreeSpaceExW(target.c_str(), &free_bef, nullptr, nullptr));
+
+    double time = Om_testClock();
+    OM_TEST_CHECK(ModPack->makeBackup() == OM_RESULT_OK);
+    OM_TEST_CHECK(ModPack->applySource() == OM_RESULT_OK);
+    time = Om_testClock() - time;
+
+    OM_TEST_CHECK(GetDiskFreeSpaceExW(target.c_str(), &free_aft, nullptr, nullptr));
+
+    // free space may grow from unrelated activity
+    double used = (free_bef.QuadPart > free_aft.QuadPart) ? (free_bef.QuadPart - free_aft.QuadPart) : 0.0;
+
+    std::printf("  hard links %-3s: %7.3fs, %8.1f MiB of disk used\n",
+                hardlink ? "on" : "off", time, used / BENCH_MiB);
+
+    OM_TEST_CHECK(ModPack->restoreData() == OM_RESULT_OK);
+  }
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_modchanHardlink()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_hardlink(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_modops(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  // non-overlapping Mod Packs, each in its own directory
+  for(size_t i = 0; i < BENCH_MODOPS_PACKS; ++i)
+    OM_TEST_CHECK(__bench_make_pack(library, __bench_iden(L"Ops_", i), BENCH_MODOPS_FILES, 4096));
+
+  OmModMan ModMan;
+
+  OmModChan* ModChan = __bench_make_chan(dir, &ModMan, target, library);
+  OM_TEST_CHECK(ModChan != nullptr);
+  OM_TEST_CHECK(ModChan->modpackCount() == BENCH_MODOPS_PACKS);
+
+  OmPModPackArray selection;
+  for(size_t i = 0; i < ModChan->modpackCount(); ++i)
+    selection.push_back(ModChan->getModpack(i));
+
+  // sequential baseline, one Mod Pack after another
+  double time = Om_testClock();
+  for(size_t i = 0; i < selection.size(); ++i) {
+    OM_TEST_CHECK(selection[i]->makeBackup() == OM_RESULT_OK);
+    OM_TEST_CHECK(selection[i]->applySource() == OM_RESULT_OK);
+  }
+  std::printf("  sequential install : %7.3fs\n", Om_testClock() - time);
+
+  time = Om_testClock();
+  for(size_t i = 0; i < selection.size(); ++i)
+    OM_TEST_CHECK(selection[i]->restoreData() == OM_RESULT_OK);
+  std::printf("  sequential restore : %7.3fs\n", Om_testClock() - time);
+
+  // Mod-Operations, independent Mod Packs processed by waves
+  time = Om_testClock();
+  OM_TEST_CHECK(ModChan->execModOps(selection) == OM_RESULT_OK);
+  std::printf("  modops install     : %7.3fs\n", Om_testClock() - time);
+
+  for(size_t i = 0; i < selection.size(); ++i)
+    OM_TEST_CHECK(selection[i]->hasBackup());
+
+  time = Om_testClock();
+  OM_TEST_CHECK(ModChan->execModOps(selection) == OM_RESULT_OK);
+  std::printf("  modops restore     : %7.3fs\n", Om_testClock() - time);
+
+  for(size_t i = 0; i < selection.size(); ++i)
+    OM_TEST_CHECK(!selection[i]->hasBackup());
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_modchanModOps()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_modops(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __bench_overlaps(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  // every Mod Pack writes the same files, plus one probe Mod Pack
+  for(size_t i = 0; i < BENCH_OVERLAP_PACKS; ++i)
+    OM_TEST_CHECK(__bench_make_pack(library, __bench_iden(L"Ovl_", i), BENCH_OVERLAP_FILES, 16, L"Shared"));
+
+  OM_TEST_CHECK(__bench_make_pack(library, L"Probe", BENCH_OVERLAP_FILES, 16, L"Shared"));
+
+  OmModMan ModMan;
+
+  OmModChan* ModChan = __bench_make_chan(dir, &ModMan, target, library);
+  OM_TEST_CHECK(ModChan != nullptr);
+
+  OmModPack* Probe = ModChan->findModpack(L"Probe", true);
+  OM_TEST_CHECK(Probe != nullptr);
+
+  // overlapped Mod Packs must be installed
+  double time = Om_testClock();
+  for(size_t i = 0; i < BENCH_OVERLAP_PACKS; ++i) {
+    OmModPack* ModPack = ModChan->findModpack(__bench_iden(L"Ovl_", i), true);
+    OM_TEST_CHECK(ModPack != nullptr);
+    OM_TEST_CHECK(ModPack->makeBackup() == OM_RESULT_OK);
+    OM_TEST_CHECK(ModPack->applySource() == OM_RESULT_OK);
+  }
+  std::printf("  install %u packs  : %7.3fs\n", BENCH_OVERLAP_PACKS, Om_testClock() - time);
+
+  OmUint64Array overlaps;
+
+  time = Om_testClock();
+  ModChan->findOverlaps(Probe, &overlaps);
+  std::printf("  find overlaps    : %10.3f ms\n", (Om_testClock() - time) * 1000.0);
+
+  OM_TEST_CHECK(overlaps.size() == BENCH_OVERLAP_PACKS);
+
+  // backup entries lookups, half of them missing
+  OmWStringArray paths;
+  for(size_t i = 0; i < BENCH_OVERLAP_LOOKUPS; ++i) {
+    const wchar_t* root = (i & 1) ? L"Missing" : L"Shared";
+    paths.push_back(Om_concatPaths(root, __bench_iden(L"File_", i % BENCH_OVERLAP_FILES) + L".dat"));
+  }
+
+  time = Om_testClock();
+  size_t found = 0;
+  for(size_t i = 0; i < paths.size(); ++i)
+    if(ModChan->backupEntryExists(paths[i], 0)) found++;
+  std::printf("  backup lookup    : %10.3f us\n", (Om_testClock() - time) * 1000000.0 / paths.size());
+
+  OM_TEST_CHECK(found == BENCH_OVERLAP_LOOKUPS / 2);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmBench_modchanOverlaps()
+{
+  OmWString dir = Om_testDir(L"bench");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __bench_overlaps(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
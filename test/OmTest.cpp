@@ -0,0 +1,193 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+
+#include "OmBaseWin.h"        //< WinAPI
+#include <psapi.h>            //< GetProcessMemoryInfo
+
+#include "OmUtilFs.h"
+#include "OmUtilHsh.h"
+
+#include "OmTest.h"
+
+/// \brief Test function
+///
+/// Test function with its name.
+///
+typedef struct test_func_ {
+  const char*   name;
+  bool          (*func)();
+} test_func_t;
+
+static const test_func_t __test_list[] = {
+  {"archive.copyRawZip64", OmTest_archiveCopyRawZip64},
+  {"archive.addManyNone",  OmTest_archiveAddManyNone},
+  {"archive.copyTranscode", OmTest_archiveCopyTranscode},
+  {"archive.adaptive",     OmTest_archiveAdaptive},
+  {"modchan.depGraph",     OmTest_modchanDepGraph}
+};
+
+/// \brief Benchmark list
+///
+/// Benchmarks are long running and only report measures, they are run
+/// separately from tests with the --bench option.
+///
+static const test_func_t __bench_list[] = {
+  {"archive.directory",    OmBench_archiveDirectory},
+  {"archive.mapped",       OmBench_archiveMapped},
+  {"archive.saveMany",     OmBench_archiveSaveMany},
+  {"archive.addMany",      OmBench_archiveAddMany},
+  {"archive.adaptive",     OmBench_archiveAdaptive},
+  {"modchan.library",      OmBench_modchanLibrary},
+  {"modchan.install",      OmBench_modchanInstall},
+  {"modchan.hardlink",     OmBench_modchanHardlink},
+  {"modchan.modops",       OmBench_modchanModOps},
+  {"modchan.overlaps",     OmBench_modchanOverlaps}
+};
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+void Om_testFail(const char* cond, const char* file, int line)
+{
+  std::printf("  check failed: %s (%s:%d)\n", cond, file, line);
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+OmWString Om_testDir(const wchar_t* name)
+{
+  wchar_t tmp_buf[OM_MAX_PATH];
+  GetTempPathW(OM_MAX_PATH, tmp_buf);
+
+  OmWString path = tmp_buf;
+  path.append(L"OmTest_");
+  path.append(name);
+  path.append(L"_");
+
+  OmWString uid;
+  Om_uint64ToStr(&uid, GetTickCount64());
+  path.append(uid);
+
+  if(Om_dirCreateRecursive(path) != 0)
+    return OmWString();
+
+  return path;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool Om_testDataFile(const OmWString& path, size_t size, uint32_t seed, bool noise)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  OmCString data;
+  data.reserve(size);
+
+  if(noise) {
+
+    uint32_t x = seed | 1;
+
+    while(data.size() < size) {
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      data.push_back(static_cast<char>(x));
+    }
+
+  } else {
+
+    while(data.size() < size) {
+      data.append("line ");
+      data.append(std::to_string(seed++ % 97));
+      data.append(" of test text\r\n");
+    }
+
+    data.resize(size);
+  }
+
+  DWORD wb;
+  bool result = WriteFile(hFile, data.data(), size, &wb, nullptr) && wb == size;
+
+  CloseHandle(hFile);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+uint64_t Om_testPrivateBytes()
+{
+  PROCESS_MEMORY_COUNTERS_EX pmc;
+  memset(&pmc, 0, sizeof(pmc));
+  pmc.cb = sizeof(pmc);
+
+  if(!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+    return 0;
+
+  return pmc.PrivateUsage;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+double Om_testClock()
+{
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+
+  return static_cast<double>(count.QuadPart) / freq.QuadPart;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+int main(int argc, char** argv)
+{
+  const test_func_t* list = __test_list;
+  size_t count = sizeof(__test_list) / sizeof(test_func_t);
+  size_t failed = 0;
+
+  // benchmarks are run instead of tests on demand
+  if(argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    list = __bench_list;
+    count = sizeof(__bench_list) / sizeof(test_func_t);
+    argc--; argv++;
+  }
+
+  for(size_t i = 0; i < count; ++i) {
+
+    // run only tests whose name starts with given argument
+    if(argc > 1 && strncmp(list[i].name, argv[1], strlen(argv[1])) != 0)
+      continue;
+
+    std::printf("%s\n", list[i].name);
+
+    if(list[i].func()) {
+      std::printf("  passed\n");
+    } else {
+      std::printf("  FAILED\n");
+      failed++;
+    }
+  }
+
+  return failed ? 1 : 0;
+}
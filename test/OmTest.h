@@ -0,0 +1,217 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OMTEST_H
+#define OMTEST_H
+
+#include "OmBase.h"
+
+/// \brief Test check
+///
+/// Checks the given condition, on failure the condition and location are
+/// reported and the calling test function returns false.
+///
+#define OM_TEST_CHECK(cond) \
+  do { if(!(cond)) { Om_testFail(#cond, __FILE__, __LINE__); return false; } } while(0)
+
+/// \brief Report test failure
+///
+/// Prints the given failed condition with its location.
+///
+/// \param[in]  cond    : Failed condition string.
+/// \param[in]  file    : Source file of the check.
+/// \param[in]  line    : Source line of the check.
+///
+void Om_testFail(const char* cond, const char* file, int line);
+
+/// \brief Create test directory
+///
+/// Creates a new empty directory in system temporary location for the
+/// specified test.
+///
+/// \param[in]  name    : Test name used to compose directory name.
+///
+/// \return Path to the created directory or empty string if failed.
+///
+OmWString Om_testDir(const wchar_t* name);
+
+/// \brief Create data file
+///
+/// Creates a file of the given size filled either with compressible text
+/// or with pseudo-random bytes, whose content depends on the given seed.
+///
+/// \param[in]  path    : File path.
+/// \param[in]  size    : File size.
+/// \param[in]  seed    : Content seed.
+/// \param[in]  noise   : Fill with pseudo-random bytes instead of text.
+///
+/// \return True if operation succeed, false otherwise.
+///
+bool Om_testDataFile(const OmWString& path, size_t size, uint32_t seed, bool noise = false);
+
+/// \brief Process private memory
+///
+/// Returns the current count of private bytes committed by the process.
+///
+/// \return Private bytes count, or 0 if failed.
+///
+uint64_t Om_testPrivateBytes();
+
+/// \brief Benchmark clock
+///
+/// Returns current value of high resolution performance counter.
+///
+/// \return Counter value in seconds.
+///
+double Om_testClock();
+
+/// \brief Archive tests
+///
+/// Round-trips an entry larger than 4 GiB, thus with ZIP64 fields, through
+/// raw entry copy and checks its data and CRC.
+///
+/// \return True if test succeed, false otherwise.
+///
+bool OmTest_archiveCopyRawZip64();
+
+/// \brief Archive tests
+///
+/// Adds files through the threaded batch with Deflate and Zstd writers at
+/// level none, then checks entries are stored and their data and CRC.
+///
+/// \return True if test succeed, false otherwise.
+///
+bool OmTest_archiveAddManyNone();
+
+/// \brief Archive tests
+///
+/// Copies a 1 GiB entry to another archive with a different method and
+/// checks its data while process memory stays bounded during the copy.
+///
+/// \return True if test succeed, false otherwise.
+///
+bool OmTest_archiveCopyTranscode();
+
+/// \brief Archive tests
+///
+/// Writes incompressible and compressible entries with adaptive policy and
+/// checks stored entries and reported statistics.
+///
+/// \return True if test succeed, false otherwise.
+///
+bool OmTest_archiveAdaptive();
+
+/// \brief Mod Channel tests
+///
+/// Builds a library with a deep dependency chain, a dependency cycle, a
+/// self dependency, a transitive missing dependency, a diamond, a wide
+/// fan-out and a wide fan-in, then checks install and restore lists and
+/// dependency queries.
+///
+/// \return True if test succeed, false otherwise.
+///
+bool OmTest_modchanDepGraph();
+
+/// \brief Archive benchmarks
+///
+/// Measures entry lookup through hash index against a linear scan and the
+/// memory of central directory mirror, for 1k, 10k and 100k entries.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_archiveDirectory();
+
+/// \brief Archive benchmarks
+///
+/// Measures extraction throughput of a 1 GiB stored entry with streamed
+/// and memory mapped reads.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_archiveMapped();
+
+/// \brief Archive benchmarks
+///
+/// Measures batch extraction time with 1 thread up to one thread per
+/// logical processor.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_archiveSaveMany();
+
+/// \brief Archive benchmarks
+///
+/// Measures batch compression time, throughput and ratio for each method
+/// and level, with 1 thread up to one thread per logical processor.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_archiveAddMany();
+
+/// \brief Archive benchmarks
+///
+/// Measures compression time and ratio of a mix of incompressible and
+/// compressible files with adaptive policy disabled then enabled.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_archiveAdaptive();
+
+/// \brief Mod Channel benchmarks
+///
+/// Measures library load of 5000 Mod Packs with cold and warm cache, then
+/// setup and resolution of a preset including all of them.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_modchanLibrary();
+
+/// \brief Mod Channel benchmarks
+///
+/// Measures install and restore rate of a Mod Pack with 10k small files.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_modchanInstall();
+
+/// \brief Mod Channel benchmarks
+///
+/// Measures install time and disk usage of a directory Mod Pack with hard
+/// link install disabled then enabled.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_modchanHardlink();
+
+/// \brief Mod Channel benchmarks
+///
+/// Measures install and restore of 200 non-overlapping Mod Packs through
+/// Mod-Operations against a sequential baseline.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_modchanModOps();
+
+/// \brief Mod Channel benchmarks
+///
+/// Measures overlap search and backup entry lookups with 100 installed
+/// Mod Packs sharing the same 1000 files.
+///
+/// \return True if benchmark succeed, false otherwise.
+///
+bool OmBench_modchanOverlaps();
+
+#endif // OMTEST_H
@@ -0,0 +1,403 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "OmBaseWin.h"        //< WinAPI
+#include <winioctl.h>         //< FSCTL_SET_SPARSE
+
+#include "OmUtilStr.h"
+#include "OmUtilFs.h"
+#include "OmUtilHsh.h"
+
+#include "OmArchive.h"
+
+#include "OmTest.h"
+
+#define ZIP64_ENTRY_SIZE  0x100001000ULL  //< 4 GiB + 4 KiB
+#define ZIP64_MARK_HEAD   0xA5
+#define ZIP64_MARK_TAIL   0x5A
+
+#define TRANSCODE_SIZE    0x40000000ULL   //< 1 GiB
+#define TRANSCODE_MEMORY  0x4000000ULL    //< 64 MiB
+
+#define ADAPT_SIZE        0x10000         //< 64 KiB
+
+#define ADDMANY_FILES     8
+#define ADDMANY_SIZE      0x40000         //< 256 KiB
+
+/// \brief Write byte at offset
+///
+/// Writes a single byte at the specified offset of the given file.
+///
+/// \param[in]  hFile   : File handle.
+/// \param[in]  offset  : Offset to write at.
+/// \param[in]  byte    : Byte value to write.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __test_write_byte(HANDLE hFile, uint64_t offset, uint8_t byte)
+{
+  LARGE_INTEGER pos; pos.QuadPart = offset;
+  if(!SetFilePointerEx(hFile, pos, nullptr, FILE_BEGIN))
+    return false;
+
+  DWORD wb;
+  return WriteFile(hFile, &byte, 1, &wb, nullptr) && wb == 1;
+}
+
+/// \brief Read byte at offset
+///
+/// Reads a single byte at the specified offset of the given file.
+///
+/// \param[in]  path    : File path.
+/// \param[in]  offset  : Offset to read at.
+///
+/// \return Read byte value, or -1 if failed.
+///
+static int32_t __test_read_byte(const OmWString& path, uint64_t offset)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(hFile == INVALID_HANDLE_VALUE)
+    return -1;
+
+  int32_t result = -1;
+
+  LARGE_INTEGER pos; pos.QuadPart = offset;
+  if(SetFilePointerEx(hFile, pos, nullptr, FILE_BEGIN)) {
+    uint8_t byte; DWORD rb;
+    if(ReadFile(hFile, &byte, 1, &rb, nullptr) && rb == 1)
+      result = byte;
+  }
+
+  CloseHandle(hFile);
+
+  return result;
+}
+
+/// \brief Create large file
+///
+/// Creates a sparse file of the given size, zero filled except its first
+/// and last bytes which are set to known values.
+///
+/// \param[in]  path    : File path.
+/// \param[in]  size    : File size.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __test_create_large(const OmWString& path, uint64_t size)
+{
+  HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ|GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(hFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  // sparse file so zero ranges are not allocated on disk, this may fail
+  // on file systems without sparse support, file is then simply larger
+  DWORD rb;
+  DeviceIoControl(hFile, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &rb, nullptr);
+
+  bool result = __test_write_byte(hFile, 0, ZIP64_MARK_HEAD) &&
+                __test_write_byte(hFile, size - 1, ZIP64_MARK_TAIL);
+
+  CloseHandle(hFile);
+
+  return result;
+}
+
+/// \brief Memory sampling progress callback
+///
+/// Records the peak of process private bytes while an operation runs.
+///
+static bool __test_memory_cb(void* ptr, size_t tot, size_t cur, uint64_t param)
+{
+  OM_UNUSED(tot); OM_UNUSED(cur); OM_UNUSED(param);
+
+  uint64_t* peak = static_cast<uint64_t*>(ptr);
+
+  uint64_t bytes = Om_testPrivateBytes();
+  if(bytes > *peak) *peak = bytes;
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_copy_transcode(const OmWString& dir)
+{
+  OmWString big_path = Om_concatPaths(dir, L"big.bin");
+  OmWString src_path = Om_concatPaths(dir, L"src.zip");
+  OmWString dst_path = Om_concatPaths(dir, L"dst.zip");
+  OmWString out_path = Om_concatPaths(dir, L"out.bin");
+
+  OM_TEST_CHECK(__test_create_large(big_path, TRANSCODE_SIZE));
+
+  uint32_t big_crc = 0;
+  OM_TEST_CHECK(Om_getCRC32digest(&big_crc, big_path));
+
+  OmArchive src_zip;
+  OM_TEST_CHECK(src_zip.write(src_path, OM_METHOD_DEFLATE, OM_LEVEL_FAST));
+  OM_TEST_CHECK(src_zip.entryAdd(big_path, L"data\\big.bin"));
+  OM_TEST_CHECK(src_zip.close());
+
+  Om_fileDelete(big_path);
+
+  // copy entry to destination archive with a different method, data is
+  // decompressed then compressed again and must be streamed in bounded
+  // buffers, whatever the entry size
+  OM_TEST_CHECK(src_zip.read(src_path));
+
+  OmArchive dst_zip;
+  OM_TEST_CHECK(dst_zip.write(dst_path, OM_METHOD_ZSTD, OM_LEVEL_FAST));
+
+  uint64_t base = Om_testPrivateBytes();
+  uint64_t peak = base;
+  OM_TEST_CHECK(base != 0);
+
+  OM_TEST_CHECK(dst_zip.entryCopy(src_zip, 0, L"copy\\big.bin", __test_memory_cb, &peak));
+  OM_TEST_CHECK(dst_zip.close());
+  OM_TEST_CHECK(src_zip.close());
+
+  OM_TEST_CHECK(peak - base < TRANSCODE_MEMORY);
+
+  OM_TEST_CHECK(dst_zip.read(dst_path));
+  OM_TEST_CHECK(dst_zip.entryCount() == 1);
+  OM_TEST_CHECK(dst_zip.entrySize(0) == TRANSCODE_SIZE);
+  OM_TEST_CHECK(dst_zip.entryCrc(0) == big_crc);
+  OM_TEST_CHECK(dst_zip.entryMethod(0) == OM_METHOD_ZSTD);
+
+  // extraction verifies CRC of decompressed data
+  OM_TEST_CHECK(dst_zip.entrySave(0, out_path));
+  OM_TEST_CHECK(dst_zip.close());
+
+  OM_TEST_CHECK(__test_read_byte(out_path, 0) == ZIP64_MARK_HEAD);
+  OM_TEST_CHECK(__test_read_byte(out_path, TRANSCODE_SIZE - 1) == ZIP64_MARK_TAIL);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_adaptive(const OmWString& dir)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"adapt.zip");
+
+  // pseudo-random data cannot be compressed, text can
+  std::vector<uint8_t> noise(ADAPT_SIZE);
+  uint32_t x = 0x9E3779B9;
+  for(size_t i = 0; i < noise.size(); ++i) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    noise[i] = static_cast<uint8_t>(x);
+  }
+
+  OmCString text;
+  while(text.size() < ADAPT_SIZE)
+    text.append("some compressible text line\r\n");
+
+  OmArchive zip;
+  OM_TEST_CHECK(zip.write(zip_path, OM_METHOD_DEFLATE, OM_LEVEL_FAST, true));
+  OM_TEST_CHECK(zip.entryAdd(noise.data(), noise.size(), L"noise.bin"));
+  OM_TEST_CHECK(zip.entryAdd(text.data(), text.size(), L"text.txt"));
+  OM_TEST_CHECK(zip.close());
+
+  uint64_t count = 0, size = 0;
+  zip.adaptStats(&count, &size);
+  OM_TEST_CHECK(count == 1);
+  OM_TEST_CHECK(size == ADAPT_SIZE);
+
+  OM_TEST_CHECK(zip.read(zip_path));
+  OM_TEST_CHECK(zip.entryMethod(zip.entryLocate(L"noise.bin")) == OM_METHOD_STORE);
+  OM_TEST_CHECK(zip.entryMethod(zip.entryLocate(L"text.txt")) == OM_METHOD_DEFLATE);
+  OM_TEST_CHECK(zip.close());
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_add_many_none(const OmWString& dir, int32_t method)
+{
+  OmWString zip_path = Om_concatPaths(dir, L"none.zip");
+  OmWString out_path = Om_concatPaths(dir, L"out.txt");
+
+  OmWStringArray srcs, dsts;
+  std::vector<uint32_t> crcs;
+
+  for(uint32_t i = 0; i < ADDMANY_FILES; ++i) {
+
+    OmWString name(L"file"); name.append(std::to_wstring(i)); name.append(L".txt");
+
+    srcs.push_back(Om_concatPaths(dir, name));
+    dsts.push_back(Om_concatPaths(L"data", name));
+
+    OM_TEST_CHECK(Om_testDataFile(srcs.back(), ADDMANY_SIZE, i));
+
+    uint32_t crc = 0;
+    OM_TEST_CHECK(Om_getCRC32digest(&crc, srcs.back()));
+    crcs.push_back(crc);
+  }
+
+  // level none must produce stored entries whatever the writer method
+  OmArchive zip;
+  OM_TEST_CHECK(zip.write(zip_path, method, OM_LEVEL_NONE));
+  OM_TEST_CHECK(zip.entryAddMany(srcs, dsts, 4));
+  OM_TEST_CHECK(zip.close());
+
+  OM_TEST_CHECK(zip.read(zip_path));
+  OM_TEST_CHECK(zip.entryCount() == ADDMANY_FILES);
+
+  for(uint32_t i = 0; i < ADDMANY_FILES; ++i) {
+
+    uint32_t e = zip.entryLocate(dsts[i]);
+    OM_TEST_CHECK(e != static_cast<uint32_t>(-1));
+    OM_TEST_CHECK(zip.entryMethod(e) == OM_METHOD_STORE);
+    OM_TEST_CHECK(zip.entrySize(e) == ADDMANY_SIZE);
+    OM_TEST_CHECK(zip.entryCrc(e) == crcs[i]);
+
+    // extraction verifies CRC of read data
+    OM_TEST_CHECK(zip.entrySave(e, out_path));
+
+    uint32_t out_crc = 0;
+    OM_TEST_CHECK(Om_getCRC32digest(&out_crc, out_path));
+    OM_TEST_CHECK(out_crc == crcs[i]);
+  }
+
+  OM_TEST_CHECK(zip.close());
+
+  Om_fileDelete(zip_path);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_copy_raw_zip64(const OmWString& dir)
+{
+  OmWString big_path = Om_concatPaths(dir, L"big.bin");
+  OmWString src_path = Om_concatPaths(dir, L"src.zip");
+  OmWString dst_path = Om_concatPaths(dir, L"dst.zip");
+  OmWString out_path = Om_concatPaths(dir, L"out.bin");
+
+  OM_TEST_CHECK(__test_create_large(big_path, ZIP64_ENTRY_SIZE));
+  OM_TEST_CHECK(Om_itemSize(big_path) == ZIP64_ENTRY_SIZE);
+
+  uint32_t big_crc = 0;
+  OM_TEST_CHECK(Om_getCRC32digest(&big_crc, big_path));
+
+  // create source archive with large entry
+  OmArchive src_zip;
+  OM_TEST_CHECK(src_zip.write(src_path, OM_METHOD_DEFLATE, OM_LEVEL_FAST));
+  OM_TEST_CHECK(src_zip.entryAdd(big_path, L"data\\big.bin"));
+  OM_TEST_CHECK(src_zip.close());
+
+  OM_TEST_CHECK(src_zip.read(src_path));
+  OM_TEST_CHECK(src_zip.entryCount() == 1);
+  OM_TEST_CHECK(src_zip.entrySize(0) == ZIP64_ENTRY_SIZE);
+  OM_TEST_CHECK(src_zip.entryCrc(0) == big_crc);
+
+  // copy entry as-is to destination archive, with a different writer
+  // method to ensure data is not recompressed
+  OmArchive dst_zip;
+  OM_TEST_CHECK(dst_zip.write(dst_path, OM_METHOD_STORE, OM_LEVEL_NONE));
+  OM_TEST_CHECK(dst_zip.entryCopyRaw(src_zip, 0, L"copy\\big.bin"));
+  OM_TEST_CHECK(dst_zip.close());
+  OM_TEST_CHECK(src_zip.close());
+
+  OM_TEST_CHECK(dst_zip.read(dst_path));
+  OM_TEST_CHECK(dst_zip.entryCount() == 1);
+  OM_TEST_CHECK(dst_zip.entryLocate(L"copy\\big.bin") == 0);
+  OM_TEST_CHECK(dst_zip.entrySize(0) == ZIP64_ENTRY_SIZE);
+  OM_TEST_CHECK(dst_zip.entryCrc(0) == big_crc);
+  OM_TEST_CHECK(dst_zip.entryMethod(0) == OM_METHOD_DEFLATE);
+
+  // extraction verifies CRC of decompressed data
+  OM_TEST_CHECK(dst_zip.entrySave(0, out_path));
+  OM_TEST_CHECK(dst_zip.close());
+
+  OM_TEST_CHECK(Om_itemSize(out_path) == ZIP64_ENTRY_SIZE);
+
+  uint32_t out_crc = 0;
+  OM_TEST_CHECK(Om_getCRC32digest(&out_crc, out_path));
+  OM_TEST_CHECK(out_crc == big_crc);
+
+  // data beyond 4 GiB boundary must be preserved
+  OM_TEST_CHECK(__test_read_byte(out_path, 0) == ZIP64_MARK_HEAD);
+  OM_TEST_CHECK(__test_read_byte(out_path, ZIP64_ENTRY_SIZE - 1) == ZIP64_MARK_TAIL);
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmTest_archiveCopyRawZip64()
+{
+  OmWString dir = Om_testDir(L"archive");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __test_copy_raw_zip64(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmTest_archiveCopyTranscode()
+{
+  OmWString dir = Om_testDir(L"archive");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __test_copy_transcode(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmTest_archiveAdaptive()
+{
+  OmWString dir = Om_testDir(L"archive");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __test_adaptive(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmTest_archiveAddManyNone()
+{
+  OmWString dir = Om_testDir(L"archive");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __test_add_many_none(dir, OM_METHOD_DEFLATE) &&
+                __test_add_many_none(dir, OM_METHOD_ZSTD);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}
@@ -0,0 +1,395 @@
+/*
+  This file is part of Open Mod Manager.
+
+  Open Mod Manager is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Open Mod Manager is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Open Mod Manager. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <unordered_map>
+#include <unordered_set>
+
+#include "OmBaseApp.h"
+
+#include "OmUtilFs.h"
+#include "OmUtilStr.h"
+
+#include "OmArchive.h"
+#include "OmXmlConf.h"
+
+#include "OmModMan.h"
+#include "OmModHub.h"
+#include "OmModChan.h"
+#include "OmModPack.h"
+
+#include "OmTest.h"
+
+#define DEPGRAPH_CHAIN_LENGTH   1000
+#define DEPGRAPH_FANOUT         500
+#define DEPGRAPH_INSTALLED      50
+
+#define DEPGRAPH_PACK_COUNT     (DEPGRAPH_CHAIN_LENGTH + 2 * DEPGRAPH_FANOUT + 12)
+
+/// \brief Create Mod Pack
+///
+/// Creates a minimal Mod Pack file in the given library directory, with
+/// a single data file and the specified dependencies.
+///
+/// \param[in]  library : Library directory path.
+/// \param[in]  iden    : Mod Pack identity, used as file name.
+/// \param[in]  depends : Identities of Mod Pack dependencies.
+///
+/// \return True if operation succeed, false otherwise.
+///
+static bool __test_make_pack(const OmWString& library, const OmWString& iden, const OmWStringArray& depends)
+{
+  OmXmlConf pack_cfg(OM_XMAGIC_PKG);
+
+  pack_cfg.addChild(L"install").setContent(iden);
+
+  if(!depends.empty()) {
+
+    OmXmlNode dependencies_node = pack_cfg.addChild(L"dependencies");
+
+    for(size_t i = 0; i < depends.size(); ++i)
+      dependencies_node.addChild(L"ident").setContent(depends[i]);
+  }
+
+  OmCString cfg_data = pack_cfg.data();
+  OmCString txt_data = Om_toUTF8(iden);
+
+  OmWString path = Om_concatPaths(library, iden);
+  path.append(L"." OM_PKG_FILE_EXT);
+
+  OmArchive pack_zip;
+
+  if(!pack_zip.write(path, OM_METHOD_STORE, OM_LEVEL_NONE))
+    return false;
+
+  bool result = pack_zip.entryAdd(txt_data.c_str(), txt_data.size(), Om_concatPaths(iden, iden + L".txt")) &&
+                pack_zip.entryAdd(cfg_data.c_str(), cfg_data.size(), L"modpack.xml");
+
+  return pack_zip.close() && result;
+}
+
+/// \brief Check install order
+///
+/// Checks that the given install list contains each Mod Pack only once
+/// and that every Mod Pack comes after all its dependencies, which must be
+/// listed as well. This does not apply to Mod Packs of a dependency cycle.
+///
+/// \param[in]  ModChan   : Mod Channel of Mod Packs.
+/// \param[in]  installs  : Install list to check.
+///
+/// \return True if install list is consistent, false otherwise.
+///
+static bool __test_check_order(const OmModChan* ModChan, const OmPModPackArray& installs)
+{
+  std::unordered_map<const OmModPack*, size_t> position;
+
+  for(size_t i = 0; i < installs.size(); ++i)
+    OM_TEST_CHECK(position.insert(std::make_pair(installs[i], i)).second);
+
+  for(size_t i = 0; i < installs.size(); ++i) {
+
+    for(size_t d = 0; d < installs[i]->dependCount(); ++d) {
+
+      const OmModPack* Depend = ModChan->findModpack(installs[i]->getDependIden(d), true);
+      if(!Depend || Depend == installs[i])
+        continue;
+
+      std::unordered_map<const OmModPack*, size_t>::const_iterator it = position.find(Depend);
+
+      OM_TEST_CHECK(it != position.end() && it->second < i);
+    }
+  }
+
+  return true;
+}
+
+/// \brief Make Mod Pack identity
+///
+/// Composes Mod Pack identity from prefix and index.
+///
+/// \param[in]  prefix  : Identity prefix.
+/// \param[in]  index   : Index to append.
+///
+/// \return Mod Pack identity.
+///
+static OmWString __test_iden(const wchar_t* prefix, size_t index)
+{
+  wchar_t num_buf[16];
+  swprintf(num_buf, 16, L"%04u", static_cast<unsigned>(index));
+
+  OmWString iden(prefix);
+  iden.append(num_buf);
+
+  return iden;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_depgraph_packs(const OmWString& library)
+{
+  OmWStringArray depends;
+
+  // deep chain, each Mod depends on the next one
+  for(size_t i = 0; i < DEPGRAPH_CHAIN_LENGTH; ++i) {
+    depends.clear();
+    if(i + 1 < DEPGRAPH_CHAIN_LENGTH)
+      depends.push_back(__test_iden(L"Chain_", i + 1));
+    OM_TEST_CHECK(__test_make_pack(library, __test_iden(L"Chain_", i), depends));
+  }
+
+  // cycle, A depends on B, B on C and C on A
+  OM_TEST_CHECK(__test_make_pack(library, L"Cycle_A", OmWStringArray(1, L"Cycle_B")));
+  OM_TEST_CHECK(__test_make_pack(library, L"Cycle_B", OmWStringArray(1, L"Cycle_C")));
+  OM_TEST_CHECK(__test_make_pack(library, L"Cycle_C", OmWStringArray(1, L"Cycle_A")));
+
+  // self dependency
+  OM_TEST_CHECK(__test_make_pack(library, L"Self_A", OmWStringArray(1, L"Self_A")));
+
+  // transitive missing dependency
+  OM_TEST_CHECK(__test_make_pack(library, L"Miss_A", OmWStringArray(1, L"Miss_B")));
+  OM_TEST_CHECK(__test_make_pack(library, L"Miss_B", OmWStringArray(1, L"Miss_X")));
+
+  // diamond, A depends on B and C which both depend on D
+  depends.clear();
+  depends.push_back(L"Dia_B"); depends.push_back(L"Dia_C");
+  OM_TEST_CHECK(__test_make_pack(library, L"Dia_A", depends));
+  OM_TEST_CHECK(__test_make_pack(library, L"Dia_B", OmWStringArray(1, L"Dia_D")));
+  OM_TEST_CHECK(__test_make_pack(library, L"Dia_C", OmWStringArray(1, L"Dia_D")));
+  OM_TEST_CHECK(__test_make_pack(library, L"Dia_D", OmWStringArray()));
+
+  // wide fan-out, one Mod depends on many Mods
+  depends.clear();
+  for(size_t i = 0; i < DEPGRAPH_FANOUT; ++i) {
+    depends.push_back(__test_iden(L"Fan_Leaf_", i));
+    OM_TEST_CHECK(__test_make_pack(library, depends.back(), OmWStringArray()));
+  }
+
+  OM_TEST_CHECK(__test_make_pack(library, L"Fan_Root", depends));
+
+  // wide fan-in, many Mods share one dependency
+  for(size_t i = 0; i < DEPGRAPH_FANOUT; ++i)
+    OM_TEST_CHECK(__test_make_pack(library, __test_iden(L"Share_", i), OmWStringArray(1, L"Share_Base")));
+
+  OM_TEST_CHECK(__test_make_pack(library, L"Share_Base", OmWStringArray()));
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+static bool __test_depgraph(const OmWString& dir)
+{
+  OmWString target = Om_concatPaths(dir, L"Target");
+  OmWString library = Om_concatPaths(dir, L"Library");
+
+  OM_TEST_CHECK(Om_dirCreate(target) == 0);
+  OM_TEST_CHECK(Om_dirCreate(library) == 0);
+
+  // Mod Packs are created before Channel so library is parsed once
+  OM_TEST_CHECK(__test_depgraph_packs(library));
+
+  OmModMan ModMan;
+
+  OM_TEST_CHECK(ModMan.createHub(dir, L"Hub") == OM_RESULT_OK);
+  OM_TEST_CHECK(ModMan.activeHub() != nullptr);
+  OM_TEST_CHECK(ModMan.activeHub()->createChannel(L"Chan", target, library, L""));
+
+  OmModChan* ModChan = ModMan.activeHub()->activeChannel();
+  OM_TEST_CHECK(ModChan != nullptr);
+  OM_TEST_CHECK(ModChan->modpackCount() == DEPGRAPH_PACK_COUNT);
+
+  OmPModPackArray selection, installs;
+  OmWStringArray overlaps, depends, missings;
+
+  // deep chain, whole chain is installed, last Mod first
+  OmModPack* Chain_Head = ModChan->findModpack(__test_iden(L"Chain_", 0), true);
+  OmModPack* Chain_Tail = ModChan->findModpack(__test_iden(L"Chain_", DEPGRAPH_CHAIN_LENGTH - 1), true);
+  OM_TEST_CHECK(Chain_Head && Chain_Tail);
+
+  OM_TEST_CHECK(!ModChan->hasMissingDepend(Chain_Head));
+  OM_TEST_CHECK(ModChan->isDependency(Chain_Tail));
+  OM_TEST_CHECK(!ModChan->isDependency(Chain_Head));
+
+  selection.assign(1, Chain_Head);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == DEPGRAPH_CHAIN_LENGTH);
+  OM_TEST_CHECK(installs.front() == Chain_Tail);
+  OM_TEST_CHECK(installs.back() == Chain_Head);
+  OM_TEST_CHECK(depends.size() == DEPGRAPH_CHAIN_LENGTH - 1);
+  OM_TEST_CHECK(missings.empty());
+  OM_TEST_CHECK(__test_check_order(ModChan, installs));
+
+  // cycle, each Mod is listed once whatever the selected one
+  const wchar_t* cycle[] = {L"Cycle_A", L"Cycle_B", L"Cycle_C"};
+
+  for(size_t c = 0; c < 3; ++c) {
+
+    OmModPack* Cycle = ModChan->findModpack(cycle[c], true);
+    OM_TEST_CHECK(Cycle != nullptr);
+    OM_TEST_CHECK(ModChan->isDependency(Cycle));
+    OM_TEST_CHECK(!ModChan->hasMissingDepend(Cycle));
+
+    installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+    selection.assign(1, Cycle);
+    ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+    OM_TEST_CHECK(installs.size() == 3);
+    OM_TEST_CHECK(installs.back() == Cycle);
+    OM_TEST_CHECK(missings.empty());
+
+    std::unordered_set<const OmModPack*> listed(installs.begin(), installs.end());
+    OM_TEST_CHECK(listed.size() == 3);
+  }
+
+  // self dependency is neither a dependency nor listed twice
+  OmModPack* Self_A = ModChan->findModpack(L"Self_A", true);
+  OM_TEST_CHECK(Self_A != nullptr);
+  OM_TEST_CHECK(!ModChan->isDependency(Self_A));
+
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.assign(1, Self_A);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == 1);
+
+  // transitive missing dependency
+  OmModPack* Miss_A = ModChan->findModpack(L"Miss_A", true);
+  OM_TEST_CHECK(Miss_A != nullptr);
+  OM_TEST_CHECK(ModChan->hasMissingDepend(Miss_A));
+
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.assign(1, Miss_A);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == 2);
+  OM_TEST_CHECK(missings.size() == 1 && missings[0] == L"Miss_X");
+
+  // diamond, shared dependency is listed once, before both dependents
+  OmModPack* Dia_A = ModChan->findModpack(L"Dia_A", true);
+  OmModPack* Dia_D = ModChan->findModpack(L"Dia_D", true);
+  OM_TEST_CHECK(Dia_A && Dia_D);
+
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.assign(1, Dia_A);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == 4);
+  OM_TEST_CHECK(installs.front() == Dia_D);
+  OM_TEST_CHECK(installs.back() == Dia_A);
+  OM_TEST_CHECK(depends.size() == 3);
+  OM_TEST_CHECK(__test_check_order(ModChan, installs));
+
+  // selecting several Mods sharing dependencies does not duplicate them
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.clear();
+  selection.push_back(Chain_Head); selection.push_back(Dia_A); selection.push_back(Chain_Tail);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == DEPGRAPH_CHAIN_LENGTH + 4);
+  OM_TEST_CHECK(__test_check_order(ModChan, installs));
+
+  // wide fan-out, all dependencies listed once before the dependent
+  OmModPack* Fan_Root = ModChan->findModpack(L"Fan_Root", true);
+  OM_TEST_CHECK(Fan_Root != nullptr);
+  OM_TEST_CHECK(!ModChan->isDependency(Fan_Root));
+  OM_TEST_CHECK(!ModChan->hasMissingDepend(Fan_Root));
+
+  for(size_t i = 0; i < DEPGRAPH_FANOUT; ++i)
+    OM_TEST_CHECK(ModChan->isDependency(ModChan->findModpack(__test_iden(L"Fan_Leaf_", i), true)));
+
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.assign(1, Fan_Root);
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == DEPGRAPH_FANOUT + 1);
+  OM_TEST_CHECK(installs.back() == Fan_Root);
+  OM_TEST_CHECK(depends.size() == DEPGRAPH_FANOUT);
+  OM_TEST_CHECK(overlaps.empty());
+  OM_TEST_CHECK(__test_check_order(ModChan, installs));
+
+  // wide fan-in, shared dependency listed once before all dependents
+  OmModPack* Share_Base = ModChan->findModpack(L"Share_Base", true);
+  OM_TEST_CHECK(Share_Base != nullptr);
+  OM_TEST_CHECK(ModChan->isDependency(Share_Base));
+
+  installs.clear(); overlaps.clear(); depends.clear(); missings.clear();
+  selection.clear();
+  for(size_t i = 0; i < DEPGRAPH_FANOUT; ++i) {
+    OmModPack* Share = ModChan->findModpack(__test_iden(L"Share_", i), true);
+    OM_TEST_CHECK(Share != nullptr);
+    OM_TEST_CHECK(!ModChan->isDependency(Share));
+    selection.push_back(Share);
+  }
+
+  ModChan->prepareInstalls(selection, &installs, &overlaps, &depends, &missings);
+
+  OM_TEST_CHECK(installs.size() == DEPGRAPH_FANOUT + 1);
+  OM_TEST_CHECK(installs.front() == Share_Base);
+  OM_TEST_CHECK(depends.size() == 1);
+  OM_TEST_CHECK(__test_check_order(ModChan, installs));
+
+  // restoring shared dependency first restores its installed dependents
+  OM_TEST_CHECK(Share_Base->makeBackup() == OM_RESULT_OK);
+  OM_TEST_CHECK(Share_Base->applySource() == OM_RESULT_OK);
+
+  for(size_t i = 0; i < DEPGRAPH_INSTALLED; ++i) {
+    OM_TEST_CHECK(selection[i]->makeBackup() == OM_RESULT_OK);
+    OM_TEST_CHECK(selection[i]->applySource() == OM_RESULT_OK);
+  }
+
+  OmPModPackArray restores;
+  OmWStringArray overlappers, dependents;
+
+  selection.assign(1, Share_Base);
+  ModChan->prepareRestores(selection, &restores, &overlappers, &dependents);
+
+  OM_TEST_CHECK(restores.size() == DEPGRAPH_INSTALLED + 1);
+  OM_TEST_CHECK(restores.back() == Share_Base);
+  OM_TEST_CHECK(dependents.size() == DEPGRAPH_INSTALLED);
+  OM_TEST_CHECK(overlappers.empty());
+
+  std::unordered_set<const OmModPack*> restored(restores.begin(), restores.end());
+  OM_TEST_CHECK(restored.size() == restores.size());
+
+  for(size_t i = 0; i < restores.size(); ++i)
+    OM_TEST_CHECK(restores[i]->hasBackup());
+
+  // graph is rebuilt along with library indices
+  ModChan->reloadModLibrary();
+
+  OM_TEST_CHECK(ModChan->modpackCount() == DEPGRAPH_PACK_COUNT);
+  OM_TEST_CHECK(ModChan->isDependency(ModChan->findModpack(L"Dia_D", true)));
+  OM_TEST_CHECK(ModChan->hasMissingDepend(ModChan->findModpack(L"Miss_A", true)));
+
+  return true;
+}
+
+///
+///  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -  -
+///
+bool OmTest_modchanDepGraph()
+{
+  OmWString dir = Om_testDir(L"modchan");
+  OM_TEST_CHECK(!dir.empty());
+
+  bool result = __test_depgraph(dir);
+
+  Om_dirDeleteRecursive(dir);
+
+  return result;
+}